@@ -0,0 +1,275 @@
+"""Generate the micro-ops of vector_simd.test from the RISC-V decoder.
+
+For every vector micro-op that the formats of formats/vector_arith.isa run
+on a host SIMD kernel, emit a class template with two member functions:
+scalar(), the element loop the format builds from the code of the decoder,
+and simd(), the kernel call the format emits in its place. Both come from
+the same calls to the formats that build the decoder, so that the test
+compares the kernels with the code they replace, not with a copy of it.
+
+The operands are given the names the ISA parser gives them, and are read
+from the state of the micro-op in the test, which also provides the
+declarations of the execute templates with VSIMD_REF_ENV(format).
+"""
+
+import argparse
+import ast
+import builtins
+import re
+import textwrap
+
+from code_formatter import code_formatter
+
+# The formats which call vsimdCode().
+formats = [
+    "VectorIntFormat",
+    "VectorIntWideningFormat",
+    "VectorIntMaskFormat",
+    "VectorFloatFormat",
+]
+
+# The macros of the execute templates the generated code uses.
+macros = ["ASSIGN_VD_BIT", "VSIMD_VD"]
+
+# The operands of the micro-ops and the members of the test state they are
+# read from.
+operand_members = {
+    "Vd": "vd",
+    "Vs1": "vs1",
+    "Vs2": "vs2",
+    "Rs1": "rs1",
+    "Fs1_bits": "fs1",
+}
+
+
+class Stub:
+    """Stands for the templates and InstObjParams the formats use."""
+
+    def __init__(self, *args, **kwargs):
+        pass
+
+    def __call__(self, *args, **kwargs):
+        return Stub()
+
+    def __getattr__(self, attr):
+        return Stub()
+
+    def __add__(self, other):
+        return ""
+
+    __radd__ = __add__
+
+    def subst(self, *args):
+        return ""
+
+
+class FormatLocals(dict):
+    """The locals of a format: its arguments, and a stub for whatever is
+    not defined by the let blocks."""
+
+    def __init__(self, context, **kwargs):
+        super().__init__(**kwargs)
+        self.context = context
+
+    def __missing__(self, key):
+        if key in self.context:
+            return self.context[key]
+        if hasattr(builtins, key):
+            return getattr(builtins, key)
+        return Stub()
+
+
+def error(msg):
+    raise Exception(msg)
+
+
+def isa_blocks(text, pattern):
+    """The Python blocks of an ISA file which start with pattern."""
+    return re.findall(pattern + r"\s*\{\{(.*?)\n\}\};", text, re.S)
+
+
+def decoder_insts(text):
+    """The instructions of a decoder description, with their format, in
+    the order of the description."""
+    token = re.compile(
+        r"(?P<inst>(?:(?P<fmt>\w+)::)?(?P<name>\w+)\s*\(\s*\{\{"
+        r"(?P<code>.*?)\}\}\s*(?:,\s*(?P<cat>\w+))?)"
+        r"|(?P<codelit>\{\{.*?\}\})"
+        r"|(?P<comment>//[^\n]*)"
+        r"|format\s+(?P<block>\w+)\s*\{"
+        r"|(?P<open>\{)|(?P<close>\})",
+        re.S,
+    )
+    stack = []
+    for m in token.finditer(text):
+        if m.group("inst"):
+            fmt = m.group("fmt")
+            if fmt is None:
+                fmt = next((f for f in reversed(stack) if f), None)
+            yield fmt, m.group("name"), m.group("code"), m.group("cat")
+        elif m.group("block"):
+            stack.append(m.group("block"))
+        elif m.group("open"):
+            stack.append(None)
+        elif m.group("close"):
+            stack.pop()
+
+
+def operands(code, operand_types):
+    """Replace the operands with extensions by the names the ISA parser
+    gives them, and return the code with their types."""
+    types = {}
+
+    def rename(m):
+        base, ext = m.group(1), m.group(2)
+        if base + "_" + ext in operand_members:
+            types[m.group(0)] = "uint64_t"
+            return m.group(0)
+        if ext not in operand_types:
+            return m.group(0)
+        types[base] = operand_types[ext]
+        return base
+
+    names = "|".join(n for n in operand_members if "_" not in n)
+    code = re.sub(r"\b(%s|Fs1)_(\w+)\b" % names, rename, code)
+    return code, types
+
+
+def declarations(types):
+    decls = []
+    for name, ctype in types.items():
+        member = "this->" + operand_members[name]
+        if name.startswith("V"):
+            decls.append(
+                "auto *%s = reinterpret_cast<%s *>(%s);"
+                % (name, ctype, member)
+            )
+        else:
+            decls.append("%s %s = %s;" % (ctype, name, member))
+    return decls
+
+
+def generate(decoder_isa, formats_isa, templates_isa, operands_isa, target):
+    with open(formats_isa) as f:
+        formats_text = f.read()
+    with open(decoder_isa) as f:
+        decoder_text = f.read()
+    with open(templates_isa) as f:
+        templates_text = f.read()
+    with open(operands_isa) as f:
+        operand_types = ast.literal_eval(
+            "{" + isa_blocks(f.read(), r"def operand_types")[0] + "}"
+        )
+
+    context = {"re": re, "error": error}
+    for block in isa_blocks(formats_text, r"(?m)^let"):
+        exec(textwrap.dedent(block), context)
+
+    kernels = []
+    vsimd_code = context["vsimdCode"]
+
+    def record(*args, **kwargs):
+        simd_code, scalar_code = vsimd_code(*args, **kwargs)
+        kernels.append((simd_code, scalar_code))
+        return simd_code, scalar_code
+
+    context["vsimdCode"] = record
+
+    bodies = {}
+    for fmt in formats:
+        (body,) = isa_blocks(
+            formats_text, r"def format %s\(code, category, \*flags\)" % fmt
+        )
+        bodies[fmt] = compile(textwrap.dedent(body), fmt, "exec")
+
+    code = code_formatter()
+    code(
+        "// Generated by build_tools/vector_simd_refs.py from the RISC-V "
+        "decoder."
+    )
+    code()
+    for macro in macros:
+        m = re.search(
+            r"^#define %s\b.*?[^\\]\n" % macro, templates_text, re.M | re.S
+        )
+        code(m.group(0))
+
+    insts = []
+    for fmt, name, snippet, category in decoder_insts(decoder_text):
+        if fmt not in bodies:
+            continue
+        kernels.clear()
+        exec(
+            bodies[fmt],
+            context,
+            FormatLocals(
+                context,
+                name=name,
+                Name=name.capitalize(),
+                code=snippet,
+                category=category,
+                flags=(),
+            ),
+        )
+        ((simd_code, scalar_code),) = kernels
+        if not scalar_code:
+            continue
+
+        insts.append((fmt, name))
+        scalar_code, types = operands(scalar_code, operand_types)
+        simd_code, simd_types = operands(simd_code, operand_types)
+        for op in simd_types:
+            assert types[op] == simd_types[op], (name, op)
+        decls = declarations(types)
+        code()
+        code(
+            """\
+template <typename ElemType>
+struct ${name} : public MicroOp<ElemType>
+{
+    static constexpr const char *name = "${name}";
+
+    using MicroOp<ElemType>::MicroOp;
+"""
+        )
+        code.indent()
+        for func, body in (("scalar", scalar_code), ("simd", simd_code)):
+            code()
+            code(
+                """\
+void
+${func}()
+{
+    VSIMD_REF_ENV(${fmt});"""
+            )
+            code.indent()
+            for decl in decls:
+                code(decl)
+            code(textwrap.dedent(body).strip())
+            code.dedent()
+            code("}")
+        code.dedent()
+        code("};")
+
+    code()
+    code("#define VSIMD_REF_INSTS(X) \\")
+    code.indent()
+    for fmt, name in insts[:-1]:
+        code("X(${fmt}, ${name}) \\")
+    fmt, name = insts[-1]
+    code("X(${fmt}, ${name})")
+    code.dedent()
+    code.write(target)
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("decoder", help="the decoder description")
+    parser.add_argument("formats", help="formats/vector_arith.isa")
+    parser.add_argument("templates", help="templates/vector_arith.isa")
+    parser.add_argument("operands", help="operands.isa")
+    parser.add_argument("target", help="the file to generate")
+    args = parser.parse_args()
+    generate(
+        args.decoder, args.formats, args.templates, args.operands, args.target
+    )
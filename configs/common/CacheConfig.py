@@ -116,7 +116,17 @@ def config_cache(options, system):
         assert (not hasattr(options, 'elastic_trace_en') or
                 not options.elastic_trace_en)
 
-    if options.l2cache:
+    # With parallel event queues, every core gets a private L2 connected
+    # to the shared L3 (or the memory bus) through a ParallelLink, so that
+    # the core and its caches can be simulated on an event queue of their
+    # own. The private L2s are created in the per-core loop below.
+    parallel = getattr(options, 'parallel_eventq', False)
+
+    if options.l2cache and parallel:
+        assert not options.ideal_cache, \
+            "Ideal caches and parallel event queues are exclusive options."
+
+    if options.l2cache and not parallel:
         # Provide a clock for the L2 and the L1-to-L2 bus here as they
         # are not connected using addTwoLevelCacheHierarchy. Use the
         # same clock as the CPUs.
@@ -158,6 +168,7 @@ def config_cache(options, system):
             system.l2.response_latency = 66
             system.l2.writeback_clean = False
 
+    if options.l2cache:
         if options.l3cache:
             system.l3 = L3Cache(clk_domain=system.cpu_clk_domain,
                                         **_get_cache_opts('l3', options))
@@ -165,19 +176,50 @@ def config_cache(options, system):
             # l2 -> tol3bus -> l3
             system.tol3bus = L2XBar(clk_domain=system.cpu_clk_domain, width=256)
             system.l3.cpu_side = system.tol3bus.mem_side_ports
-            system.l2.mem_side = system.tol3bus.cpu_side_ports
+            if not parallel:
+                system.l2.mem_side = system.tol3bus.cpu_side_ports
+                system.l2.max_cache_level = 3
             # l3 -> membus
             system.l3.mem_side = system.membus.cpu_side_ports
-            system.l2.max_cache_level = 3
             system.l3.max_cache_level = 3
-        else:
+        elif not parallel:
             system.l2.mem_side = system.membus.cpu_side_ports
             system.l2.max_cache_level = 2
 
+        if parallel and options.l3cache and options.l2_to_l3_pf_hint:
+            print("L2 to L3 prefetch hints cross event queues, "
+                  "disabled with parallel event queues")
+
     if options.memchecker:
         system.memchecker = MemChecker()
 
     for i in range(options.num_cpus):
+        if options.l2cache and parallel:
+            cpu = system.cpu[i]
+            cpu.l2cache = l2_cache_class(clk_domain=system.cpu_clk_domain,
+                                         **_get_cache_opts('l2', options))
+            cpu.toL2Bus = L2XBar(clk_domain=system.cpu_clk_domain, width=256)
+            cpu.l2cache.cpu_side = cpu.toL2Bus.mem_side_ports
+            if options.xiangshan_ecore:
+                cpu.l2cache.response_latency = 66
+                cpu.l2cache.writeback_clean = False
+
+            # The link inherits the event queue of the core on its cpu
+            # side, the shared part of the hierarchy stays on queue 0.
+            cpu.l2link = ParallelLink(
+                latency=options.parallel_link_latency,
+                mem_side_eventq_index=0)
+            cpu.l2cache.mem_side = cpu.l2link.cpu_side_port
+            if options.l3cache:
+                cpu.l2link.mem_side_port = system.tol3bus.cpu_side_ports
+                cpu.l2cache.max_cache_level = 3
+            else:
+                cpu.l2link.mem_side_port = system.membus.cpu_side_ports
+                cpu.l2cache.max_cache_level = 2
+            l2, tol2bus = cpu.l2cache, cpu.toL2Bus
+        elif options.l2cache:
+            l2, tol2bus = system.l2, system.tol2bus
+
         if options.caches:
             icache = icache_class(**_get_cache_opts('l1i', options))
             dcache = dcache_class(**_get_cache_opts('l1d', options))
@@ -221,16 +263,17 @@ def config_cache(options, system):
 
             if options.l1_to_l2_pf_hint:
                 assert dcache.prefetcher != NULL and \
-                    system.l2.prefetcher != NULL
-                dcache.prefetcher.add_pf_downstream(system.l2.prefetcher)
-                system.l2.prefetcher.queue_size = 64
-                system.l2.prefetcher.max_prefetch_requests_with_pending_translation = 128
+                    l2.prefetcher != NULL
+                dcache.prefetcher.add_pf_downstream(l2.prefetcher)
+                l2.prefetcher.queue_size = 64
+                l2.prefetcher.max_prefetch_requests_with_pending_translation = 128
                 print("Add L2 prefetcher as downstream of L1D prefetcher")
 
-            if options.l3cache and options.l2_to_l3_pf_hint:
-                assert system.l2.prefetcher != NULL and \
+            if options.l3cache and options.l2_to_l3_pf_hint and \
+                    not parallel:
+                assert l2.prefetcher != NULL and \
                     system.l3.prefetcher != NULL
-                system.l2.prefetcher.add_pf_downstream(system.l3.prefetcher)
+                l2.prefetcher.add_pf_downstream(system.l3.prefetcher)
                 system.l3.prefetcher.queue_size = 64
                 system.l3.prefetcher.max_prefetch_requests_with_pending_translation = 128
                 print("Add L3 prefetcher as downstream of L2 prefetcher")
@@ -290,11 +333,11 @@ def config_cache(options, system):
         system.cpu[i].createInterruptController()
         if options.l2cache:
             system.cpu[i].connectAllPorts(
-                system.tol2bus.cpu_side_ports,
+                tol2bus.cpu_side_ports,
                 system.membus.cpu_side_ports, system.membus.mem_side_ports)
-            if system.l2.prefetcher != NULL:
+            if l2.prefetcher != NULL:
                 print("Add dtb for L2 prefetcher")
-                system.l2.prefetcher.registerTLB(system.cpu[i].mmu.dtb)
+                l2.prefetcher.registerTLB(system.cpu[i].mmu.dtb)
         elif options.external_memory_system:
             system.cpu[i].connectUncachedPorts(
                 system.membus.cpu_side_ports, system.membus.mem_side_ports)
@@ -750,3 +750,64 @@ def addXiangshanFSOptions(parser):
                         action="store",
                         default=None,
                         help="The shared lib file used to do difftest")
+
+    # Parallel simulation options
+    parser.add_argument("--parallel-eventq", action="store_true",
+                        help="Simulate each core with its private caches on "
+                        "an event queue and host thread of its own")
+    parser.add_argument("--parallel-link-latency", action="store",
+                        type=str, default="3ns",
+                        help="Latency between the private L2s and the "
+                        "shared L3, also the lookahead between the queues")
+    parser.add_argument("--sim-quantum", action="store", type=str,
+                        default=None,
+                        help="Synchronization quantum of the event queues "
+                        "(default: --parallel-link-latency)")
+    parser.add_argument("--deterministic-eventq", action="store_true",
+                        help="Run the event queues one after the other in "
+                        "each quantum, reproducible but not faster")
+    parser.add_argument("--eventq-backend", action="store",
+                        choices=["bin_list", "timing_wheel"],
+                        default="bin_list",
+                        help="Data structure of the main event queues, "
+                        "both give the same results")
+
+    # Sampled simulation options
+    parser.add_argument("--sampling-period", action="store", type=int,
+                        default=None,
+                        help="Sample the run in one process: every this "
+                        "many instructions, warm up and measure a window "
+                        "in detail, fast-forward the rest on atomic cpus")
+    parser.add_argument("--sampling-warmup", action="store", type=int,
+                        default=50000,
+                        help="Detailed warmup instructions before each "
+                        "sampling window")
+    parser.add_argument("--sampling-detail", action="store", type=int,
+                        default=10000,
+                        help="Instructions measured in each sampling window")
+    parser.add_argument("--sampling-windows", action="store", type=int,
+                        default=0,
+                        help="Stop after this many sampling windows "
+                        "(default: run to the end)")
+
+    # Pipeline trace options
+    parser.add_argument("--pipe-trace", action="store", type=str,
+                        default=None,
+                        help="Write a binary O3 pipeline trace of each cpu "
+                        "to <outdir>/cpu<N>.<PIPE_TRACE>, gzipped if it ends "
+                        "in .gz (see util/o3-pipetrace.py)")
+    parser.add_argument("--pipe-trace-start", action="store", type=int,
+                        default=0, help="Tick to start the pipeline trace at")
+    parser.add_argument("--pipe-trace-stop", action="store", type=int,
+                        default=None, help="Tick to stop the pipeline trace at")
+    parser.add_argument("--pipe-trace-start-inst", action="store", type=int,
+                        default=0,
+                        help="Committed instructions before the pipeline "
+                        "trace starts")
+    parser.add_argument("--pipe-trace-insts", action="store", type=int,
+                        default=0,
+                        help="Instructions to trace (default: no limit)")
+    parser.add_argument("--pipe-trace-ring", action="store", type=int,
+                        default=0,
+                        help="Only keep the last this many instructions and "
+                        "write them at exit")
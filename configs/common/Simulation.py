@@ -37,6 +37,7 @@
 # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+import math
 import sys
 from os import getcwd
 from os.path import join as joinpath
@@ -854,3 +855,129 @@ def run_vanilla(options, root, testsys, cpu_class):
 
     if exit_event.getCode() != 0:
         print("Simulated exit code not 0! Exit code is", exit_event.getCode())
+
+def samplingConfidence(samples, z=1.96):
+    """Mean of the samples and the half width of its confidence interval,
+    95% by default, using the normal approximation of SMARTS."""
+    n = len(samples)
+    mean = sum(samples) / n
+    if n < 2:
+        return mean, float('inf')
+    variance = sum((s - mean) ** 2 for s in samples) / (n - 1)
+    return mean, z * math.sqrt(variance / n)
+
+def run_sampled(options, root, testsys):
+    """Systematic sampling (SMARTS) of a whole run in a single process.
+
+    Every sampling period starts with sampling_warmup instructions on the
+    detailed cpus to warm the pipeline and the predictors, followed by a
+    measured window of sampling_detail instructions. The stats are reset
+    before and dumped after each window. The rest of the period is
+    fast-forwarded on atomic cpus, which keep the caches warm. Instruction
+    counts are those of cpu 0. The IPC of every window and the confidence
+    interval of the mean are written to sampling.txt in the output dir.
+    """
+    period = options.sampling_period
+    warmup = options.sampling_warmup
+    detail = options.sampling_detail
+    if detail <= 0 or warmup + detail >= period:
+        fatal("The sampling period (%d) must be longer than the warmup (%d) "
+              "plus the detailed window (%d)" % (period, warmup, detail))
+    if options.enable_difftest:
+        fatal("Difftest can't follow the atomic cpus, it can't be used "
+              "with sampling")
+    if getattr(options, "parallel_eventq", False):
+        fatal("Sampling switches cpus, it can't be used with "
+              "--parallel-eventq")
+
+    stat_root_simobjs = []
+    for stat_root_str in options.stats_root:
+        stat_root_simobjs.extend(root.get_simobj(stat_root_str))
+    m5.stats.global_dump_roots = stat_root_simobjs
+
+    np = options.num_cpus
+    atomic_cpus = [AtomicSimpleCPU(switched_out=True, cpu_id=(i))
+                   for i in range(np)]
+    for i in range(np):
+        atomic_cpus[i].system = testsys
+        atomic_cpus[i].workload = testsys.cpu[i].workload
+        atomic_cpus[i].clk_domain = testsys.cpu[i].clk_domain
+        atomic_cpus[i].isa = testsys.cpu[i].isa
+        atomic_cpus[i].mmu.pma_checker = testsys.cpu[i].mmu.pma_checker
+        if options.maxinsts:
+            testsys.cpu[i].max_insts_any_thread = options.maxinsts
+            atomic_cpus[i].max_insts_any_thread = options.maxinsts
+        atomic_cpus[i].createThreads()
+    testsys.atomic_cpus = atomic_cpus
+    to_atomic = [(testsys.cpu[i], atomic_cpus[i]) for i in range(np)]
+    to_detailed = [(atomic_cpus[i], testsys.cpu[i]) for i in range(np)]
+
+    root.apply_config(options.param)
+    m5.instantiate(None)
+
+    maxtick = m5.MaxTick
+    if options.abs_max_tick:
+        maxtick = min(maxtick, options.abs_max_tick)
+    if options.maxtime:
+        maxtick = min(maxtick, m5.ticks.fromSeconds(options.maxtime))
+    clock = testsys.cpu[0].clk_domain.clock[0].getValue()
+
+    def simulatePhase(cpu, insts, cause):
+        cpu.scheduleInstStop(0, insts, cause)
+        exit_event = m5.simulate(maxtick - m5.curTick())
+        return exit_event, exit_event.getCause() == cause
+
+    print("**** SAMPLED SIMULATION: period %d, warmup %d, window %d ****" %
+          (period, warmup, detail))
+
+    windows = []
+    while not options.sampling_windows or \
+            len(windows) < options.sampling_windows:
+        if warmup:
+            exit_event, done = simulatePhase(testsys.cpu[0], warmup,
+                                             "sampling warmup done")
+            if not done:
+                break
+        m5.stats.reset()
+
+        start_tick = m5.curTick()
+        start_insts = sum(cpu.totalInsts() for cpu in testsys.cpu)
+        exit_event, done = simulatePhase(testsys.cpu[0], detail,
+                                         "sampling window done")
+        if not done:
+            break
+        m5.stats.dump()
+        insts = sum(cpu.totalInsts() for cpu in testsys.cpu) - start_insts
+        cycles = (m5.curTick() - start_tick) / clock
+        windows.append((start_tick, insts, cycles, insts / cycles))
+        print("Sampling window %d @ tick %d: IPC %.4f" %
+              (len(windows) - 1, start_tick, insts / cycles))
+
+        m5.switchCpus(testsys, to_atomic, verbose=False)
+        exit_event, done = simulatePhase(atomic_cpus[0],
+                                         period - warmup - detail,
+                                         "sampling fast-forward done")
+        if not done:
+            break
+        m5.switchCpus(testsys, to_detailed, verbose=False)
+
+    with open(joinpath(m5.options.outdir, "sampling.txt"), "w") as f:
+        f.write("# period %d warmup %d window %d\n" %
+                (period, warmup, detail))
+        f.write("# window start_tick insts cycles ipc\n")
+        for (i, (tick, insts, cycles, ipc)) in enumerate(windows):
+            f.write("%d %d %d %.0f %.6f\n" % (i, tick, insts, cycles, ipc))
+        if windows:
+            mean, error = samplingConfidence([w[3] for w in windows])
+            summary = "IPC %.4f +- %.4f (95%% confidence, %d windows)" % \
+                (mean, error, len(windows))
+            f.write("# %s\n" % summary)
+            print("Sampled " + summary)
+        else:
+            warn("The run ended before the first sampling window")
+
+    print('Exiting @ tick %i because %s' %
+          (m5.curTick(), exit_event.getCause()))
+
+    if exit_event.getCode() != 0:
+        print("Simulated exit code not 0! Exit code is", exit_event.getCode())
@@ -78,4 +78,31 @@ def config_difftest(cpu_list, args):
     else:
         assert len(cpu_list) == 1
         cpu_list[0].enable_difftest = True
-        cpu_list[0].difftest_ref_so = args.difftest_ref_so
\ No newline at end of file
+        cpu_list[0].difftest_ref_so = args.difftest_ref_so
+
+
+def config_parallel_eventq(args, sys, root):
+    if not args.parallel_eventq:
+        return
+    if args.enable_difftest:
+        fatal("Difftest steps a single reference model, "
+              "it can't be used with --parallel-eventq")
+    if not args.l2cache:
+        fatal("--parallel-eventq splits the hierarchy at the private L2s")
+
+    # Core i and its private caches (children of the core, see
+    # CacheConfig.config_cache) run on event queue i + 1. The shared L3,
+    # memory and devices stay on queue 0.
+    for (i, cpu) in enumerate(sys.cpu):
+        cpu.eventq_index = i + 1
+
+    # Packets crossing the L2 links are the only timed traffic between
+    # the queues, so their latency bounds the quantum.
+    m5.ticks.fixGlobalFrequency()
+    quantum = args.sim_quantum or args.parallel_link_latency
+    root.sim_quantum = m5.ticks.fromSeconds(
+        m5.util.convert.anyToLatency(quantum))
+    root.deterministic_eventq = args.deterministic_eventq
+    print("Running %d cores on parallel event queues, quantum %s%s" %
+          (len(sys.cpu), quantum,
+           " (deterministic)" if args.deterministic_eventq else ""))
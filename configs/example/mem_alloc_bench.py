@@ -0,0 +1,125 @@
+# Host cost of the memory path, and of its allocations, for a traffic
+# generator behind a three level cache hierarchy in timing mode:
+#
+#   tgen -> L1 -> L2XBar -> L2 -> L2XBar -> L3 -> SystemXBar -> memory
+#
+# Every request that misses goes through the three caches and crossbars,
+# which create and drop packets, requests, MSHR targets and writebacks.
+# The script reports the host time per request, and with a build that has
+# USE_HOST_PROFILING=1 and --host-profile also the host allocations per
+# request, in total and for each object, from the hostProfile stats:
+#
+#   build/RISCV/gem5.opt --host-profile=alloc.folded \
+#       configs/example/mem_alloc_bench.py --requests 1000000
+
+import argparse
+import time
+
+import m5
+from m5.objects import *
+from m5.util import fatal
+
+import _m5.core
+
+parser = argparse.ArgumentParser(
+    formatter_class=argparse.ArgumentDefaultsHelpFormatter)
+
+parser.add_argument("--requests", type=int, default=1000000,
+                    help="Number of request periods of the generator")
+parser.add_argument("--footprint", type=str, default="32MB",
+                    help="Size of the memory the requests go to, "
+                    "larger than the L3 so that requests miss everywhere")
+parser.add_argument("--pattern", choices=["random", "linear"],
+                    default="random", help="Address pattern")
+parser.add_argument("--read-percent", type=int, default=70,
+                    help="Percentage of reads")
+parser.add_argument("--period", type=int, default=1000,
+                    help="Ticks between requests")
+parser.add_argument("--top", type=int, default=8,
+                    help="Objects listed by allocations per request")
+
+args = parser.parse_args()
+
+block_size = 64
+
+system = System(cache_line_size = block_size,
+                mem_mode = 'timing',
+                mem_ranges = [AddrRange(args.footprint)])
+system.voltage_domain = VoltageDomain(voltage = '1V')
+system.clk_domain = SrcClockDomain(clock = '1GHz',
+                                   voltage_domain = system.voltage_domain)
+
+system.tgen = PyTrafficGen()
+
+system.l1 = Cache(size = '32kB', assoc = 8, tag_latency = 1,
+                  data_latency = 1, response_latency = 1,
+                  mshrs = 16, tgts_per_mshr = 8)
+system.l2 = Cache(size = '1MB', assoc = 8, tag_latency = 10,
+                  data_latency = 10, response_latency = 10,
+                  mshrs = 32, tgts_per_mshr = 8)
+system.l3 = Cache(size = '8MB', assoc = 16, tag_latency = 20,
+                  data_latency = 20, response_latency = 20,
+                  mshrs = 64, tgts_per_mshr = 8)
+
+system.l2bus = L2XBar()
+system.l3bus = L2XBar()
+system.membus = SystemXBar()
+
+# There is no point spending host time on the data
+system.physmem = SimpleMemory(range = system.mem_ranges[0],
+                              latency = '50ns', null = True)
+
+system.tgen.port = system.l1.cpu_side
+system.l1.mem_side = system.l2bus.cpu_side_ports
+system.l2bus.mem_side_ports = system.l2.cpu_side
+system.l2.mem_side = system.l3bus.cpu_side_ports
+system.l3bus.mem_side_ports = system.l3.cpu_side
+system.l3.mem_side = system.membus.cpu_side_ports
+system.membus.mem_side_ports = system.physmem.port
+system.system_port = system.membus.cpu_side_ports
+
+root = Root(full_system = False, system = system)
+
+m5.instantiate()
+
+def traffic():
+    create = {"random": system.tgen.createRandom,
+              "linear": system.tgen.createLinear}[args.pattern]
+    yield create(args.requests * args.period,
+                 0, system.mem_ranges[0].size(), block_size,
+                 args.period, args.period, args.read_percent, 0)
+    yield system.tgen.createExit(0)
+
+system.tgen.start(traffic())
+
+wall_start = time.perf_counter()
+cpu_start = time.process_time()
+exit_event = m5.simulate()
+wall = time.perf_counter() - wall_start
+cpu = time.process_time() - cpu_start
+
+print('Exiting @ tick', m5.curTick(), 'because', exit_event.getCause())
+
+# The hostProfile stats are computed when the stats are dumped
+m5.stats.dump()
+
+packets = int(system.tgen.resolveStat("numPackets").value)
+if not packets:
+    fatal("The generator sent no requests")
+
+print("Requests: %d" % packets)
+print("Host time: %.3f s wall, %.3f s cpu, %.1f ns cpu per request" %
+      (wall, cpu, cpu * 1e9 / packets))
+
+if _m5.core.USE_HOST_PROFILING and m5.options.host_profile:
+    allocations = root.resolveStat("hostProfile.allocations")
+    counts = allocations.value
+    print("Host allocations: %d, %.2f per request" %
+          (sum(counts), sum(counts) / packets))
+    by_object = sorted(zip(counts, allocations.subnames), reverse=True)
+    for count, name in by_object[:args.top]:
+        if count:
+            print("  %-24s %.2f per request" % (name, count / packets))
+else:
+    print("Host allocations are counted by builds with "
+          "USE_HOST_PROFILING=1, run with --host-profile")
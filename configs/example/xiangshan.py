@@ -28,7 +28,10 @@ def build_test_system(np):
     test_sys = makeBareMetalXiangshanSystem(test_mem_mode, SysConfig(mem=args.mem_size), None)
 
     test_sys.xiangshan_system = True
-    args.enable_difftest = True
+    # The reference model of difftest is not thread safe, and it can't
+    # follow the atomic cpus that fast-forward sampled runs
+    args.enable_difftest = not args.parallel_eventq and \
+        not args.sampling_period
 
     XSConfig.config_xiangshan_inputs(args, test_sys)
 
@@ -244,6 +247,15 @@ def build_test_system(np):
         else:
             test_sys.cpu[i].dump_commit = False
             test_sys.cpu[i].dump_start = 0
+        if args.pipe_trace:
+            cpu = test_sys.cpu[i]
+            cpu.pipe_trace_file = "cpu%d.%s" % (i, args.pipe_trace)
+            cpu.pipe_trace_start = args.pipe_trace_start
+            if args.pipe_trace_stop is not None:
+                cpu.pipe_trace_stop = args.pipe_trace_stop
+            cpu.pipe_trace_start_inst = args.pipe_trace_start_inst
+            cpu.pipe_trace_insts = args.pipe_trace_insts
+            cpu.pipe_trace_ring = args.pipe_trace_ring
 
     return test_sys
 
@@ -282,5 +294,11 @@ np = args.num_cpus
 test_sys = build_test_system(np)
 
 root = Root(full_system=True, system=test_sys)
+root.eventq_backend = args.eventq_backend
 
-Simulation.run_vanilla(args, root, test_sys, FutureClass)
+XSConfig.config_parallel_eventq(args, test_sys, root)
+
+if args.sampling_period:
+    Simulation.run_sampled(args, root, test_sys)
+else:
+    Simulation.run_vanilla(args, root, test_sys, FutureClass)
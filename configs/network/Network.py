@@ -42,8 +42,10 @@ def define_options(parser):
         help="the number of rows in the mesh topology")
     parser.add_argument(
         "--network", default="simple",
-        choices=['simple', 'garnet'],
-        help="""'simple'|'garnet' (garnet2.0 will be deprecated.)""")
+        choices=['simple', 'garnet', 'analytical'],
+        help="""'simple'|'garnet'|'analytical' (garnet2.0 will be
+            deprecated.) 'analytical' computes the latency of garnet
+            from a model instead of simulating flits.""")
     parser.add_argument(
         "--router-latency", action="store", type=int,
         default=1,
@@ -59,7 +61,8 @@ def define_options(parser):
     parser.add_argument(
         "--link-width-bits", action="store", type=int,
         default=128,
-        help="width in bits for all links inside garnet.")
+        help="width in bits for all links inside garnet and the "
+        "analytical network.")
     parser.add_argument(
         "--vcs-per-vnet", action="store", type=int, default=4,
         help="""number of virtual channels per virtual network
@@ -103,6 +106,13 @@ def create_network(options, ruby):
         RouterClass = GarnetRouter
         InterfaceClass = GarnetNetworkInterface
 
+    elif options.network == "analytical":
+        NetworkClass = AnalyticalNetwork
+        IntLinkClass = BasicIntLink
+        ExtLinkClass = BasicExtLink
+        RouterClass = BasicRouter
+        InterfaceClass = None
+
     else:
         NetworkClass = SimpleNetwork
         IntLinkClass = SimpleIntLink
@@ -190,6 +200,9 @@ def init_network(options, network, InterfaceClass):
                                   width = extLink.int_node.width))
             extLink.int_cred_bridge = int_cred_bridges
 
+    if options.network == "analytical":
+        network.ni_flit_size = options.link_width_bits / 8
+
     if options.network == "simple":
         if options.simple_physical_channels:
             network.physical_vnets_channels = \
@@ -45,3 +45,5 @@ class PMAChecker(SimObject):
     cxx_class = 'gem5::PMAChecker'
 
     uncacheable = VectorParam.AddrRange([], "Uncacheable address ranges")
+    decision_cache_size = Param.Unsigned(64,
+        "Pages whose PMA decision is cached, 0 to always scan the ranges")
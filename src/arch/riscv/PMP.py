@@ -34,4 +34,6 @@ class PMP(SimObject):
     cxx_class = 'gem5::PMP'
 
     pmp_entries = Param.Int(16, "Maximum PMP Entries Supported")
+    decision_cache_size = Param.Unsigned(64,
+        "Pages whose PMP decision is cached, 0 to always scan the table")
 
@@ -51,6 +51,8 @@ class RiscvPagetableWalker(ClockedObject):
     pma_checker = Param.PMAChecker(Parent.any, "PMA Checker")
     pmp = Param.PMP(Parent.any, "PMP")
     open_nextline = Param.Bool(True, "open nextline pre")
+    share_pte_lines = Param.Bool(True,
+        "let a walk wait for a page table line another walk is reading")
 
 class RiscvTLB(BaseTLB):
     type = 'RiscvTLB'
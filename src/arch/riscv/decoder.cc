@@ -112,7 +112,7 @@ Decoder::decode(PCStateBase &_next_pc)
         next_pc.compressed(false);
     }
 
-    emi.vtype8 = this->machVtype & 0xff;
+    emi.vtype8 = vtypeDependent(emi) ? this->machVtype & 0xff : 0;
     StaticInstPtr inst = decode(emi, next_pc.instAddr());
     if (inst->isVectorConfig()) {
         auto vset = static_cast<VConfOp*>(inst.get());
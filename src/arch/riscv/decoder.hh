@@ -84,6 +84,29 @@ class Decoder : public InstDecoder
       return inst.opcode7 == 0b1010111u && inst.width == 0b111u;
     }
 
+    /**
+     * True if the decoding of the instruction depends on vtype, the
+     * vector instructions but vset*. Only those have vtype in their
+     * decode cache key, so that the other instructions keep one decoded
+     * instance whatever the vector configuration.
+     */
+    inline bool
+    vtypeDependent(ExtMachInst inst)
+    {
+        if (compressed(inst))
+            return false;
+        switch (inst.opcode) {
+          case 0x01: // LOAD-FP
+          case 0x09: // STORE-FP
+            // The widths of the vector loads and stores.
+            return inst.width == 0b000u || inst.width >= 0b101u;
+          case 0x15: // OP-V
+            return inst.width != 0b111u;
+          default:
+            return false;
+        }
+    }
+
     //Use this to give data to the decoder. This should be used
     //when there is control flow.
     void moreBytes(const PCStateBase &pc, Addr fetchPC) override;
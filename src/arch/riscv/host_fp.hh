@@ -0,0 +1,279 @@
+#ifndef __ARCH_RISCV_HOST_FP_HH__
+#define __ARCH_RISCV_HOST_FP_HH__
+
+#include <softfloat.h>
+#include <specialize.h>
+
+#include <cfenv>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "config/have_fenv.hh"
+
+namespace gem5
+{
+
+namespace RiscvISA
+{
+
+/**
+ * Do the floating point arithmetic on the host FPU when it gives the
+ * result and flags of softfloat. Set from the host_fp parameter of the
+ * ISA.
+ */
+inline bool hostFp = false;
+
+/**
+ * The host FPU path of the basic floating point operations.
+ *
+ * An operation runs on the host in round to nearest, its flags are read
+ * back with fetestexcept, and a NaN result is replaced with the canonical
+ * NaN. Softfloat is used instead when:
+ *
+ * - the rounding mode is not round to nearest, even
+ * - an operand is a NaN, whose payload and signaling bit only softfloat
+ *   handles like RISC-V
+ * - an operand or the result is subnormal, or the host raised underflow,
+ *   where the tininess detection of the host may differ
+ * - the host has no exact fused multiply-add
+ */
+namespace hostfp
+{
+
+// The host computes in the precision of the operands (SSE, not x87).
+constexpr bool Available = HAVE_FENV && FLT_EVAL_METHOD == 0;
+
+template <typename Soft>
+struct Format;
+
+template <>
+struct Format<float32_t>
+{
+    typedef float Host;
+    typedef uint32_t Bits;
+    static constexpr Bits ExpMask = 0x7f800000;
+    static constexpr Bits FracMask = 0x007fffff;
+    static constexpr Bits DefaultNaN = defaultNaNF32UI;
+#ifdef FP_FAST_FMAF
+    static constexpr bool FastFma = true;
+#else
+    static constexpr bool FastFma = false;
+#endif
+};
+
+template <>
+struct Format<float64_t>
+{
+    typedef double Host;
+    typedef uint64_t Bits;
+    static constexpr Bits ExpMask = 0x7ff0000000000000ULL;
+    static constexpr Bits FracMask = 0x000fffffffffffffULL;
+    static constexpr Bits DefaultNaN = defaultNaNF64UI;
+#ifdef FP_FAST_FMA
+    static constexpr bool FastFma = true;
+#else
+    static constexpr bool FastFma = false;
+#endif
+};
+
+/** Number of operations the calling thread did on the host FPU. */
+inline thread_local uint64_t hostOps = 0;
+
+/** True for zeros, normal numbers and infinities. */
+template <typename Soft>
+inline bool
+regular(typename Format<Soft>::Bits v)
+{
+    using F = Format<Soft>;
+    const auto exp = v & F::ExpMask;
+    if (exp == 0)
+        return (v & F::FracMask) == 0;
+    return exp != F::ExpMask || (v & F::FracMask) == 0;
+}
+
+/**
+ * Read an operand in a way that the compiler cannot move above the
+ * clearing of the host flags.
+ */
+template <typename Soft>
+inline typename Format<Soft>::Host
+load(Soft a)
+{
+    typename Format<Soft>::Host h;
+    std::memcpy(&h, &a.v, sizeof(h));
+    volatile typename Format<Soft>::Host v = h;
+    return v;
+}
+
+/**
+ * Compute fn(args...) on the host into res, with the softfloat flags.
+ * Return false, without touching the softfloat state, if softfloat has to
+ * do it.
+ */
+template <typename Soft, typename Fn, typename ...Args>
+inline bool
+run(Soft &res, Fn fn, Args ...args)
+{
+    using F = Format<Soft>;
+    if (!Available || !hostFp ||
+        softfloat_roundingMode != softfloat_round_near_even ||
+        !(regular<Soft>(args.v) && ...)) {
+        return false;
+    }
+
+    std::feclearexcept(FE_ALL_EXCEPT);
+    // Stored before the flags are tested.
+    volatile typename F::Host out = fn(load(args)...);
+    const int raised = std::fetestexcept(FE_ALL_EXCEPT);
+
+    const typename F::Host h = out;
+    typename F::Bits v;
+    std::memcpy(&v, &h, sizeof(v));
+    if ((raised & FE_UNDERFLOW) ||
+        ((v & F::ExpMask) == 0 && (v & F::FracMask) != 0)) {
+        return false;
+    }
+    if ((v & F::ExpMask) == F::ExpMask && (v & F::FracMask) != 0)
+        v = F::DefaultNaN;
+
+    uint_fast8_t flags = 0;
+    if (raised & FE_INEXACT)
+        flags |= softfloat_flag_inexact;
+    if (raised & FE_OVERFLOW)
+        flags |= softfloat_flag_overflow;
+    if (raised & FE_DIVBYZERO)
+        flags |= softfloat_flag_infinite;
+    if (raised & FE_INVALID)
+        flags |= softfloat_flag_invalid;
+    softfloat_exceptionFlags |= flags;
+    res.v = v;
+    hostOps++;
+    return true;
+}
+
+} // namespace hostfp
+
+// Drop-in replacements of the softfloat operations of the same names.
+
+inline float32_t
+host_f32_add(float32_t a, float32_t b)
+{
+    float32_t r;
+    if (hostfp::run(r, [](float x, float y) { return x + y; }, a, b))
+        return r;
+    return f32_add(a, b);
+}
+
+inline float32_t
+host_f32_sub(float32_t a, float32_t b)
+{
+    float32_t r;
+    if (hostfp::run(r, [](float x, float y) { return x - y; }, a, b))
+        return r;
+    return f32_sub(a, b);
+}
+
+inline float32_t
+host_f32_mul(float32_t a, float32_t b)
+{
+    float32_t r;
+    if (hostfp::run(r, [](float x, float y) { return x * y; }, a, b))
+        return r;
+    return f32_mul(a, b);
+}
+
+inline float32_t
+host_f32_div(float32_t a, float32_t b)
+{
+    float32_t r;
+    if (hostfp::run(r, [](float x, float y) { return x / y; }, a, b))
+        return r;
+    return f32_div(a, b);
+}
+
+inline float32_t
+host_f32_sqrt(float32_t a)
+{
+    float32_t r;
+    if (hostfp::run(r, [](float x) { return std::sqrt(x); }, a))
+        return r;
+    return f32_sqrt(a);
+}
+
+inline float32_t
+host_f32_mulAdd(float32_t a, float32_t b, float32_t c)
+{
+    float32_t r;
+    if (hostfp::Format<float32_t>::FastFma &&
+        hostfp::run(r, [](float x, float y, float z) {
+                return std::fma(x, y, z);
+            }, a, b, c)) {
+        return r;
+    }
+    return f32_mulAdd(a, b, c);
+}
+
+inline float64_t
+host_f64_add(float64_t a, float64_t b)
+{
+    float64_t r;
+    if (hostfp::run(r, [](double x, double y) { return x + y; }, a, b))
+        return r;
+    return f64_add(a, b);
+}
+
+inline float64_t
+host_f64_sub(float64_t a, float64_t b)
+{
+    float64_t r;
+    if (hostfp::run(r, [](double x, double y) { return x - y; }, a, b))
+        return r;
+    return f64_sub(a, b);
+}
+
+inline float64_t
+host_f64_mul(float64_t a, float64_t b)
+{
+    float64_t r;
+    if (hostfp::run(r, [](double x, double y) { return x * y; }, a, b))
+        return r;
+    return f64_mul(a, b);
+}
+
+inline float64_t
+host_f64_div(float64_t a, float64_t b)
+{
+    float64_t r;
+    if (hostfp::run(r, [](double x, double y) { return x / y; }, a, b))
+        return r;
+    return f64_div(a, b);
+}
+
+inline float64_t
+host_f64_sqrt(float64_t a)
+{
+    float64_t r;
+    if (hostfp::run(r, [](double x) { return std::sqrt(x); }, a))
+        return r;
+    return f64_sqrt(a);
+}
+
+inline float64_t
+host_f64_mulAdd(float64_t a, float64_t b, float64_t c)
+{
+    float64_t r;
+    if (hostfp::Format<float64_t>::FastFma &&
+        hostfp::run(r, [](double x, double y, double z) {
+                return std::fma(x, y, z);
+            }, a, b, c)) {
+        return r;
+    }
+    return f64_mulAdd(a, b, c);
+}
+
+} // namespace RiscvISA
+} // namespace gem5
+
+#endif // __ARCH_RISCV_HOST_FP_HH__
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "arch/riscv/host_fp.hh"
+
+using namespace gem5;
+using namespace gem5::RiscvISA;
+
+namespace
+{
+
+// Differential fuzzing of the host FPU path against softfloat: every
+// operation must give the same bits and the same flags, whether it ran on
+// the host or fell back to softfloat.
+
+constexpr int Rounds = 200000;
+
+const uint_fast8_t RoundingModes[] = {
+    softfloat_round_near_even, softfloat_round_minMag,
+    softfloat_round_min, softfloat_round_max, softfloat_round_near_maxMag,
+};
+
+/** Operands of the formats, with the edge cases mixed in. */
+template <typename Bits>
+class Operands
+{
+  public:
+    Operands(std::mt19937_64 &rng, std::vector<Bits> special)
+        : rng(rng), special(special)
+    {}
+
+    Bits
+    next(int exp_bits, int frac_bits)
+    {
+        switch (rng() % 8) {
+          case 0:
+            return special[rng() % special.size()];
+          case 1:
+            // Anything, NaNs included.
+            return Bits(rng());
+          case 2:
+            {
+                // Subnormals and the smallest normals, of either sign.
+                const Bits sign = Bits(1) << (exp_bits + frac_bits);
+                const Bits low = (Bits(1) << (frac_bits + 1)) - 1;
+                return Bits(rng()) & (sign | low);
+            }
+          default:
+            {
+                // Numbers around one, where results stay normal but
+                // round.
+                const Bits bias = (Bits(1) << (exp_bits - 1)) - 1;
+                const Bits exp = bias - 8 + rng() % 16;
+                const Bits sign = Bits(rng() % 2) << (exp_bits + frac_bits);
+                const Bits frac = Bits(rng()) & ((Bits(1) << frac_bits) - 1);
+                return sign | exp << frac_bits | frac;
+            }
+        }
+    }
+
+  private:
+    std::mt19937_64 &rng;
+    std::vector<Bits> special;
+};
+
+const std::vector<uint32_t> Special32 = {
+    0x00000000, 0x80000000, 0x3f800000, 0xbf800000, 0x7f800000,
+    0xff800000, 0x7fc00000, 0xffc00000, 0x7f800001, 0x7fa00000,
+    0x00000001, 0x807fffff, 0x00800000, 0x7f7fffff, 0xff7fffff,
+    0x34000000, 0x4b800000,
+};
+
+const std::vector<uint64_t> Special64 = {
+    0x0000000000000000, 0x8000000000000000, 0x3ff0000000000000,
+    0xbff0000000000000, 0x7ff0000000000000, 0xfff0000000000000,
+    0x7ff8000000000000, 0xfff8000000000000, 0x7ff0000000000001,
+    0x7ff4000000000000, 0x0000000000000001, 0x800fffffffffffff,
+    0x0010000000000000, 0x7fefffffffffffff, 0xffefffffffffffff,
+    0x3cb0000000000000, 0x4340000000000000,
+};
+
+class HostFpTest : public testing::Test
+{
+  protected:
+    std::mt19937_64 rng{0xf10a7};
+    uint_fast8_t savedMode;
+    bool savedHostFp;
+
+    void
+    SetUp() override
+    {
+        savedMode = softfloat_roundingMode;
+        savedHostFp = hostFp;
+        hostFp = true;
+    }
+
+    void
+    TearDown() override
+    {
+        softfloat_roundingMode = savedMode;
+        softfloat_exceptionFlags = 0;
+        hostFp = savedHostFp;
+    }
+
+    /**
+     * Run the host and softfloat versions of an operation from the same
+     * state, and compare their results and flags.
+     */
+    template <typename Soft, typename Host, typename Ref, typename ...Args>
+    void
+    compare(const char *what, Host host, Ref ref, Args ...args)
+    {
+        softfloat_exceptionFlags = 0;
+        const Soft expect = ref(args...);
+        const uint_fast8_t expect_flags = softfloat_exceptionFlags;
+
+        softfloat_exceptionFlags = 0;
+        const Soft got = host(args...);
+        const uint_fast8_t got_flags = softfloat_exceptionFlags;
+
+        if (got.v != expect.v || got_flags != expect_flags) {
+            std::ostringstream ops;
+            for (auto v : {args.v...})
+                ops << std::hex << " 0x" << v;
+            ADD_FAILURE() << what << std::hex << ":" << ops.str()
+                          << " rounding " << int(softfloat_roundingMode)
+                          << ": host 0x" << got.v << " flags 0x"
+                          << int(got_flags) << ", softfloat 0x"
+                          << expect.v << " flags 0x" << int(expect_flags);
+        }
+    }
+
+    uint_fast8_t
+    mode()
+    {
+        // Mostly the default mode, which is the one the host runs.
+        if (rng() % 4)
+            return softfloat_round_near_even;
+        return RoundingModes[rng() % std::size(RoundingModes)];
+    }
+};
+
+} // anonymous namespace
+
+/** Regular operands in round to nearest, even run on the host. */
+TEST_F(HostFpTest, HostPath)
+{
+    if (!hostfp::Available)
+        GTEST_SKIP() << "No host FPU path on this host";
+
+    softfloat_roundingMode = softfloat_round_near_even;
+    const float32_t a32{0x3fc00000}, b32{0x40100000}; // 1.5, 2.25
+    const float64_t a64{0x3ff8000000000000}, b64{0x4002000000000000};
+
+    auto on_host = [](auto op) {
+        const uint64_t before = hostfp::hostOps;
+        op();
+        return hostfp::hostOps == before + 1;
+    };
+    EXPECT_TRUE(on_host([&]() { host_f32_add(a32, b32); }));
+    EXPECT_TRUE(on_host([&]() { host_f32_sub(a32, b32); }));
+    EXPECT_TRUE(on_host([&]() { host_f32_mul(a32, b32); }));
+    EXPECT_TRUE(on_host([&]() { host_f32_div(a32, b32); }));
+    EXPECT_TRUE(on_host([&]() { host_f32_sqrt(b32); }));
+    EXPECT_EQ(on_host([&]() { host_f32_mulAdd(a32, b32, a32); }),
+              hostfp::Format<float32_t>::FastFma);
+    EXPECT_TRUE(on_host([&]() { host_f64_add(a64, b64); }));
+    EXPECT_TRUE(on_host([&]() { host_f64_sub(a64, b64); }));
+    EXPECT_TRUE(on_host([&]() { host_f64_mul(a64, b64); }));
+    EXPECT_TRUE(on_host([&]() { host_f64_div(a64, b64); }));
+    EXPECT_TRUE(on_host([&]() { host_f64_sqrt(b64); }));
+    EXPECT_EQ(on_host([&]() { host_f64_mulAdd(a64, b64, a64); }),
+              hostfp::Format<float64_t>::FastFma);
+
+    // Softfloat does the other rounding modes, NaNs, subnormals, and
+    // all of it when the host path is off.
+    const float32_t nan32{0x7fc00000}, tiny32{0x00000001};
+    EXPECT_FALSE(on_host([&]() { host_f32_add(a32, nan32); }));
+    EXPECT_FALSE(on_host([&]() { host_f32_mul(a32, tiny32); }));
+    softfloat_roundingMode = softfloat_round_minMag;
+    EXPECT_FALSE(on_host([&]() { host_f32_add(a32, b32); }));
+    softfloat_roundingMode = softfloat_round_near_even;
+    hostFp = false;
+    EXPECT_FALSE(on_host([&]() { host_f64_add(a64, b64); }));
+}
+
+TEST_F(HostFpTest, Float32)
+{
+    if (!hostfp::Available)
+        GTEST_SKIP() << "No host FPU path on this host";
+
+    Operands<uint32_t> ops(rng, Special32);
+    auto op = [&]() { return float32_t{ops.next(8, 23)}; };
+    const uint64_t host_ops = hostfp::hostOps;
+    for (int round = 0; round < Rounds && !HasFailure(); round++) {
+        softfloat_roundingMode = mode();
+        const float32_t a = op(), b = op(), c = op();
+        compare<float32_t>("f32_add", host_f32_add, f32_add, a, b);
+        compare<float32_t>("f32_sub", host_f32_sub, f32_sub, a, b);
+        compare<float32_t>("f32_mul", host_f32_mul, f32_mul, a, b);
+        compare<float32_t>("f32_div", host_f32_div, f32_div, a, b);
+        compare<float32_t>("f32_sqrt", host_f32_sqrt, f32_sqrt, a);
+        compare<float32_t>("f32_mulAdd", host_f32_mulAdd, f32_mulAdd,
+                           a, b, c);
+    }
+    // Most operands are regular and most rounding is to nearest, even
+    EXPECT_GT(hostfp::hostOps - host_ops, Rounds);
+}
+
+TEST_F(HostFpTest, Float64)
+{
+    if (!hostfp::Available)
+        GTEST_SKIP() << "No host FPU path on this host";
+
+    Operands<uint64_t> ops(rng, Special64);
+    auto op = [&]() { return float64_t{ops.next(11, 52)}; };
+    const uint64_t host_ops = hostfp::hostOps;
+    for (int round = 0; round < Rounds && !HasFailure(); round++) {
+        softfloat_roundingMode = mode();
+        const float64_t a = op(), b = op(), c = op();
+        compare<float64_t>("f64_add", host_f64_add, f64_add, a, b);
+        compare<float64_t>("f64_sub", host_f64_sub, f64_sub, a, b);
+        compare<float64_t>("f64_mul", host_f64_mul, f64_mul, a, b);
+        compare<float64_t>("f64_div", host_f64_div, f64_div, a, b);
+        compare<float64_t>("f64_sqrt", host_f64_sqrt, f64_sqrt, a);
+        compare<float64_t>("f64_mulAdd", host_f64_mulAdd, f64_mulAdd,
+                           a, b, c);
+    }
+    // Most operands are regular and most rounding is to nearest, even
+    EXPECT_GT(hostfp::hostOps - host_ops, Rounds);
+}
@@ -34,6 +34,7 @@
 #include <set>
 #include <sstream>
 
+#include "arch/riscv/host_fp.hh"
 #include "arch/riscv/interrupts.hh"
 #include "arch/riscv/mmu.hh"
 #include "arch/riscv/pagetable.hh"
@@ -224,6 +225,10 @@ ISA::ISA(const Params &p) : BaseISA(p)
 
     miscRegFile.resize(NUM_MISCREGS);
     clear();
+
+    if (p.host_fp && !hostfp::Available)
+        warn("The host FPU cannot reproduce softfloat, ignoring host_fp.");
+    hostFp = p.host_fp;
 }
 
 bool ISA::inUserMode() const
@@ -0,0 +1,138 @@
+#ifndef __ARCH_RISCV_PAGE_DECISION_CACHE_HH__
+#define __ARCH_RISCV_PAGE_DECISION_CACHE_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "arch/riscv/page_size.hh"
+#include "base/addr_range.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace RiscvISA
+{
+
+/**
+ * Direct mapped cache of the PMP and PMA decisions of physical pages.
+ *
+ * A decision is only kept for a page where every rule either covers the
+ * whole page or none of it, so that all the accesses that stay in the
+ * page get the same decision. The end of an access is checked one past
+ * its last byte, like the checkers do, so a page covers PageBytes + 1
+ * addresses. Changing the rules invalidates all the entries at once.
+ */
+template <typename Decision>
+class PageDecisionCache
+{
+  public:
+    /** How a rule range relates to a page. */
+    enum Overlap
+    {
+        Covers,
+        Misses,
+        Partial,
+    };
+
+    explicit PageDecisionCache(size_t size) : entries(size) {}
+
+    static Addr pageOf(Addr addr) { return addr & ~(PageBytes - 1); }
+
+    /** How the range of a rule relates to the page at page. */
+    static Overlap
+    overlap(const AddrRange &range, Addr page)
+    {
+        const Addr last = page + PageBytes;
+        if (range.interleaved() || last < page)
+            return Partial;
+        if (range.end() <= page || range.start() > last)
+            return Misses;
+        if (range.contains(page) && range.contains(last))
+            return Covers;
+        return Partial;
+    }
+
+    /**
+     * Look up the decision of an access of size bytes at addr. Empty
+     * accesses and those that leave the page are not cached.
+     */
+    bool
+    lookup(Addr addr, unsigned size, Decision &decision) const
+    {
+        const Addr page = pageOf(addr);
+        if (size == 0 || addr + size > page + PageBytes || entries.empty())
+            return false;
+        const Entry &e = entries[index(page)];
+        if (e.generation != generation || e.page != page)
+            return false;
+        decision = e.decision;
+        return true;
+    }
+
+    void
+    insert(Addr page, const Decision &decision)
+    {
+        if (entries.empty())
+            return;
+        entries[index(page)] = {page, generation, decision};
+    }
+
+    /**
+     * Cache the decision of the page of addr, for rules checked in order
+     * where the first one that matches an access decides. The page gets
+     * the decision of the first rule that covers it, or no_match if no rule
+     * overlaps it. Nothing is cached if a rule before the first one that
+     * covers the page overlaps only part of it.
+     *
+     * @param range_of The range of a rule, or nullptr if the rule is off.
+     * @param decision_of The decision of a rule that matches.
+     */
+    template <typename Rules, typename RangeOf, typename DecisionOf>
+    void
+    fill(Addr addr, const Rules &rules, RangeOf range_of,
+         DecisionOf decision_of, const Decision &no_match)
+    {
+        const Addr page = pageOf(addr);
+        for (const auto &rule : rules) {
+            const AddrRange *range = range_of(rule);
+            if (!range)
+                continue;
+            switch (overlap(*range, page)) {
+              case Covers:
+                insert(page, decision_of(rule));
+                return;
+              case Partial:
+                return;
+              case Misses:
+                break;
+            }
+        }
+        insert(page, no_match);
+    }
+
+    /** Drop all the decisions, when the rules change. */
+    void invalidate() { generation++; }
+
+  private:
+    struct Entry
+    {
+        Addr page = 0;
+        // Generation 0 is never current, so new entries are invalid.
+        uint64_t generation = 0;
+        Decision decision = {};
+    };
+
+    size_t index(Addr page) const
+    {
+        return (page >> PageShift) % entries.size();
+    }
+
+    std::vector<Entry> entries;
+    uint64_t generation = 1;
+};
+
+} // namespace RiscvISA
+} // namespace gem5
+
+#endif // __ARCH_RISCV_PAGE_DECISION_CACHE_HH__
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "arch/riscv/page_decision_cache.hh"
+
+using namespace gem5;
+using namespace gem5::RiscvISA;
+
+namespace
+{
+
+typedef PageDecisionCache<int> Cache;
+
+constexpr Addr Page = 0x80004000;
+
+/** A rule of the PMP kind, which can be turned off. */
+struct Rule
+{
+    AddrRange range;
+    bool on;
+};
+
+/**
+ * First rule that is on and contains an access and the byte after it,
+ * like the PMP checks, or -1.
+ */
+int
+firstMatch(const std::vector<Rule> &rules, Addr addr, unsigned size)
+{
+    for (int i = 0; i < rules.size(); i++) {
+        if (rules[i].on && rules[i].range.contains(addr) &&
+            rules[i].range.contains(addr + size)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/** Cache the decision of a page, the decision of a rule is its index. */
+void
+fill(Cache &cache, const std::vector<Rule> &rules, Addr addr)
+{
+    cache.fill(addr, rules,
+        [](const Rule &rule) { return rule.on ? &rule.range : nullptr; },
+        [&rules](const Rule &rule) -> int { return &rule - &rules[0]; },
+        -1);
+}
+
+} // anonymous namespace
+
+TEST(PageDecisionCacheTest, Overlap)
+{
+    EXPECT_EQ(Cache::overlap(AddrRange(Page, Page + PageBytes + 1), Page),
+              Cache::Covers);
+    // The byte after the page is checked too.
+    EXPECT_EQ(Cache::overlap(AddrRange(Page, Page + PageBytes), Page),
+              Cache::Partial);
+    EXPECT_EQ(Cache::overlap(AddrRange(0, Page), Page), Cache::Misses);
+    EXPECT_EQ(Cache::overlap(AddrRange(Page + PageBytes + 1, Page * 2),
+                             Page),
+              Cache::Misses);
+    EXPECT_EQ(Cache::overlap(AddrRange(Page + 8, Page + 16), Page),
+              Cache::Partial);
+    EXPECT_EQ(Cache::overlap(AddrRange(0, 0), Page), Cache::Misses);
+}
+
+TEST(PageDecisionCacheTest, LookupAndInvalidate)
+{
+    Cache cache(16);
+    int decision;
+    EXPECT_FALSE(cache.lookup(Page, 8, decision));
+
+    cache.insert(Page, 3);
+    EXPECT_TRUE(cache.lookup(Page + 0x100, 8, decision));
+    EXPECT_EQ(decision, 3);
+    EXPECT_TRUE(cache.lookup(Page + PageBytes - 8, 8, decision));
+
+    // Accesses that leave the page, or are empty, are not cached.
+    EXPECT_FALSE(cache.lookup(Page + PageBytes - 4, 8, decision));
+    EXPECT_FALSE(cache.lookup(Page, 0, decision));
+
+    // A page of the same set replaces it.
+    cache.insert(Page + 16 * PageBytes, 5);
+    EXPECT_FALSE(cache.lookup(Page, 8, decision));
+    EXPECT_TRUE(cache.lookup(Page + 16 * PageBytes, 8, decision));
+
+    cache.invalidate();
+    EXPECT_FALSE(cache.lookup(Page + 16 * PageBytes, 8, decision));
+}
+
+TEST(PageDecisionCacheTest, Disabled)
+{
+    Cache cache(0);
+    int decision;
+    cache.insert(Page, 1);
+    EXPECT_FALSE(cache.lookup(Page, 8, decision));
+}
+
+TEST(PageDecisionCacheTest, Fill)
+{
+    const AddrRange page(Page, Page + PageBytes + 1);
+    const AddrRange part(Page + 8, Page + 16);
+    int decision;
+
+    // The first rule that covers the page decides, off rules are skipped.
+    Cache cache(16);
+    fill(cache, {{part, false}, {page, true}, {page, true}}, Page);
+    EXPECT_TRUE(cache.lookup(Page, 8, decision));
+    EXPECT_EQ(decision, 1);
+
+    // A rule that overlaps part of the page before it keeps it uncached.
+    cache.invalidate();
+    fill(cache, {{part, true}, {page, true}}, Page);
+    EXPECT_FALSE(cache.lookup(Page + 0x100, 8, decision));
+
+    // But not after it.
+    fill(cache, {{page, true}, {part, true}}, Page);
+    EXPECT_TRUE(cache.lookup(Page + 8, 8, decision));
+    EXPECT_EQ(decision, 0);
+
+    // A page no rule overlaps gets the decision of no match.
+    cache.invalidate();
+    fill(cache, {{part, true}}, Page + PageBytes * 4);
+    EXPECT_TRUE(cache.lookup(Page + PageBytes * 4, 8, decision));
+    EXPECT_EQ(decision, -1);
+}
+
+/** Cached decisions are always those of a scan of the rules. */
+TEST(PageDecisionCacheTest, MatchesScan)
+{
+    std::mt19937_64 rng(0x9a6e);
+    const Addr base = 0x80000000;
+    const Addr span = 64 * PageBytes;
+    auto addr = [&]() { return base + rng() % span; };
+    int hits = 0;
+
+    for (int round = 0; round < 200; round++) {
+        std::vector<Rule> rules;
+        const int n = 1 + rng() % 6;
+        for (int i = 0; i < n; i++) {
+            Addr start = addr(), end = addr();
+            if (rng() % 2) {
+                // Page aligned, as most rules are.
+                start = Cache::pageOf(start);
+                end = Cache::pageOf(end) + 1;
+            }
+            if (start > end)
+                std::swap(start, end);
+            rules.push_back({AddrRange(start, end), rng() % 4 != 0});
+        }
+
+        Cache cache(8);
+        for (int access = 0; access < 2000; access++) {
+            const Addr a = addr();
+            const unsigned size = 1 << (rng() % 4);
+            int decision;
+            if (cache.lookup(a, size, decision)) {
+                ASSERT_EQ(decision, firstMatch(rules, a, size));
+                hits++;
+            } else {
+                fill(cache, rules, a);
+            }
+        }
+    }
+    EXPECT_GT(hits, 0);
+}
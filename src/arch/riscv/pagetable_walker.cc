@@ -123,6 +123,9 @@ Walker::start(Addr ppn, ThreadContext *_tc, BaseMMU::Translation *_translation,
                     "into currStates\n",
                     currStates.size(), _req->getPC(), _req->getVaddr());
             currStates.push_back(newState);
+            stats.walks++;
+            if (from_l2tlb)
+                stats.stepsSaved += 2 - f_level;
             Fault fault = newState->startWalk(ppn, f_level, from_l2tlb, openNextLine, autoOpenNextLine,
                                               from_forward_pre_req, from_back_pre_req);
             if (!newState->isTiming()) {
@@ -134,12 +137,16 @@ Walker::start(Addr ppn, ThreadContext *_tc, BaseMMU::Translation *_translation,
                     "Walks in progress: %d. Coalesce req pc: %#lx, addr: %#lx "
                     "into currStates\n",
                     currStates.size(), _req->getPC(), _req->getVaddr());
+            stats.coalescedWalks++;
             return fault;
         }
     } else {
         WalkerState *newState = new WalkerState(this, _translation, _req);
         newState->initState(_tc, _mode, sys->isTimingMode(), from_forward_pre_req, from_back_pre_req);
         currStates.push_back(newState);
+        stats.walks++;
+        if (from_l2tlb)
+            stats.stepsSaved += 2 - f_level;
         Fault fault = newState->startWalk(ppn, f_level, from_l2tlb, openNextLine, autoOpenNextLine,
                                           from_forward_pre_req, from_back_pre_req);
         if (!newState->isTiming()) {
@@ -193,25 +200,80 @@ Walker::recvTimingResp(PacketPtr pkt)
     DPRINTF(PageTableWalker,
             "Received timing response for sender state: %#lx\n", senderState);
     WalkerState * senderWalk = senderState->senderWalk;
-    bool walkComplete = senderWalk->recvPacket(pkt);
     delete senderState;
-    if (walkComplete) {
-        std::list<WalkerState *>::iterator iter;
-        for (iter = currStates.begin(); iter != currStates.end(); iter++) {
-            WalkerState * walkerState = *(iter);
-            if (walkerState == senderWalk) {
-                DPRINTF(PageTableWalker,
-                        "Walk complete for %#lx (pc=%#lx), erase it\n",
-                        senderWalk->mainReq->getVaddr(), senderWalk->mainReq->getPC());
-                iter = currStates.erase(iter);
-                break;
-            }
+
+    // Complete the reads of the walks that waited for this line before
+    // the sender walk steps, as that may free the packet.
+    std::vector<std::pair<WalkerState *, PacketPtr>> waiters;
+    auto line = pteLinesInFlight.find(pkt->getAddr());
+    if (pkt->isRead() && line != pteLinesInFlight.end()) {
+        waiters = std::move(line->second.waiters);
+        pteLinesInFlight.erase(line);
+    }
+    for (auto &[walk, read] : waiters) {
+        read->makeResponse();
+        if (pkt->isError())
+            read->copyError(pkt);
+        else
+            read->setData(pkt->getConstPtr<uint8_t>());
+    }
+
+    deliver(senderWalk, pkt);
+    for (auto &[walk, read] : waiters)
+        deliver(walk, read);
+    return true;
+}
+
+void
+Walker::deliver(WalkerState *walk, PacketPtr pkt)
+{
+    if (!walk->recvPacket(pkt))
+        return;
+
+    for (auto iter = currStates.begin(); iter != currStates.end(); iter++) {
+        if (*iter == walk) {
+            DPRINTF(PageTableWalker,
+                    "Walk complete for %#lx (pc=%#lx), erase it\n",
+                    walk->mainReq->getVaddr(), walk->mainReq->getPC());
+            currStates.erase(iter);
+            break;
         }
-        delete senderWalk;
-        // Since we block requests when another is outstanding, we
-        // need to check if there is a waiting request to be serviced
+    }
+    delete walk;
+}
+
+void
+Walker::sendAtomic(PacketPtr pkt)
+{
+    // With caches, the accesses must go through them to stay coherent.
+    if (!sys->bypassCaches())
+        port.sendAtomic(pkt);
+    else if (!memBackdoors.access(pkt))
+        memBackdoors.sendAtomic(port, pkt);
+}
 
+void
+Walker::sendFunctional(PacketPtr pkt)
+{
+    if (!sys->bypassCaches() || !memBackdoors.access(pkt))
+        port.sendFunctional(pkt);
+}
+
+bool
+Walker::shareRead(WalkerState *sendingState, PacketPtr pkt)
+{
+    if (!sharePteLines)
+        return false;
+    auto line = pteLinesInFlight.find(pkt->getAddr());
+    if (line == pteLinesInFlight.end() ||
+        line->second.size != pkt->getSize() || line->second.written) {
+        return false;
     }
+
+    DPRINTF(PageTableWalker, "Wait for the read of %#lx by another walk\n",
+            pkt->getAddr());
+    line->second.waiters.emplace_back(sendingState, pkt);
+    stats.sharedPteReads++;
     return true;
 }
 
@@ -240,6 +302,22 @@ bool Walker::sendTiming(WalkerState* sendingState, PacketPtr pkt)
             pkt->getAddr(), walker_state);
     pkt->pushSenderState(walker_state);
     if (port.sendTimingReq(pkt)) {
+        if (pkt->isRead()) {
+            stats.pteReads++;
+            if (sharePteLines) {
+                pteLinesInFlight.try_emplace(pkt->getAddr(),
+                                             PteLineRead{pkt->getSize()});
+            }
+        } else {
+            // The walks that wait for a read sent before this write get
+            // the PTE without the new A/D bits, as the sender of the read
+            // does. Later walks must read the line again.
+            const AddrRange written = pkt->getAddrRange();
+            for (auto &[addr, line] : pteLinesInFlight) {
+                if (RangeSize(addr, line.size).intersects(written))
+                    line.written = true;
+            }
+        }
         return true;
     } else {
         // undo the adding of the sender state and delete it, as we
@@ -251,6 +329,23 @@ bool Walker::sendTiming(WalkerState* sendingState, PacketPtr pkt)
 
 }
 
+Walker::WalkerStats::WalkerStats(statistics::Group *parent)
+    : statistics::Group(parent),
+      ADD_STAT(walks, statistics::units::Count::get(),
+               "page table walks started"),
+      ADD_STAT(coalescedWalks, statistics::units::Count::get(),
+               "translations coalesced into a walk in progress"),
+      ADD_STAT(stepsSaved, statistics::units::Count::get(),
+               "walk steps skipped by starting from an L2 TLB PTE"),
+      ADD_STAT(pteReads, statistics::units::Count::get(),
+               "page table lines read from memory"),
+      ADD_STAT(sharedPteReads, statistics::units::Count::get(),
+               "page table lines taken from the read of another walk"),
+      ADD_STAT(l2tlbFills, statistics::units::Count::get(),
+               "L2 TLB entries filled from page table lines")
+{
+}
+
 Port &
 Walker::getPort(const std::string &if_name, PortID idx)
 {
@@ -452,14 +547,15 @@ Walker::WalkerState::startWalk(Addr ppn, int f_level, bool from_l2tlb,
         sendPackets();
     } else {
         do {
-            walker->port.sendAtomic(read);
+            walker->sendAtomic(read);
+            walker->stats.pteReads++;
             PacketPtr write = NULL;
             fault = stepWalk(write);
             assert(fault == NoFault || read == NULL);
             state = nextState;
             nextState = Ready;
             if (write)
-                walker->port.sendAtomic(write);
+                walker->sendAtomic(write);
         } while (read);
         state = Ready;
         nextState = Waiting;
@@ -480,7 +576,7 @@ Walker::WalkerState::startFunctional(Addr &addr, unsigned &logBytes,
               from_back_pre_req);
 
     do {
-        walker->port.sendFunctional(read);
+        walker->sendFunctional(read);
         // On a functional access (page table lookup), writes should
         // not happen so this pointer is ignored after stepWalk
         PacketPtr write = NULL;
@@ -647,6 +743,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
                         l2pte = read->getLE_l2tlb<uint64_t>(l2_i);
                         inl2Entry.paddr = l2pte.ppn;
                         inl2Entry.pte = l2pte;
+                        walker->stats.l2tlbFills++;
                         if (l2_level == 2) {
                             walker->tlb->L2TLBInsert(inl2Entry.vaddr, inl2Entry, l2_level, L_L2L1, l2_i, false);
                         }
@@ -732,6 +829,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
                     DPRINTF(PageTableWalker3, "level %d l2_level %d\n", level, l2_level);
                     inl2Entry.paddr = l2pte.ppn;
                     inl2Entry.pte = l2pte;
+                    walker->stats.l2tlbFills++;
                     if (l2_level == 0) {
                         inl2Entry.index = (entry.vaddr >> (L2TLB_BLK_OFFSET + PageShift)) & L2TLB_L3_MASK;
                         walker->tlb->L2TLBInsert(inl2Entry.vaddr, inl2Entry, l2_level, L_L2L3, l2_i, false);
@@ -770,7 +868,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
                         nextlineEntry.vaddr =
                             entry.vaddr + (l2tlbLineSize << (nextlineLevel * LEVEL_BITS + PageShift));
 
-                        RequestPtr request = std::make_shared<Request>(
+                        RequestPtr request = makeRequest(
                             nextRead, oldRead->getSize(), flags,
                             walker->requestorId);
                         if (nextRead == 0)
@@ -815,6 +913,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
                 l2pte = read->getLE_l2tlb<uint64_t>(n_l2_i);
                 nextlineEntry.paddr = l2pte.ppn;
                 nextlineEntry.pte = l2pte;
+                walker->stats.l2tlbFills++;
                 if (nextlineEntry.level == 0) {
                     nextlineEntry.index = (nextlineEntry.vaddr >> (PageShift + L2TLB_BLK_OFFSET)) & (L2TLB_L3_MASK);
                     walker->tlb->L2TLBInsert(nextlineEntry.vaddr, nextlineEntry, nextlineLevel, L_L2L3, n_l2_i, false);
@@ -833,7 +932,7 @@ Walker::WalkerState::stepWalk(PacketPtr &write)
         endWalk();
     } else {
         //If we didn't return, we're setting up another read.
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = makeRequest(
             nextRead, oldRead->getSize(), flags, walker->requestorId);
         if (nextRead == 0)
             panic("nextread can't be 0\n");
@@ -938,7 +1037,7 @@ Walker::WalkerState::setupWalk(Addr ppn, Addr vaddr, int f_level, bool from_l2tl
 
 
     Request::Flags flags = Request::PHYSICAL;
-    RequestPtr request = std::make_shared<Request>(topAddr, 64, flags, walker->requestorId);
+    RequestPtr request = makeRequest(topAddr, 64, flags, walker->requestorId);
     if (topAddr == 0)
         panic("topAddr can't be 0\n");
     DPRINTF(PageTableWalker," sv39 size is %d\n",sizeof(PTESv39));
@@ -1153,6 +1252,10 @@ Walker::WalkerState::sendPackets()
         return;
 
     //Reads always have priority
+    if (read && walker->shareRead(this, read)) {
+        read = NULL;
+        inflight++;
+    }
     if (read) {
         PacketPtr pkt = read;
         read = NULL;
@@ -39,6 +39,8 @@
 #ifndef __ARCH_RISCV_TABLE_WALKER_HH__
 #define __ARCH_RISCV_TABLE_WALKER_HH__
 
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "arch/generic/mmu.hh"
@@ -46,7 +48,9 @@
 #include "arch/riscv/pma_checker.hh"
 #include "arch/riscv/pmp.hh"
 #include "arch/riscv/tlb.hh"
+#include "base/statistics.hh"
 #include "base/types.hh"
+#include "mem/backdoor_cache.hh"
 #include "mem/packet.hh"
 #include "params/RiscvPagetableWalker.hh"
 #include "sim/clocked_object.hh"
@@ -250,6 +254,23 @@ namespace RiscvISA
                 senderWalk(_senderWalk) {}
         };
 
+        /**
+         * A page table line read by a walk, with the reads of the other
+         * walks that wait for the same line instead of reading it again.
+         */
+        struct PteLineRead
+        {
+            unsigned size;
+            std::vector<std::pair<WalkerState *, PacketPtr>> waiters;
+            /**
+             * A walk wrote the A/D bits of a PTE of the line after the
+             * read was sent, so the read may return the old PTE and no
+             * other walk may join it.
+             */
+            bool written = false;
+        };
+        std::unordered_map<Addr, PteLineRead> pteLinesInFlight;
+
       public:
         // Kick off the state machine.
         Fault start(Addr ppn, ThreadContext *_tc,
@@ -291,8 +312,12 @@ namespace RiscvISA
         bool ptwSquash;
         bool openNextLine;
         bool autoOpenNextLine;
+        bool sharePteLines;
         bool is_from_pre_req;
 
+        // Backdoors to memory for the walks of a system without caches.
+        MemBackdoorCache memBackdoors;
+
         Tick squashHandleTick;
 
         // Wrapper for checking for squashes before starting a translation.
@@ -310,10 +335,29 @@ namespace RiscvISA
 
         EventFunctionWrapper doL2TLBHitEvent;
 
+        struct WalkerStats : public statistics::Group
+        {
+            WalkerStats(statistics::Group *parent);
+
+            statistics::Scalar walks;
+            statistics::Scalar coalescedWalks;
+            statistics::Scalar stepsSaved;
+            statistics::Scalar pteReads;
+            statistics::Scalar sharedPteReads;
+            statistics::Scalar l2tlbFills;
+        } stats;
+
         // Functions for dealing with packets.
         bool recvTimingResp(PacketPtr pkt);
         void recvReqRetry();
         bool sendTiming(WalkerState * sendingState, PacketPtr pkt);
+        // Atomic and functional accesses, through a backdoor if possible.
+        void sendAtomic(PacketPtr pkt);
+        void sendFunctional(PacketPtr pkt);
+        // Wait for the line of a read if another walk is reading it.
+        bool shareRead(WalkerState *sendingState, PacketPtr pkt);
+        // Hand a response to a walk, and free the walk if it is done.
+        void deliver(WalkerState *walk, PacketPtr pkt);
         //bool pre_ptw;
 
       public:
@@ -335,7 +379,9 @@ namespace RiscvISA
             ptwSquash(params.ptw_squash),
             openNextLine(params.open_nextline),
             autoOpenNextLine(true),
-            doL2TLBHitEvent([this]{dol2TLBHit();},name())
+            sharePteLines(params.share_pte_lines),
+            doL2TLBHitEvent([this]{dol2TLBHit();},name()),
+            stats(this)
         {
         }
     };
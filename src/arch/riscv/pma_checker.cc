@@ -49,7 +49,8 @@ namespace gem5
 
 PMAChecker::PMAChecker(const Params &params) :
 SimObject(params),
-uncacheable(params.uncacheable.begin(), params.uncacheable.end())
+uncacheable(params.uncacheable.begin(), params.uncacheable.end()),
+decisions(params.decision_cache_size)
 {
 }
 
@@ -75,8 +76,18 @@ PMAChecker::isUncacheable(const AddrRange &range)
 bool
 PMAChecker::isUncacheable(const Addr &addr, const unsigned size)
 {
+    bool uncacheable_page;
+    if (decisions.lookup(addr, size, uncacheable_page))
+        return uncacheable_page;
+
     AddrRange range(addr, addr + size);
-    return isUncacheable(range);
+    const bool result = isUncacheable(range);
+    decisions.fill(addr, uncacheable,
+        [](const AddrRange &uncacheable_range) {
+            return &uncacheable_range;
+        },
+        [](const AddrRange &) { return true; }, false);
+    return result;
 }
 
 bool
@@ -89,6 +100,7 @@ void
 PMAChecker::takeOverFrom(PMAChecker *old)
 {
     uncacheable = old->uncacheable;
+    decisions.invalidate();
 }
 
 } // namespace gem5
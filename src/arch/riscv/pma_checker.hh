@@ -38,6 +38,7 @@
 #ifndef __ARCH_RISCV_PMA_CHECKER_HH__
 #define __ARCH_RISCV_PMA_CHECKER_HH__
 
+#include "arch/riscv/page_decision_cache.hh"
 #include "base/addr_range.hh"
 #include "base/types.hh"
 #include "mem/packet.hh"
@@ -79,6 +80,10 @@ class PMAChecker : public SimObject
     bool isUncacheable(PacketPtr pkt);
 
     void takeOverFrom(PMAChecker *old);
+
+  private:
+    /** Whether the accesses of a page are uncacheable. */
+    RiscvISA::PageDecisionCache<bool> decisions;
 };
 
 } // namespace gem5
@@ -47,7 +47,8 @@ namespace gem5
 PMP::PMP(const Params &params) :
     SimObject(params),
     pmpEntries(params.pmp_entries),
-    numRules(0)
+    numRules(0),
+    decisions(params.decision_cache_size)
 {
     pmpTable.resize(pmpEntries);
 }
@@ -76,49 +77,24 @@ PMP::pmpCheck(const RequestPtr &req, BaseMMU::Mode mode,
     if (numRules == 0 || (pmode == RiscvISA::PrivilegeMode::PRV_M))
         return NoFault;
 
-    // match_index will be used to identify the pmp entry
-    // which matched for the given address
-    int match_index = -1;
-
-    // all pmp entries need to be looked from the lowest to
-    // the highest number
-    for (int i = 0; i < pmpTable.size(); i++) {
-        AddrRange pmp_range = pmpTable[i].pmpAddr;
-        if (pmp_range.contains(req->getPaddr()) &&
-                pmp_range.contains(req->getPaddr() + req->getSize())) {
-            // according to specs address is only matched,
-            // when (addr) and (addr + request_size) are both
-            // within the pmp range
-            match_index = i;
-        }
-
-        if ((match_index > -1)
-            && (PMP_OFF != pmpGetAField(pmpTable[match_index].pmpCfg))) {
-            // check the RWX permissions from the pmp entry
-            uint8_t allowed_privs = PMP_READ | PMP_WRITE | PMP_EXEC;
-
-            // i is the index of pmp table which matched
-            allowed_privs &= pmpTable[match_index].pmpCfg;
-
-            if ((mode == BaseMMU::Mode::Read) &&
-                                        (PMP_READ & allowed_privs)) {
-                return NoFault;
-            } else if ((mode == BaseMMU::Mode::Write) &&
-                                        (PMP_WRITE & allowed_privs)) {
-                return NoFault;
-            } else if ((mode == BaseMMU::Mode::Execute) &&
-                                        (PMP_EXEC & allowed_privs)) {
-                return NoFault;
-            } else {
-                if (req->hasVaddr()) {
-                    return createAddrfault(req->getVaddr(), mode);
-                } else {
-                    return createAddrfault(vaddr, mode);
-                }
-            }
+    // the RWX permissions of the pmp entry which matched
+    // for the given address
+    const int allowed_privs = pmpDecide(req->getPaddr(), req->getSize());
+
+    if (allowed_privs >= 0) {
+        if ((mode == BaseMMU::Mode::Read) &&
+                                    (PMP_READ & allowed_privs)) {
+            return NoFault;
+        } else if ((mode == BaseMMU::Mode::Write) &&
+                                    (PMP_WRITE & allowed_privs)) {
+            return NoFault;
+        } else if ((mode == BaseMMU::Mode::Execute) &&
+                                    (PMP_EXEC & allowed_privs)) {
+            return NoFault;
         }
     }
-    // if no entry matched and we are not in M mode return fault
+    // if no entry matched, or it does not allow the access,
+    // and we are not in M mode return fault
     if (req->hasVaddr()) {
         return createAddrfault(req->getVaddr(), mode);
     } else {
@@ -126,6 +102,44 @@ PMP::pmpCheck(const RequestPtr &req, BaseMMU::Mode mode,
     }
 }
 
+int
+PMP::pmpMatch(Addr paddr, unsigned size)
+{
+    // all pmp entries need to be looked from the lowest to
+    // the highest number
+    for (int i = 0; i < pmpTable.size(); i++) {
+        AddrRange pmp_range = pmpTable[i].pmpAddr;
+        // according to specs address is only matched,
+        // when (addr) and (addr + request_size) are both
+        // within the pmp range
+        if (pmp_range.contains(paddr) && pmp_range.contains(paddr + size)
+            && (PMP_OFF != pmpGetAField(pmpTable[i].pmpCfg))) {
+            return pmpTable[i].pmpCfg & (PMP_READ | PMP_WRITE | PMP_EXEC);
+        }
+    }
+    return -1;
+}
+
+int
+PMP::pmpDecide(Addr paddr, unsigned size)
+{
+    int allowed_privs;
+    if (decisions.lookup(paddr, size, allowed_privs))
+        return allowed_privs;
+
+    allowed_privs = pmpMatch(paddr, size);
+    decisions.fill(paddr, pmpTable,
+        [this](const PmpEntry &entry) -> const AddrRange * {
+            if (PMP_OFF == pmpGetAField(entry.pmpCfg))
+                return nullptr;
+            return &entry.pmpAddr;
+        },
+        [this](const PmpEntry &entry) -> int {
+            return entry.pmpCfg & (PMP_READ | PMP_WRITE | PMP_EXEC);
+        }, -1);
+    return allowed_privs;
+}
+
 Fault
 PMP::createAddrfault(Addr vaddr, BaseMMU::Mode mode)
 {
@@ -203,6 +217,7 @@ PMP::pmpUpdateRule(uint32_t pmp_index)
     }
 
     pmpTable[pmp_index].pmpAddr = this_range;
+    decisions.invalidate();
 
     for (int i = 0; i < pmpEntries; i++) {
         const uint8_t a_field = pmpGetAField(pmpTable[i].pmpCfg);
@@ -31,6 +31,7 @@
 
 #include "arch/generic/tlb.hh"
 #include "arch/riscv/isa.hh"
+#include "arch/riscv/page_decision_cache.hh"
 #include "base/addr_range.hh"
 #include "base/types.hh"
 #include "mem/packet.hh"
@@ -105,6 +106,14 @@ class PMP : public SimObject
     /** a table of pmp entries */
     std::vector<PmpEntry> pmpTable;
 
+    /**
+     * The RWX permissions of the entry that matches the accesses of a
+     * page, or -1 when none does. Every rule update drops them. They do
+     * not depend on the privilege mode, which only decides whether the
+     * table is consulted at all.
+     */
+    RiscvISA::PageDecisionCache<int> decisions;
+
   public:
     /**
      * pmpCheck checks if a particular memory access
@@ -172,6 +181,24 @@ class PMP : public SimObject
      */
     void pmpUpdateRule(uint32_t pmp_index);
 
+    /**
+     * pmpMatch scans the pmp table for an access.
+     * @param paddr physical address of the access.
+     * @param size size of the access.
+     * @return the RWX permissions of the first entry which
+     * matches the access, or -1 if no entry matches.
+     */
+    int pmpMatch(Addr paddr, unsigned size);
+
+    /**
+     * pmpDecide gives the result of pmpMatch, from the
+     * decision cache when the page of the access is in it.
+     * @param paddr physical address of the access.
+     * @param size size of the access.
+     * @return the RWX permissions, or -1.
+     */
+    int pmpDecide(Addr paddr, unsigned size);
+
     /**
      * pmpGetAField extracts the A field (address matching mode)
      * from an input pmpcfg register
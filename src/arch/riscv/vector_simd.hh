@@ -0,0 +1,418 @@
+#ifndef __ARCH_RISCV_VECTOR_SIMD_HH__
+#define __ARCH_RISCV_VECTOR_SIMD_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "arch/riscv/types.hh"
+
+namespace gem5
+{
+
+namespace RiscvISA
+{
+
+/**
+ * Host SIMD kernels for the element loops of the vector micro-ops.
+ *
+ * A kernel runs an operation over the elements of one micro-op a host
+ * vector at a time, with the GNU vector extensions, and blends the result
+ * into the old value of vd with the mask of the active elements, those
+ * below vl and set in v0 when the instruction is masked. Integer
+ * arithmetic is done on unsigned lanes, so that it wraps exactly like the
+ * scalar code. The elements that do not fill a whole host vector go
+ * through a zero padded one.
+ */
+namespace vsimd
+{
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_convertvector)
+#define VSIMD_HAS_CONVERTVECTOR 1
+#endif
+#endif
+#ifndef VSIMD_HAS_CONVERTVECTOR
+#define VSIMD_HAS_CONVERTVECTOR 0
+#endif
+
+#if defined(__AVX2__)
+constexpr size_t HostBytes = std::min<size_t>(32, VLENB);
+#else
+constexpr size_t HostBytes = std::min<size_t>(16, VLENB);
+#endif
+
+template <typename T>
+constexpr size_t Lanes = HostBytes / sizeof(T);
+
+template <typename T, size_t N>
+struct HostVec
+{
+    typedef T type __attribute__((vector_size(N * sizeof(T))));
+};
+
+/** Host vector of elements of type T. */
+template <typename T>
+using Vec = typename HostVec<T, Lanes<T>>::type;
+
+template <typename T>
+using Unsigned = std::make_unsigned_t<T>;
+
+/** Reinterpret the lanes of a host vector as elements of type T. */
+template <typename T, typename V>
+inline Vec<T>
+as(V v)
+{
+    static_assert(sizeof(V) == sizeof(Vec<T>));
+    return (Vec<T>)v;
+}
+
+/**
+ * Load the first k of the Lanes<T> elements at p, and convert them to T
+ * when p holds narrower elements (widening operations).
+ */
+template <typename T, typename S>
+inline Vec<T>
+load(const S *p, size_t k)
+{
+    static_assert(sizeof(S) <= sizeof(T));
+    if constexpr (sizeof(S) == sizeof(T)) {
+        Vec<T> v = {};
+        std::memcpy(&v, p, k * sizeof(S));
+        return v;
+    } else {
+        typedef typename HostVec<S, Lanes<T>>::type Narrow;
+        Narrow n = {};
+        std::memcpy(&n, p, k * sizeof(S));
+#if VSIMD_HAS_CONVERTVECTOR
+        return __builtin_convertvector(n, Vec<T>);
+#else
+        Vec<T> v;
+        for (size_t j = 0; j < Lanes<T>; j++)
+            v[j] = T(n[j]);
+        return v;
+#endif
+    }
+}
+
+template <typename T>
+inline void
+store(T *p, Vec<T> v, size_t k)
+{
+    std::memcpy(p, &v, k * sizeof(T));
+}
+
+/** Source operand of a kernel, the elements of a vector register. */
+template <typename S>
+struct Elems
+{
+    typedef S type;
+    const S *p;
+
+    template <typename T>
+    Vec<T> chunk(size_t i, size_t k) const { return load<T>(p + i, k); }
+};
+
+/** Source operand of a kernel, a scalar for every element. */
+template <typename S>
+struct Splat
+{
+    typedef S type;
+    S x;
+
+    template <typename T>
+    Vec<T> chunk(size_t, size_t) const { return Vec<T>{} + T(x); }
+};
+
+template <typename S>
+inline Elems<S> elems(const S *p) { return {p}; }
+
+template <typename S>
+inline Splat<S> splat(S x) { return {x}; }
+
+/**
+ * The elements of a micro-op that are written: first is the index in the
+ * register group of its element 0, n the number of its elements, and v0
+ * the mask register, or nullptr when the instruction is not masked.
+ */
+class Active
+{
+  public:
+    Active(size_t first, size_t n, size_t vl, const uint8_t *v0)
+        : _first(first), _tail(vl > first ? std::min(n, vl - first) : 0),
+          v0(v0), _all(!v0 && _tail == n)
+    {}
+
+    size_t first() const { return _first; }
+
+    /** True if every element of the micro-op is written. */
+    bool all() const { return _all; }
+
+    /** True if element i of the micro-op is written. */
+    bool
+    test(size_t i) const
+    {
+        if (i >= _tail)
+            return false;
+        const size_t e = _first + i;
+        return !v0 || ((v0[e / 8] >> (e % 8)) & 1);
+    }
+
+    /** Lanes of all ones for the written elements from element i. */
+    template <typename T>
+    Vec<Unsigned<T>>
+    lanes(size_t i, size_t k) const
+    {
+        Vec<Unsigned<T>> m = {};
+        for (size_t j = 0; j < k; j++)
+            m[j] = test(i + j) ? Unsigned<T>(~Unsigned<T>(0)) : 0;
+        return m;
+    }
+
+  private:
+    size_t _first;
+    size_t _tail;
+    const uint8_t *v0;
+    bool _all;
+};
+
+/**
+ * vd[i] = op(a[i], b[i]) for the active elements of the micro-op. The
+ * kernels return vd, see VSIMD_VD.
+ */
+template <typename T, typename A, typename B, typename Op>
+inline T *
+apply(T *vd, const A &a, const B &b, const Active &active, size_t n, Op)
+{
+    using U = Unsigned<T>;
+    for (size_t i = 0; i < n; i += Lanes<T>) {
+        const size_t k = std::min(Lanes<T>, n - i);
+        Vec<T> r = Op::template vec<T>(a.template chunk<T>(i, k),
+                                       b.template chunk<T>(i, k));
+        if (!active.all()) {
+            const Vec<U> m = active.template lanes<T>(i, k);
+            const Vec<U> old = load<U>((const U *)(vd + i), k);
+            r = as<T>((as<U>(r) & m) | (old & ~m));
+        }
+        store(vd + i, r, k);
+    }
+    return vd;
+}
+
+/** vd[i] = v0[i] ? b[i] : a[i] for the active elements of the micro-op. */
+template <typename T, typename A, typename B>
+inline T *
+merge(T *vd, const A &a, const B &b, const uint8_t *v0,
+      const Active &active, size_t n)
+{
+    using U = Unsigned<T>;
+    const Active select(active.first(), n, active.first() + n, v0);
+    for (size_t i = 0; i < n; i += Lanes<T>) {
+        const size_t k = std::min(Lanes<T>, n - i);
+        const Vec<U> s = select.template lanes<T>(i, k);
+        Vec<U> r = (as<U>(b.template chunk<T>(i, k)) & s) |
+                   (as<U>(a.template chunk<T>(i, k)) & ~s);
+        if (!active.all()) {
+            const Vec<U> m = active.template lanes<T>(i, k);
+            const Vec<U> old = load<U>((const U *)(vd + i), k);
+            r = (r & m) | (old & ~m);
+        }
+        store(vd + i, as<T>(r), k);
+    }
+    return vd;
+}
+
+/**
+ * Set bit first + i of the mask vd to cmp(a[i], b[i]) for the active
+ * elements of the micro-op, comparing elements of the type of a.
+ */
+template <typename A, typename B, typename Cmp>
+inline uint8_t *
+compare(uint8_t *vd, const A &a, const B &b, const Active &active,
+        size_t n, Cmp)
+{
+    using T = typename A::type;
+    for (size_t i = 0; i < n; i += Lanes<T>) {
+        const size_t k = std::min(Lanes<T>, n - i);
+        const auto c = Cmp::template vec<T>(a.template chunk<T>(i, k),
+                                            b.template chunk<T>(i, k));
+        for (size_t j = 0; j < k; j++) {
+            if (!active.all() && !active.test(i + j))
+                continue;
+            const size_t bit = active.first() + i + j;
+            vd[bit / 8] = (vd[bit / 8] & ~(1 << bit % 8)) |
+                          ((c[j] != 0) << bit % 8);
+        }
+    }
+    return vd;
+}
+
+// Element operations of the kernels.
+
+struct Add
+{
+    template <typename T>
+    static Vec<T>
+    vec(Vec<T> a, Vec<T> b)
+    {
+        return as<T>(as<Unsigned<T>>(a) + as<Unsigned<T>>(b));
+    }
+};
+
+struct Sub
+{
+    template <typename T>
+    static Vec<T>
+    vec(Vec<T> a, Vec<T> b)
+    {
+        return as<T>(as<Unsigned<T>>(a) - as<Unsigned<T>>(b));
+    }
+};
+
+struct RSub
+{
+    template <typename T>
+    static Vec<T> vec(Vec<T> a, Vec<T> b) { return Sub::vec<T>(b, a); }
+};
+
+struct Mul
+{
+    template <typename T>
+    static Vec<T>
+    vec(Vec<T> a, Vec<T> b)
+    {
+        return as<T>(as<Unsigned<T>>(a) * as<Unsigned<T>>(b));
+    }
+};
+
+struct And
+{
+    template <typename T>
+    static Vec<T> vec(Vec<T> a, Vec<T> b) { return a & b; }
+};
+
+struct Or
+{
+    template <typename T>
+    static Vec<T> vec(Vec<T> a, Vec<T> b) { return a | b; }
+};
+
+struct Xor
+{
+    template <typename T>
+    static Vec<T> vec(Vec<T> a, Vec<T> b) { return a ^ b; }
+};
+
+struct Min
+{
+    template <typename T>
+    static Vec<T>
+    vec(Vec<T> a, Vec<T> b)
+    {
+        const auto lt = as<Unsigned<T>>(b < a);
+        return as<T>((as<Unsigned<T>>(b) & lt) | (as<Unsigned<T>>(a) & ~lt));
+    }
+};
+
+struct Max
+{
+    template <typename T>
+    static Vec<T>
+    vec(Vec<T> a, Vec<T> b)
+    {
+        const auto lt = as<Unsigned<T>>(a < b);
+        return as<T>((as<Unsigned<T>>(b) & lt) | (as<Unsigned<T>>(a) & ~lt));
+    }
+};
+
+struct Second
+{
+    template <typename T>
+    static Vec<T> vec(Vec<T>, Vec<T> b) { return b; }
+};
+
+/** vd[i] = a[i] for the active elements of the micro-op. */
+template <typename T, typename A>
+inline T *
+move(T *vd, const A &a, const Active &active, size_t n)
+{
+    return apply(vd, a, a, active, n, Second());
+}
+
+struct Eq
+{
+    template <typename T>
+    static auto vec(Vec<T> a, Vec<T> b) { return a == b; }
+};
+
+struct Ne
+{
+    template <typename T>
+    static auto vec(Vec<T> a, Vec<T> b) { return a != b; }
+};
+
+struct Lt
+{
+    template <typename T>
+    static auto vec(Vec<T> a, Vec<T> b) { return a < b; }
+};
+
+struct Le
+{
+    template <typename T>
+    static auto vec(Vec<T> a, Vec<T> b) { return a <= b; }
+};
+
+struct Gt
+{
+    template <typename T>
+    static auto vec(Vec<T> a, Vec<T> b) { return a > b; }
+};
+
+// Sign injection of the bits of floating point elements, a is vs2 and b
+// the sign source.
+
+template <typename T>
+inline Vec<T>
+signBit()
+{
+    static_assert(std::is_unsigned_v<T>);
+    return Vec<T>{} + T(T(1) << (sizeof(T) * 8 - 1));
+}
+
+struct SignInject
+{
+    template <typename T>
+    static Vec<T>
+    vec(Vec<T> a, Vec<T> b)
+    {
+        const Vec<T> s = signBit<T>();
+        return (a & ~s) | (b & s);
+    }
+};
+
+struct SignInjectNeg
+{
+    template <typename T>
+    static Vec<T>
+    vec(Vec<T> a, Vec<T> b)
+    {
+        const Vec<T> s = signBit<T>();
+        return (a & ~s) | (~b & s);
+    }
+};
+
+struct SignInjectXor
+{
+    template <typename T>
+    static Vec<T> vec(Vec<T> a, Vec<T> b) { return a ^ (b & signBit<T>()); }
+};
+
+} // namespace vsimd
+
+} // namespace RiscvISA
+} // namespace gem5
+
+#endif // __ARCH_RISCV_VECTOR_SIMD_HH__
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <type_traits>
+
+#include "arch/riscv/utility.hh"
+#include "arch/riscv/vector_simd.hh"
+#include "base/bitfield.hh"
+#include "base/cprintf.hh"
+
+using namespace gem5;
+using namespace gem5::RiscvISA;
+
+namespace
+{
+
+// Randomized differential test of the host SIMD kernels against the
+// element loops they replace. vector_simd_refs.inc holds, for every
+// micro-op the vector formats run on a kernel, the element loop and the
+// kernel call both built by the formats from the code of the decoder. The
+// same registers, vl, v0, vm and micro-op index go through both, and the
+// whole of vd must come out the same.
+
+constexpr int Rounds = 2000;
+
+/** The registers and fields a vector micro-op reads. */
+struct State
+{
+    alignas(16) uint8_t vd[VLENB];
+    alignas(16) uint8_t vs1[VLENB];
+    alignas(16) uint8_t vs2[VLENB];
+    alignas(16) uint8_t v0[VLENB];
+    uint64_t rs1;
+    uint64_t fs1;
+    uint64_t simm5;
+    uint64_t vl;
+    bool vm;
+    uint32_t microIdx;
+    // The elements of a micro-op of a widening instruction.
+    int32_t microVlmax;
+};
+
+/** A micro-op of vector_simd_refs.inc, on its own copy of a state. */
+template <typename ElemType>
+struct MicroOp : public State
+{
+    MicroOp(const State &state) : State(state) {}
+};
+
+// The declarations the execute templates of templates/vector_arith.isa
+// make before the code of a micro-op, on the state of the micro-op.
+#define VSIMD_REF_ENV(format) VSIMD_REF_ENV_##format
+
+#define VSIMD_REF_ENV_STATE \
+    using vu [[maybe_unused]] = std::make_unsigned_t<ElemType>; \
+    using vi [[maybe_unused]] = std::make_signed_t<ElemType>; \
+    [[maybe_unused]] const uint64_t rVl = this->vl; \
+    [[maybe_unused]] uint8_t *v0 = this->v0; \
+    [[maybe_unused]] const uint64_t SIMM5 = this->simm5
+
+#define VSIMD_REF_ENV_VectorIntFormat \
+    uint32_t elem_num_per_vreg = VLEN / (8 * sizeof(ElemType)); \
+    VSIMD_REF_ENV_STATE
+
+#define VSIMD_REF_ENV_VectorIntWideningFormat \
+    [[maybe_unused]] const int32_t micro_vlmax = this->microVlmax; \
+    [[maybe_unused]] const size_t offset = \
+        (this->microIdx % 2 == 0) ? 0 : micro_vlmax; \
+    uint32_t elem_num_per_vreg = micro_vlmax; \
+    VSIMD_REF_ENV_STATE; \
+    using vwu [[maybe_unused]] = typename double_width<vu>::type; \
+    using vwi [[maybe_unused]] = typename double_width<vi>::type
+
+#define VSIMD_REF_ENV_VectorIntMaskFormat \
+    const uint16_t bit_offset = VLEN / (8 * sizeof(ElemType)); \
+    [[maybe_unused]] const uint16_t offset = bit_offset * this->microIdx; \
+    uint32_t elem_num_per_vreg = VLEN / (8 * sizeof(ElemType)); \
+    VSIMD_REF_ENV_STATE
+
+#define VSIMD_REF_ENV_VectorFloatFormat \
+    using et = ElemType; \
+    using vu = decltype(et::v); \
+    uint32_t elem_num_per_vreg = VLEN / (8 * sizeof(vu)); \
+    [[maybe_unused]] const uint64_t rVl = this->vl; \
+    [[maybe_unused]] uint8_t *v0 = this->v0
+
+#include "arch/riscv/vector_simd_refs.inc"
+
+class VectorSimdTest : public testing::Test
+{
+  protected:
+    std::mt19937_64 rng{0x5eed};
+
+    /**
+     * Randomize a state for elements of elem_size bytes, sometimes with
+     * fewer elements than a register holds, like the micro-ops of
+     * widening instructions with a fractional LMUL.
+     */
+    State
+    randomize(size_t elem_size, bool widening)
+    {
+        State s;
+        for (auto *reg : {s.vd, s.vs1, s.vs2, s.v0}) {
+            for (size_t i = 0; i < VLENB; i++)
+                reg[i] = rng();
+        }
+        // Interesting values: all zeros, all ones, the sign bit alone, and
+        // the element of vs2, for the compares.
+        if (rng() % 2 == 0) {
+            for (size_t i = 0; i < VLENB; i += elem_size) {
+                const int kind = rng() % 4;
+                std::memset(s.vs1 + i, kind == 1 ? 0xff : 0, elem_size);
+                if (kind == 2)
+                    s.vs1[i + elem_size - 1] = 0x80;
+                else if (kind == 3)
+                    std::memcpy(s.vs1 + i, s.vs2 + i, elem_size);
+            }
+        }
+        s.rs1 = rng();
+        if (rng() % 4 == 0)
+            std::memcpy(&s.rs1, s.vs2 + elem_size * (rng() % 4), elem_size);
+        s.simm5 = rng() % 32;
+        // A single precision value is NaN-boxed in the 64 bit register,
+        // unless it is the canonical NaN.
+        s.fs1 = rng();
+        if (rng() % 4)
+            s.fs1 |= 0xffffffff00000000ULL;
+
+        const uint32_t full = VLENB / elem_size;
+        size_t n = full;
+        s.microIdx = rng() % 8;
+        s.microVlmax = 0;
+        if (widening) {
+            n = std::max<size_t>(1, (full / 2) >> (rng() % 3));
+            s.microVlmax = n;
+            if (n != full / 2)
+                s.microIdx = 0;
+        }
+        const size_t end = n * (s.microIdx + 1);
+        s.vl = rng() % 4 == 0 ? end + rng() % 8 : rng() % (end + 4);
+        s.vm = rng() % 2;
+        return s;
+    }
+
+    /** Run the element loop and the kernel of a micro-op, and compare. */
+    template <template <typename> class Inst, typename ElemType>
+    void
+    check(bool widening)
+    {
+        for (int round = 0; round < Rounds; round++) {
+            const State s = randomize(sizeof(ElemType), widening);
+            Inst<ElemType> scalar(s), simd(s);
+            scalar.scalar();
+            simd.simd();
+            if (std::memcmp(scalar.vd, simd.vd, VLENB) == 0)
+                continue;
+
+            std::string dump;
+            for (size_t i = 0; i < VLENB; i++)
+                dump += csprintf(" %02x/%02x", simd.vd[i], scalar.vd[i]);
+            ADD_FAILURE() << Inst<ElemType>::name << " of "
+                          << sizeof(ElemType) << " byte elements: micro-op "
+                          << s.microIdx << " vl " << s.vl << " vm " << s.vm
+                          << " micro_vlmax " << s.microVlmax
+                          << ", simd/scalar bytes of vd:" << dump;
+            return;
+        }
+    }
+
+    // The element types of the decode blocks of the formats.
+
+    template <template <typename> class Inst>
+    void
+    VectorIntFormat()
+    {
+        check<Inst, uint8_t>(false);
+        check<Inst, uint16_t>(false);
+        check<Inst, uint32_t>(false);
+        check<Inst, uint64_t>(false);
+    }
+
+    template <template <typename> class Inst>
+    void
+    VectorIntMaskFormat()
+    {
+        VectorIntFormat<Inst>();
+    }
+
+    template <template <typename> class Inst>
+    void
+    VectorIntWideningFormat()
+    {
+        check<Inst, uint8_t>(true);
+        check<Inst, uint16_t>(true);
+        check<Inst, uint32_t>(true);
+    }
+
+    template <template <typename> class Inst>
+    void
+    VectorFloatFormat()
+    {
+        check<Inst, float32_t>(false);
+        check<Inst, float64_t>(false);
+    }
+};
+
+} // anonymous namespace
+
+// One test for each micro-op of the decoder which runs on a kernel.
+#define VSIMD_REF_TEST(format, inst) \
+    TEST_F(VectorSimdTest, inst) { format<inst>(); }
+
+VSIMD_REF_INSTS(VSIMD_REF_TEST)
@@ -0,0 +1,330 @@
+#include "base/flight_recorder.hh"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+
+namespace gem5
+{
+
+namespace Trace
+{
+
+/**
+ * Messages of one flag and thread. Messages are laid out one after the
+ * other and wrap to the start of the buffer when the end is reached,
+ * dropping the oldest ones to make room.
+ */
+class FlightRecorder::Ring
+{
+  public:
+    struct Header
+    {
+        /** Bytes taken by the message, header included. */
+        uint32_t size;
+        uint32_t nameSize;
+        Tick when;
+        /** Tick and order the message was recorded at, to merge rings. */
+        Tick tick;
+        uint64_t seq;
+        const char *fmt;
+        Decoder decoder;
+    };
+
+    Ring(const std::string &_flag, unsigned _thread, size_t size)
+        : flag(_flag), thread(_thread), buffer(size)
+    {}
+
+    const std::string flag;
+    const unsigned thread;
+
+    std::mutex mutex;
+
+    char *
+    allocate(size_t size)
+    {
+        size = (size + alignof(Header) - 1) & ~(alignof(Header) - 1);
+        if (size > buffer.size())
+            return nullptr;
+
+        for (;;) {
+            if (!wrapped) {
+                if (tail + size <= buffer.size())
+                    break;
+                // Out of room at the end, go on from the start.
+                wrapEnd = tail;
+                tail = 0;
+                wrapped = true;
+                if (head == wrapEnd) {
+                    head = 0;
+                    wrapped = false;
+                }
+            } else {
+                if (tail + size <= head)
+                    break;
+                // Drop the oldest message.
+                head += header(head)->size;
+                if (head == wrapEnd) {
+                    head = 0;
+                    wrapped = false;
+                }
+            }
+        }
+
+        char *p = buffer.data() + tail;
+        reinterpret_cast<Header *>(p)->size = size;
+        tail += size;
+        return p;
+    }
+
+    template <typename F>
+    void
+    forEach(F f) const
+    {
+        if (wrapped) {
+            for (size_t pos = head; pos < wrapEnd; pos += header(pos)->size)
+                f(header(pos));
+            for (size_t pos = 0; pos < tail; pos += header(pos)->size)
+                f(header(pos));
+        } else {
+            for (size_t pos = head; pos < tail; pos += header(pos)->size)
+                f(header(pos));
+        }
+    }
+
+    void
+    clear()
+    {
+        head = tail = wrapEnd = 0;
+        wrapped = false;
+    }
+
+    void
+    resize(size_t size)
+    {
+        buffer.resize(size);
+        buffer.shrink_to_fit();
+        clear();
+    }
+
+  private:
+    Header *
+    header(size_t pos)
+    {
+        return reinterpret_cast<Header *>(buffer.data() + pos);
+    }
+
+    const Header *
+    header(size_t pos) const
+    {
+        return reinterpret_cast<const Header *>(buffer.data() + pos);
+    }
+
+    std::vector<char> buffer;
+
+    /** Oldest message. */
+    size_t head = 0;
+    /** Where the next message goes. */
+    size_t tail = 0;
+    /** End of the messages before the start of the buffer was reused. */
+    size_t wrapEnd = 0;
+    bool wrapped = false;
+};
+
+namespace
+{
+
+/** Rings of a thread, found by the address of the flag name. */
+struct ThreadRings
+{
+    unsigned index;
+    uint64_t seq = 0;
+    std::unordered_map<const char *, FlightRecorder::Ring *> byAddr;
+    std::map<std::string, FlightRecorder::Ring *> byName;
+};
+
+thread_local ThreadRings *threadRings = nullptr;
+
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadRings>> threads;
+std::vector<std::unique_ptr<FlightRecorder::Ring>> rings;
+size_t ringSize = 0;
+
+} // anonymous namespace
+
+void
+FlightRecorder::enable(size_t ring_size)
+{
+    fatal_if(ring_size < 1024,
+             "Debug flight recorder rings must be at least 1KiB\n");
+
+    std::lock_guard<std::mutex> registry_lock(registryMutex);
+    ringSize = ring_size;
+    for (auto &ring : rings) {
+        std::lock_guard<std::mutex> lock(ring->mutex);
+        ring->resize(ringSize);
+    }
+    _enabled = true;
+}
+
+void
+FlightRecorder::disable()
+{
+    _enabled = false;
+
+    std::lock_guard<std::mutex> registry_lock(registryMutex);
+    for (auto &ring : rings) {
+        std::lock_guard<std::mutex> lock(ring->mutex);
+        ring->clear();
+    }
+}
+
+FlightRecorder::Ring *
+FlightRecorder::getRing(const char *flag)
+{
+    if (GEM5_UNLIKELY(!threadRings)) {
+        std::lock_guard<std::mutex> registry_lock(registryMutex);
+        threads.emplace_back(new ThreadRings);
+        threadRings = threads.back().get();
+        threadRings->index = threads.size() - 1;
+    }
+
+    Ring *&ring = threadRings->byAddr[flag];
+    if (GEM5_UNLIKELY(!ring)) {
+        // The same flag name can live at different addresses in different
+        // object files.
+        Ring *&named = threadRings->byName[flag];
+        if (!named) {
+            std::lock_guard<std::mutex> registry_lock(registryMutex);
+            rings.emplace_back(
+                new Ring(flag, threadRings->index, ringSize));
+            named = rings.back().get();
+        }
+        ring = named;
+    }
+
+    ring->mutex.lock();
+    return ring;
+}
+
+char *
+FlightRecorder::allocate(Ring *ring, Tick when, const std::string &name,
+                         const char *fmt, Decoder decoder, size_t args_size)
+{
+    char *p = ring->allocate(sizeof(Ring::Header) + name.size() + args_size);
+    if (!p)
+        return nullptr;
+
+    auto *header = reinterpret_cast<Ring::Header *>(p);
+    header->nameSize = name.size();
+    header->when = when;
+    header->tick = curTick();
+    header->seq = threadRings->seq++;
+    header->fmt = fmt;
+    header->decoder = decoder;
+
+    p += sizeof(Ring::Header);
+    std::memcpy(p, name.data(), name.size());
+    return p + name.size();
+}
+
+void
+FlightRecorder::release(Ring *ring)
+{
+    ring->mutex.unlock();
+}
+
+namespace
+{
+
+/** Visit the recorded messages of all rings, oldest first, and drop them. */
+template <typename F>
+void
+drain(F f)
+{
+    using Header = FlightRecorder::Ring::Header;
+
+    std::lock_guard<std::mutex> registry_lock(registryMutex);
+    std::vector<std::unique_lock<std::mutex>> locks;
+    for (auto &ring : rings)
+        locks.emplace_back(ring->mutex);
+
+    struct Message
+    {
+        const Header *header;
+        const FlightRecorder::Ring *ring;
+    };
+    std::vector<Message> messages;
+    for (const auto &ring : rings) {
+        ring->forEach([&](const Header *header) {
+            messages.push_back({header, ring.get()});
+        });
+    }
+
+    std::stable_sort(messages.begin(), messages.end(),
+        [](const Message &a, const Message &b) {
+            if (a.header->tick != b.header->tick)
+                return a.header->tick < b.header->tick;
+            if (a.ring->thread != b.ring->thread)
+                return a.ring->thread < b.ring->thread;
+            return a.header->seq < b.header->seq;
+        });
+
+    for (const auto &msg : messages) {
+        const char *p = reinterpret_cast<const char *>(msg.header + 1);
+        std::string name(p, msg.header->nameSize);
+        f(msg.header, name, msg.ring->flag, p + msg.header->nameSize);
+    }
+
+    for (auto &ring : rings)
+        ring->clear();
+}
+
+} // anonymous namespace
+
+void
+FlightRecorder::dump(const std::string &reason)
+{
+    Logger *logger = getDebugLogger();
+    std::ostream &os = logger->getOstream();
+    bool empty = true;
+
+    drain([&](const Ring::Header *header, const std::string &name,
+              const std::string &flag, const char *args) {
+        if (empty) {
+            ccprintf(os, "---- debug flight recorder: %s ----\n", reason);
+            empty = false;
+        }
+        std::ostringstream msg;
+        header->decoder(msg, header->fmt, args);
+        logger->logMessage(header->when, name, flag, msg.str());
+    });
+
+    if (!empty)
+        ccprintf(os, "---- end of debug flight recorder ----\n");
+    os.flush();
+}
+
+void
+FlightRecorder::dump(std::ostream &os)
+{
+    drain([&](const Ring::Header *header, const std::string &name,
+              const std::string &flag, const char *args) {
+        if (header->when != MaxTick)
+            ccprintf(os, "%7d: ", header->when);
+        if (!flag.empty())
+            os << flag << ": ";
+        if (!name.empty())
+            os << name << ": ";
+        header->decoder(os, header->fmt, args);
+    });
+}
+
+} // namespace Trace
+} // namespace gem5
@@ -0,0 +1,221 @@
+#ifndef __BASE_FLIGHT_RECORDER_HH__
+#define __BASE_FLIGHT_RECORDER_HH__
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "base/compiler.hh"
+#include "base/cprintf.hh"
+#include "base/types.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+namespace Trace
+{
+
+/**
+ * Flight recorder mode of the debug output.
+ *
+ * When enabled, debug messages are not formatted. Each message keeps its
+ * format string and raw arguments in an in-memory ring, one per debug flag
+ * and host thread, so the oldest messages of a chatty flag are dropped
+ * without losing those of a quiet one. The rings are only formatted,
+ * oldest message first, through the debug logger when dump() is called:
+ * on an abort, a difftest mismatch, or at a tick or pc picked by the user.
+ *
+ * Arithmetic, enum and pointer arguments are copied as they are, strings
+ * are copied, and other arguments are printed to a string right away.
+ */
+class FlightRecorder
+{
+  public:
+    /** Whether messages go to the rings instead of the debug logger. */
+    static bool enabled() { return _enabled; }
+
+    /**
+     * Start recording, keeping up to ring_size bytes of messages per debug
+     * flag and thread.
+     */
+    static void enable(size_t ring_size);
+
+    /** Stop recording, dropping the recorded messages. */
+    static void disable();
+
+    /** Pc whose commit dumps the rings, MaxAddr for none. */
+    static Addr triggerPC() { return _triggerPC; }
+    static void setTriggerPC(Addr pc) { _triggerPC = pc; }
+
+    /**
+     * Print the recorded messages to the debug logger, between two lines
+     * naming the reason of the dump, and empty the rings.
+     */
+    static void dump(const std::string &reason);
+
+    /** Print the recorded messages to os, without the logger. */
+    static void dump(std::ostream &os);
+
+    template <typename ...Args>
+    static void
+    record(Tick when, const std::string &name, const char *flag,
+           const char *fmt, const Args &...args)
+    {
+        auto captured = std::make_tuple(capture(args)...);
+        const size_t args_size = std::apply(
+            [](const auto &...arg) { return (size_t(0) + ... + arg.size()); },
+            captured);
+
+        Ring *ring = getRing(flag);
+        char *p = allocate(ring, when, name, fmt, &decode<Args...>,
+                           args_size);
+        if (p) {
+            std::apply([&p](const auto &...arg) { (arg.write(p), ...); },
+                       captured);
+        }
+        release(ring);
+    }
+
+    /** Buffer of the messages of a flag, see flight_recorder.cc. */
+    class Ring;
+
+  private:
+    using Decoder = void (*)(std::ostream &os, const char *fmt,
+                             const char *args);
+
+    /** Arguments kept as they are. */
+    template <typename T>
+    struct Raw
+    {
+        T value;
+        size_t size() const { return sizeof(T); }
+        void
+        write(char *&p) const
+        {
+            std::memcpy(p, &value, sizeof(T));
+            p += sizeof(T);
+        }
+    };
+
+    /** String arguments, copied to the ring. */
+    struct Str
+    {
+        std::string_view str;
+        size_t size() const { return sizeof(uint32_t) + str.size(); }
+        void
+        write(char *&p) const
+        {
+            const uint32_t len = str.size();
+            std::memcpy(p, &len, sizeof(len));
+            std::memcpy(p + sizeof(len), str.data(), len);
+            p += sizeof(len) + len;
+        }
+    };
+
+    /** Other arguments, printed when recorded. */
+    struct Printed : public Str
+    {
+        std::string printed;
+        Printed(std::string s) : printed(std::move(s)) { str = printed; }
+        Printed(const Printed &other) : Printed(other.printed) {}
+    };
+
+    template <typename T>
+    static constexpr bool isCharPointer = std::is_pointer_v<T> &&
+        (std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char> ||
+         std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>,
+                        signed char> ||
+         std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>,
+                        unsigned char>);
+
+    template <typename T>
+    static constexpr bool isRaw = std::is_arithmetic_v<T> ||
+        std::is_enum_v<T> || std::is_null_pointer_v<T> ||
+        (std::is_pointer_v<T> && !isCharPointer<T>);
+
+    template <typename T>
+    static constexpr bool isStr = std::is_same_v<T, std::string> ||
+        std::is_same_v<T, std::string_view> ||
+        std::is_same_v<std::decay_t<T>, char *> ||
+        std::is_same_v<std::decay_t<T>, const char *>;
+
+    template <typename T>
+    static auto
+    capture(const T &arg)
+    {
+        if constexpr (isRaw<T>) {
+            return Raw<T>{arg};
+        } else if constexpr (isStr<T>) {
+            if constexpr (std::is_same_v<std::decay_t<T>, char *> ||
+                          std::is_same_v<std::decay_t<T>, const char *>) {
+                return Str{arg ? std::string_view(arg) : "(null)"};
+            } else {
+                return Str{arg};
+            }
+        } else {
+            std::ostringstream os;
+            os << arg;
+            return Printed(os.str());
+        }
+    }
+
+    /** The type an argument of type T is decoded to. */
+    template <typename T>
+    using Decoded = std::conditional_t<isRaw<T>, T, std::string>;
+
+    template <typename T>
+    static Decoded<T>
+    read(const char *&p)
+    {
+        if constexpr (isRaw<T>) {
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return value;
+        } else {
+            uint32_t len;
+            std::memcpy(&len, p, sizeof(len));
+            std::string str(p + sizeof(len), len);
+            p += sizeof(len) + len;
+            return str;
+        }
+    }
+
+    template <typename ...Args>
+    static void
+    decode(std::ostream &os, const char *fmt, const char *p)
+    {
+        // Braced initialization reads the arguments in order.
+        std::tuple<Decoded<Args>...> args{read<Args>(p)...};
+        std::apply([&](const auto &...arg) { ccprintf(os, fmt, arg...); },
+                   args);
+    }
+
+    /** The ring of flag for this thread, locked. */
+    static Ring *getRing(const char *flag);
+
+    /**
+     * Make room for a message in a ring and fill in everything but the
+     * arguments, returning where the args_size bytes of arguments go.
+     */
+    static char *allocate(Ring *ring, Tick when, const std::string &name,
+                          const char *fmt, Decoder decoder,
+                          size_t args_size);
+
+    /** Unlock a ring taken with getRing(). */
+    static void release(Ring *ring);
+
+    static inline bool _enabled = false;
+    static inline Addr _triggerPC = MaxAddr;
+};
+
+} // namespace Trace
+} // namespace gem5
+
+#endif // __BASE_FLIGHT_RECORDER_HH__
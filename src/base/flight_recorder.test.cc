@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "base/flight_recorder.hh"
+#include "base/gtest/cur_tick_fake.hh"
+#include "base/trace.hh"
+
+using namespace gem5;
+
+GTestTickHandler tickHandler;
+
+namespace
+{
+
+struct Printable
+{
+    int value;
+};
+
+std::ostream &
+operator<<(std::ostream &os, const Printable &p)
+{
+    return os << "P(" << p.value << ")";
+}
+
+enum Color { Red, Green };
+
+std::string
+drain()
+{
+    std::ostringstream os;
+    Trace::FlightRecorder::dump(os);
+    return os.str();
+}
+
+} // anonymous namespace
+
+/** Messages are formatted only when dumped, as the logger would. */
+TEST(FlightRecorderTest, RecordAndDump)
+{
+    Trace::FlightRecorder::enable(4096);
+    std::stringstream ss;
+    Trace::OstreamLogger logger(ss);
+
+    tickHandler.setCurTick(10);
+    std::string temp = "temporary";
+    logger.dprintf_flag(Tick(10), "cpu", "Fetch", "pc %#x sn %d %s\n",
+                        0x80000000, 7, temp.c_str());
+    temp = "overwritten";
+    logger.dprintf_flag(Tick(10), "cpu", "Fetch", "%s %c %d %.2f\n",
+                        Printable{3}, 'x', Green, 1.5);
+    logger.dprintf_flag(MaxTick, "", "Fetch", "raw %s\n",
+                        std::string("line"));
+
+    EXPECT_EQ(ss.str(), "");
+    EXPECT_EQ(drain(),
+              "     10: Fetch: cpu: pc 0x80000000 sn 7 temporary\n"
+              "     10: Fetch: cpu: P(3) x 1 1.50\n"
+              "Fetch: raw line\n");
+    // Dumping empties the rings.
+    EXPECT_EQ(drain(), "");
+
+    Trace::FlightRecorder::disable();
+}
+
+/** A full ring drops its oldest messages, other flags keep theirs. */
+TEST(FlightRecorderTest, RingWraps)
+{
+    Trace::FlightRecorder::enable(1024);
+    std::stringstream ss;
+    Trace::OstreamLogger logger(ss);
+
+    tickHandler.setCurTick(1);
+    logger.dprintf_flag(Tick(1), "a", "Quiet", "kept\n");
+    for (int i = 0; i < 1000; i++) {
+        tickHandler.setCurTick(2 + i);
+        logger.dprintf_flag(Tick(2 + i), "b", "Chatty", "msg %d\n", i);
+    }
+
+    const std::string out = drain();
+    EXPECT_EQ(out.find("      1: Quiet: a: kept\n"), 0);
+    EXPECT_EQ(out.find("msg 0\n"), std::string::npos);
+    EXPECT_NE(out.find("   1001: Chatty: b: msg 999\n"), std::string::npos);
+
+    // The chatty messages that are left are the newest, in order.
+    int last = -1;
+    size_t count = 0;
+    for (size_t pos = out.find("msg "); pos != std::string::npos;
+         pos = out.find("msg ", pos + 1)) {
+        int i = std::stoi(out.substr(pos + 4));
+        EXPECT_EQ(i, last == -1 ? i : last + 1);
+        last = i;
+        count++;
+    }
+    EXPECT_EQ(last, 999);
+    EXPECT_GT(count, 5);
+    EXPECT_LT(count, 1000);
+
+    Trace::FlightRecorder::disable();
+}
+
+/** Messages of different threads are merged by tick. */
+TEST(FlightRecorderTest, Threads)
+{
+    Trace::FlightRecorder::enable(4096);
+    std::stringstream ss;
+    Trace::OstreamLogger logger(ss);
+
+    tickHandler.setCurTick(5);
+    logger.dprintf_flag(Tick(5), "main", "Flag", "second\n");
+
+    std::thread other([&]() {
+        GTestTickHandler handler;
+        handler.setCurTick(3);
+        logger.dprintf_flag(Tick(3), "other", "Flag", "first\n");
+    });
+    other.join();
+
+    EXPECT_EQ(drain(), "      3: Flag: other: first\n"
+                       "      5: Flag: main: second\n");
+
+    Trace::FlightRecorder::disable();
+}
+
+/** With the recorder off messages go straight to the logger. */
+TEST(FlightRecorderTest, Disabled)
+{
+    std::stringstream ss;
+    Trace::OstreamLogger logger(ss);
+
+    EXPECT_FALSE(Trace::FlightRecorder::enabled());
+    logger.dprintf_flag(Tick(100), "Foo", "", "Test %s\n", "message");
+    EXPECT_EQ(ss.str(), "    100: Foo: Test message\n");
+    EXPECT_EQ(drain(), "");
+}
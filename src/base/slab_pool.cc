@@ -0,0 +1,159 @@
+#include "base/slab_pool.hh"
+
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace gem5
+{
+
+namespace
+{
+
+struct FreeNode
+{
+    FreeNode *next;
+};
+
+constexpr size_t NumClasses = SlabPool::MaxSize / SlabPool::Granule;
+
+struct FreeList
+{
+    FreeNode *head = nullptr;
+    size_t count = 0;
+};
+
+/** Objects moved between the threads, a slab's worth at a time. */
+struct Batch
+{
+    FreeNode *head;
+    size_t count;
+};
+
+struct Depot
+{
+    std::mutex mutex;
+    std::vector<Batch> batches;
+};
+
+/**
+ * The depots live until the end of the process, objects can be freed by
+ * the destructors of other static objects.
+ */
+Depot *
+depots()
+{
+    static Depot *depots = new Depot[NumClasses];
+    return depots;
+}
+
+/** Take up to count objects off a free list. */
+Batch
+take(FreeList &list, size_t count)
+{
+    Batch batch{list.head, 0};
+    FreeNode *last = nullptr;
+    while (batch.count < count && list.head) {
+        last = list.head;
+        list.head = list.head->next;
+        batch.count++;
+    }
+    if (last)
+        last->next = nullptr;
+    list.count -= batch.count;
+    return batch;
+}
+
+void
+give(size_t cls, const Batch &batch)
+{
+    if (!batch.count)
+        return;
+    Depot &depot = depots()[cls];
+    std::lock_guard<std::mutex> lock(depot.mutex);
+    depot.batches.push_back(batch);
+}
+
+struct ThreadCache
+{
+    FreeList lists[NumClasses];
+
+    /** Hand the free objects of an exiting thread to the others. */
+    ~ThreadCache()
+    {
+        for (size_t cls = 0; cls < NumClasses; cls++)
+            give(cls, take(lists[cls], lists[cls].count));
+    }
+};
+
+thread_local ThreadCache cache;
+
+size_t
+sizeClass(size_t size)
+{
+    return (size + SlabPool::Granule - 1) / SlabPool::Granule - 1;
+}
+
+void
+refill(size_t cls, FreeList &list)
+{
+    Depot &depot = depots()[cls];
+    {
+        std::lock_guard<std::mutex> lock(depot.mutex);
+        if (!depot.batches.empty()) {
+            list.head = depot.batches.back().head;
+            list.count = depot.batches.back().count;
+            depot.batches.pop_back();
+            return;
+        }
+    }
+
+    // Slabs are never given back, objects come and go all along.
+    const size_t obj_size = (cls + 1) * SlabPool::Granule;
+    char *slab = static_cast<char *>(
+        ::operator new(obj_size * SlabPool::SlabSize));
+    for (size_t i = 0; i < SlabPool::SlabSize; i++) {
+        auto *node = reinterpret_cast<FreeNode *>(slab + i * obj_size);
+        node->next = list.head;
+        list.head = node;
+    }
+    list.count = SlabPool::SlabSize;
+}
+
+} // anonymous namespace
+
+void *
+SlabPool::allocate(size_t size)
+{
+    if (size == 0 || size > MaxSize)
+        return ::operator new(size);
+
+    const size_t cls = sizeClass(size);
+    FreeList &list = cache.lists[cls];
+    if (!list.head)
+        refill(cls, list);
+
+    FreeNode *node = list.head;
+    list.head = node->next;
+    list.count--;
+    return node;
+}
+
+void
+SlabPool::deallocate(void *p, size_t size)
+{
+    if (size == 0 || size > MaxSize) {
+        ::operator delete(p);
+        return;
+    }
+
+    const size_t cls = sizeClass(size);
+    auto *node = static_cast<FreeNode *>(p);
+    FreeList &list = cache.lists[cls];
+    node->next = list.head;
+    list.head = node;
+    if (++list.count > MaxCached)
+        give(cls, take(list, SlabSize));
+}
+
+} // namespace gem5
@@ -0,0 +1,77 @@
+#ifndef __BASE_SLAB_POOL_HH__
+#define __BASE_SLAB_POOL_HH__
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace gem5
+{
+
+/**
+ * Slab pool of the memory of small objects that are created and dropped
+ * all the time, such as packets, requests and Ruby messages.
+ *
+ * The memory is kept in per-thread free lists, one per size rounded up to
+ * 16 bytes. An object freed by another thread than the one that allocated
+ * it goes to the free list of the thread that frees it. A list that grows
+ * past MaxCached objects hands a slab's worth of them to a shared depot,
+ * and so do the lists of a thread that exits. An empty list is refilled
+ * from the depot, or else with a new slab. Objects larger than MaxSize go
+ * to the heap.
+ */
+class SlabPool
+{
+  public:
+    static constexpr size_t Granule = 16;
+    static constexpr size_t MaxSize = 2048;
+    static constexpr size_t SlabSize = 64;
+    static constexpr size_t MaxCached = 2 * SlabSize;
+
+    static void *allocate(size_t size);
+    static void deallocate(void *p, size_t size);
+};
+
+/** Allocator for std::allocate_shared of objects from the SlabPool. */
+template <typename T>
+class SlabAllocator
+{
+  public:
+    typedef T value_type;
+
+    SlabAllocator() = default;
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U> &) {}
+
+    T *
+    allocate(size_t n)
+    {
+        return static_cast<T *>(SlabPool::allocate(n * sizeof(T)));
+    }
+
+    void
+    deallocate(T *p, size_t n)
+    {
+        SlabPool::deallocate(p, n * sizeof(T));
+    }
+
+    template <typename U>
+    bool operator==(const SlabAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const SlabAllocator<U> &) const { return false; }
+};
+
+/** Create an object, and its reference count, from the SlabPool. */
+template <typename T, typename ...Args>
+std::shared_ptr<T>
+makeSlabShared(Args &&...args)
+{
+    static_assert(alignof(T) <= SlabPool::Granule,
+                  "Objects must fit the alignment of the pool");
+    return std::allocate_shared<T>(SlabAllocator<T>(),
+                                   std::forward<Args>(args)...);
+}
+
+} // namespace gem5
+
+#endif // __BASE_SLAB_POOL_HH__
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "base/slab_pool.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+struct Counted
+{
+    static int live;
+    uint64_t payload[5];
+
+    explicit Counted(uint64_t v) { payload[0] = v; live++; }
+    ~Counted() { live--; }
+};
+
+int Counted::live = 0;
+
+} // anonymous namespace
+
+/** A freed object is handed out again for the same size class. */
+TEST(SlabPoolTest, ReuseInSizeClass)
+{
+    void *p = SlabPool::allocate(40);
+    SlabPool::deallocate(p, 40);
+    void *q = SlabPool::allocate(48);
+    EXPECT_EQ(p, q);
+    SlabPool::deallocate(q, 48);
+}
+
+/** Sizes of different classes do not share memory. */
+TEST(SlabPoolTest, DistinctSizeClasses)
+{
+    void *p = SlabPool::allocate(16);
+    SlabPool::deallocate(p, 16);
+    void *q = SlabPool::allocate(17);
+    EXPECT_NE(p, q);
+    SlabPool::deallocate(q, 17);
+}
+
+/** Live objects never overlap, across slabs. */
+TEST(SlabPoolTest, NoOverlap)
+{
+    const size_t size = 100;
+    std::vector<char *> objs;
+    for (size_t i = 0; i < SlabPool::SlabSize * 3; i++) {
+        char *p = static_cast<char *>(SlabPool::allocate(size));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % SlabPool::Granule, 0);
+        std::memset(p, int(i), size);
+        objs.push_back(p);
+    }
+    for (size_t i = 0; i < objs.size(); i++) {
+        for (size_t b = 0; b < size; b++)
+            ASSERT_EQ(objs[i][b], char(i));
+    }
+    std::set<char *> unique(objs.begin(), objs.end());
+    EXPECT_EQ(unique.size(), objs.size());
+    for (char *p : objs)
+        SlabPool::deallocate(p, size);
+}
+
+/** Empty and large objects go to the heap. */
+TEST(SlabPoolTest, HeapSizes)
+{
+    void *empty = SlabPool::allocate(0);
+    EXPECT_NE(empty, nullptr);
+    SlabPool::deallocate(empty, 0);
+
+    const size_t large = SlabPool::MaxSize + 1;
+    char *p = static_cast<char *>(SlabPool::allocate(large));
+    std::memset(p, 0x5a, large);
+    SlabPool::deallocate(p, large);
+}
+
+/** Objects freed by another thread are reused by that thread. */
+TEST(SlabPoolTest, OtherThreadFree)
+{
+    void *p = SlabPool::allocate(64);
+    std::thread([p]() {
+        SlabPool::deallocate(p, 64);
+        void *q = SlabPool::allocate(64);
+        EXPECT_EQ(p, q);
+        SlabPool::deallocate(q, 64);
+    }).join();
+}
+
+/**
+ * Objects allocated by one thread and freed by another come back through
+ * the depot, rather than piling up in the lists of the freeing thread.
+ */
+TEST(SlabPoolTest, RemoteFreesAreBounded)
+{
+    const size_t size = 200;
+    const int rounds = 50;
+    std::vector<void *> objs(1000);
+    std::atomic<int> phase(0);
+
+    std::thread freer([&]() {
+        for (int round = 0; round < rounds; round++) {
+            while (phase.load() != 2 * round + 1)
+                std::this_thread::yield();
+            for (void *p : objs)
+                SlabPool::deallocate(p, size);
+            phase.store(2 * round + 2);
+        }
+    });
+
+    std::set<void *> seen;
+    for (int round = 0; round < rounds; round++) {
+        for (void *&p : objs) {
+            p = SlabPool::allocate(size);
+            seen.insert(p);
+        }
+        phase.store(2 * round + 1);
+        while (phase.load() != 2 * round + 2)
+            std::this_thread::yield();
+    }
+    freer.join();
+
+    EXPECT_LE(seen.size(), objs.size() + 2 * SlabPool::MaxCached);
+}
+
+/** The free objects of a thread that exits go to the other threads. */
+TEST(SlabPoolTest, ThreadExit)
+{
+    const size_t size = 300;
+    std::set<void *> freed;
+    std::thread([&freed]() {
+        for (int i = 0; i < 10; i++) {
+            void *p = SlabPool::allocate(size);
+            freed.insert(p);
+            SlabPool::deallocate(p, size);
+        }
+    }).join();
+
+    void *p = SlabPool::allocate(size);
+    EXPECT_EQ(freed.count(p), 1);
+    SlabPool::deallocate(p, size);
+}
+
+TEST(SlabPoolTest, MakeSlabShared)
+{
+    {
+        auto a = makeSlabShared<Counted>(7);
+        std::shared_ptr<Counted> b = a;
+        EXPECT_EQ(Counted::live, 1);
+        EXPECT_EQ(b->payload[0], 7);
+        EXPECT_EQ(a.use_count(), 2);
+    }
+    EXPECT_EQ(Counted::live, 0);
+
+    // The control block and object come back from the pool.
+    Counted *first = makeSlabShared<Counted>(1).get();
+    Counted *second = makeSlabShared<Counted>(2).get();
+    EXPECT_EQ(first, second);
+}
@@ -105,9 +105,22 @@ class InfoProxy : public Base
     InfoProxy(Stat &stat) : s(stat) {}
 
     bool check() const { return s.check(); }
-    void prepare() { s.prepare(); }
+    void
+    prepare()
+    {
+        if (!this->disabled())
+            s.prepare();
+    }
     void reset() { s.reset(); }
     void
+    disable()
+    {
+        if (this->disabled())
+            return;
+        Base::disable();
+        s.disable();
+    }
+    void
     visit(Output &visitor)
     {
         visitor.visit(*static_cast<Base *>(this));
@@ -160,6 +173,8 @@ class DistInfoProxy : public InfoProxy<Stat, DistInfo>
 {
   public:
     DistInfoProxy(Stat &stat) : InfoProxy<Stat, DistInfo>(stat) {}
+
+    void samplePeriod(unsigned period) { this->s.samplePeriod(period); }
 };
 
 template <class Stat>
@@ -222,8 +237,43 @@ class InfoAccess
      * @return true for success
      */
     bool check() const { return true; }
+
+    /**
+     * Release what the stat does not need once it has been filtered out.
+     */
+    void disable() { }
 };
 
+/**
+ * Let all entries of a disabled vector stat share one storage object,
+ * so that updates still have somewhere to go without keeping the
+ * storage of every entry.
+ */
+template <class Storage>
+void
+shareStorage(std::vector<Storage *> &storage, const StorageParams *params)
+{
+    if (storage.size() < 2)
+        return;
+    for (auto &stor : storage)
+        delete stor;
+    Storage *sink = new Storage(params);
+    std::fill(storage.begin(), storage.end(), sink);
+}
+
+/** Free the storage of a vector stat, shared or not. */
+template <class Storage>
+void
+deleteStorage(std::vector<Storage *> &storage)
+{
+    if (!storage.empty() && storage.front() == storage.back()) {
+        delete storage.front();
+        return;
+    }
+    for (auto &stor : storage)
+        delete stor;
+}
+
 template <class Derived, template <class> class InfoProxyType>
 class DataWrap : public InfoAccess
 {
@@ -1024,11 +1074,12 @@ class VectorBase : public DataWrapVec<Derived, VectorInfoProxy>
           storage()
     {}
 
-    ~VectorBase()
+    ~VectorBase() { deleteStorage(storage); }
+
+    void
+    disable()
     {
-        for (auto& stor : storage) {
-            delete stor;
-        }
+        shareStorage(storage, this->info()->getStorageParams());
     }
 
     /**
@@ -1163,11 +1214,12 @@ class Vector2dBase : public DataWrapVec2d<Derived, Vector2dInfoProxy>
           x(0), y(0), storage()
     {}
 
-    ~Vector2dBase()
+    ~Vector2dBase() { deleteStorage(storage); }
+
+    void
+    disable()
     {
-        for (auto& stor : storage) {
-            delete stor;
-        }
+        shareStorage(storage, this->info()->getStorageParams());
     }
 
     Derived &
@@ -1282,6 +1334,13 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
     /** The storage for this stat. */
     GEM5_ALIGNED(8) char storage[sizeof(Storage)];
 
+    /**
+     * Samples are recorded every period-th call, 0 if the stat is
+     * disabled.
+     */
+    unsigned period = 1;
+    unsigned countdown = 1;
+
   protected:
     /**
      * Retrieve the storage.
@@ -1325,7 +1384,37 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
      * @param n The number of times to add it, defaults to 1.
      */
     template <typename U>
-    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+    void
+    sample(const U &v, int n = 1)
+    {
+        if (GEM5_UNLIKELY(period != 1)) {
+            if (period == 0 || --countdown)
+                return;
+            countdown = period;
+            n *= period;
+        }
+        data()->sample(v, n);
+    }
+
+    /**
+     * Only record every period-th sample, with a weight of period, to cut
+     * the cost of distributions that are sampled very often. Counts, sums
+     * and buckets become estimates, min and max only cover the recorded
+     * samples.
+     * @param _period The sampling period, 1 records every sample.
+     * @return A reference to this stat.
+     */
+    Derived &
+    samplePeriod(unsigned _period)
+    {
+        fatal_if(_period == 0, "Sampling period of %s must be positive",
+                 this->name());
+        period = _period;
+        countdown = _period;
+        return this->self();
+    }
+
+    void disable() { period = 0; }
 
     /**
      * Return the number of entries in this stat.
@@ -1411,11 +1500,12 @@ class VectorDistBase : public DataWrapVec<Derived, VectorDistInfoProxy>
           storage()
     {}
 
-    ~VectorDistBase()
+    ~VectorDistBase() { deleteStorage(storage); }
+
+    void
+    disable()
     {
-        for (auto& stor : storage) {
-            delete stor;
-        }
+        shareStorage(storage, this->info()->getStorageParams());
     }
 
     Proxy operator[](off_type index)
@@ -1951,6 +2041,35 @@ class Scalar : public ScalarBase<Scalar, StatStor>
     }
 };
 
+/**
+ * A scalar that can be updated concurrently from several simulation
+ * threads, see ThreadStatStor.
+ * @sa Stat, ScalarBase, ThreadStatStor
+ */
+class ThreadScalar : public ScalarBase<ThreadScalar, ThreadStatStor>
+{
+  public:
+    using ScalarBase<ThreadScalar, ThreadStatStor>::operator=;
+
+    ThreadScalar(Group *parent = nullptr)
+        : ScalarBase<ThreadScalar, ThreadStatStor>(
+                parent, nullptr, units::Unspecified::get(), nullptr)
+    {
+    }
+
+    ThreadScalar(Group *parent, const char *name, const char *desc = nullptr)
+        : ScalarBase<ThreadScalar, ThreadStatStor>(
+                parent, name, units::Unspecified::get(), desc)
+    {
+    }
+
+    ThreadScalar(Group *parent, const char *name, const units::Base *unit,
+                 const char *desc = nullptr)
+        : ScalarBase<ThreadScalar, ThreadStatStor>(parent, name, unit, desc)
+    {
+    }
+};
+
 /**
  * A stat that calculates the per tick average of a value.
  * @sa Stat, ScalarBase, AvgStor
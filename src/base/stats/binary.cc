@@ -0,0 +1,385 @@
+#include "base/stats/binary.hh"
+
+#include <cassert>
+#include <cstring>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+#include "base/stats/units.hh"
+#include "config/have_zstd.hh"
+#include "sim/cur_tick.hh"
+
+#if HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+void
+Binary::Buffer::put(const std::string &str)
+{
+    put<uint32_t>(str.size());
+    bytes.insert(bytes.end(), str.begin(), str.end());
+}
+
+void
+Binary::Buffer::put(const std::vector<std::string> &strs)
+{
+    put<uint32_t>(strs.size());
+    for (const auto &str : strs)
+        put(str);
+}
+
+Binary::Binary(const std::string &file, bool _delta, bool _compress)
+    : delta(_delta), compress(_compress && HAVE_ZSTD),
+      stream(file, std::ios::binary | std::ios::trunc), haveLast(false)
+{
+    if (!valid())
+        fatal("Unable to open statistics file '%s' for writing\n", file);
+    warn_if(_compress && !HAVE_ZSTD,
+            "gem5 was built without zstd, binary stats are not compressed\n");
+
+    stream.write("GEM5STB1", 8);
+    stream.write(reinterpret_cast<const char *>(&version), sizeof(version));
+}
+
+bool
+Binary::valid() const
+{
+    return stream.good();
+}
+
+void
+Binary::begin()
+{
+    entries.clear();
+    values.clear();
+    sparse.bytes.clear();
+}
+
+void
+Binary::end()
+{
+    if (schemaChanged()) {
+        writeSchema();
+        haveLast = false;
+    }
+    writeDump();
+    stream.flush();
+
+    lastValues.swap(values);
+    haveLast = true;
+}
+
+void
+Binary::beginGroup(const char *name)
+{
+    if (path.empty())
+        path.push(name);
+    else
+        path.push(csprintf("%s.%s", path.top(), name));
+}
+
+void
+Binary::endGroup()
+{
+    assert(!path.empty());
+    path.pop();
+}
+
+std::string
+Binary::statName(const std::string &name) const
+{
+    if (path.empty())
+        return name;
+    else
+        return csprintf("%s.%s", path.top(), name);
+}
+
+Binary::Entry &
+Binary::addEntry(const Info &info, Kind kind, size_t num_values)
+{
+    // Hidden stats never show up in stats.txt, stats hidden by a prereq
+    // keep their place but their values are not computed.
+    const bool visible = !(info.prereq && info.prereq->zero());
+    entries.push_back({&info, kind, statName(info.name), num_values,
+                       visible});
+    return entries.back();
+}
+
+void
+Binary::addDist(const DistData &data)
+{
+    values.insert(values.end(), {
+        data.min, data.max, data.bucket_size, data.samples, data.sum,
+        data.squares, data.logs, data.underflow, data.overflow,
+        data.min_val, data.max_val });
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    if (addEntry(info, ScalarKind, 1).visible)
+        values.push_back(info.result());
+    else
+        values.push_back(0);
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_type size = info.size();
+    if (addEntry(info, VectorKind, size + 1).visible) {
+        const VResult &vec = info.result();
+        values.insert(values.end(), vec.begin(), vec.end());
+        values.push_back(info.total());
+    } else {
+        values.resize(values.size() + size + 1, 0);
+    }
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t size = distFields + info.data.cvec.size();
+    if (addEntry(info, DistKind, size).visible)
+        addDist(info.data);
+    else
+        values.resize(values.size() + size, 0);
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    size_t size = 0;
+    for (const auto &data : info.data)
+        size += distFields + data.cvec.size();
+
+    if (addEntry(info, VectorDistKind, size).visible) {
+        for (const auto &data : info.data)
+            addDist(data);
+    } else {
+        values.resize(values.size() + size, 0);
+    }
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t size = info.x * info.y + 1;
+    if (addEntry(info, Vector2dKind, size).visible) {
+        values.insert(values.end(), info.cvec.begin(), info.cvec.end());
+        values.push_back(info.total());
+    } else {
+        values.resize(values.size() + size, 0);
+    }
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_type size = info.size();
+    if (addEntry(info, FormulaKind, size + 1).visible) {
+        const VResult &vec = info.result();
+        values.insert(values.end(), vec.begin(), vec.end());
+        values.push_back(info.total());
+    } else {
+        values.resize(values.size() + size + 1, 0);
+    }
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    // The buckets of a sparse histogram come and go, so they are kept out
+    // of the fixed block and written as they are in every dump.
+    if (!addEntry(info, SparseHistKind, 0).visible) {
+        sparse.put<double>(0);
+        sparse.put<uint64_t>(0);
+        return;
+    }
+    sparse.put<double>(info.data.samples);
+    sparse.put<uint64_t>(info.data.cmap.size());
+    for (const auto &bucket : info.data.cmap) {
+        sparse.put<double>(bucket.first);
+        sparse.put<double>(bucket.second);
+    }
+}
+
+bool
+Binary::schemaChanged() const
+{
+    if (entries.size() != lastSchema.size())
+        return true;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].info != lastSchema[i].first ||
+            entries[i].numValues != lastSchema[i].second) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+Binary::writeSchema()
+{
+    Buffer schema;
+    schema.put<uint32_t>(entries.size());
+    lastSchema.clear();
+    for (const auto &entry : entries) {
+        const Info &info = *entry.info;
+        lastSchema.emplace_back(&info, entry.numValues);
+
+        schema.put<uint8_t>(entry.kind);
+        schema.put(entry.name);
+        schema.put(info.desc);
+        schema.put(info.unit->getUnitString());
+        schema.put(info.separatorString);
+        schema.put<uint32_t>(info.flags);
+        schema.put<int32_t>(info.precision);
+        schema.put<uint64_t>(entry.numValues);
+
+        switch (entry.kind) {
+          case VectorKind:
+          case FormulaKind: {
+            const auto &vector = static_cast<const VectorInfo &>(info);
+            schema.put(vector.subnames);
+            schema.put(vector.subdescs);
+            break;
+          }
+          case DistKind:
+            schema.put<uint8_t>(
+                static_cast<const DistInfo &>(info).data.type);
+            break;
+          case VectorDistKind: {
+            const auto &vdist = static_cast<const VectorDistInfo &>(info);
+            schema.put(vdist.subnames);
+            schema.put(vdist.subdescs);
+            schema.put<uint32_t>(vdist.data.size());
+            for (const auto &data : vdist.data) {
+                schema.put<uint8_t>(data.type);
+                schema.put<uint64_t>(data.cvec.size());
+            }
+            break;
+          }
+          case Vector2dKind: {
+            const auto &vec2d = static_cast<const Vector2dInfo &>(info);
+            schema.put<uint64_t>(vec2d.x);
+            schema.put<uint64_t>(vec2d.y);
+            schema.put(vec2d.subnames);
+            schema.put(vec2d.subdescs);
+            schema.put(vec2d.y_subnames);
+            break;
+          }
+          default:
+            break;
+        }
+    }
+    writeRecord('S', schema);
+}
+
+void
+Binary::writeDump()
+{
+    Buffer dump;
+    dump.put<uint64_t>(curTick());
+
+    std::vector<uint8_t> visible((entries.size() + 7) / 8, 0);
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].visible)
+            visible[i / 8] |= 1 << (i % 8);
+    }
+    dump.bytes.insert(dump.bytes.end(), visible.begin(), visible.end());
+
+    const bool as_delta = delta && haveLast;
+    dump.put<uint8_t>(as_delta);
+    if (as_delta) {
+        // Bit patterns are compared so that NaNs that stay NaN are not
+        // written again.
+        std::vector<uint8_t> changed((values.size() + 7) / 8, 0);
+        std::vector<double> changed_values;
+        for (size_t i = 0; i < values.size(); i++) {
+            if (std::memcmp(&values[i], &lastValues[i], sizeof(double))) {
+                changed[i / 8] |= 1 << (i % 8);
+                changed_values.push_back(values[i]);
+            }
+        }
+        dump.bytes.insert(dump.bytes.end(), changed.begin(), changed.end());
+        for (double value : changed_values)
+            dump.put(value);
+    } else {
+        for (double value : values)
+            dump.put(value);
+    }
+
+    dump.bytes.insert(dump.bytes.end(), sparse.bytes.begin(),
+                      sparse.bytes.end());
+    writeRecord('D', dump);
+}
+
+void
+Binary::writeRecord(char type, const Buffer &payload)
+{
+    const std::vector<char> *data = &payload.bytes;
+    uint8_t compressed = 0;
+
+#if HAVE_ZSTD
+    std::vector<char> packed;
+    if (compress) {
+        packed.resize(ZSTD_compressBound(payload.bytes.size()));
+        size_t size = ZSTD_compress(packed.data(), packed.size(),
+                                    payload.bytes.data(),
+                                    payload.bytes.size(), 3);
+        if (!ZSTD_isError(size)) {
+            packed.resize(size);
+            data = &packed;
+            compressed = 1;
+        }
+    }
+#endif
+
+    Buffer header;
+    header.put<uint8_t>(type);
+    header.put<uint8_t>(compressed);
+    header.put<uint64_t>(payload.bytes.size());
+    header.put<uint64_t>(data->size());
+    stream.write(header.bytes.data(), header.bytes.size());
+    stream.write(data->data(), data->size());
+}
+
+std::unique_ptr<Output>
+initBinary(const std::string &filename, bool delta, bool compress)
+{
+    return std::unique_ptr<Output>(
+        new Binary(simout.resolve(filename), delta, compress));
+}
+
+} // namespace statistics
+} // namespace gem5
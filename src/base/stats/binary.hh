@@ -0,0 +1,144 @@
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace gem5
+{
+
+namespace statistics
+{
+
+/**
+ * Compact binary stats output for long runs with many dumps.
+ *
+ * The file starts with a schema record that holds the names, types,
+ * units, descriptions and shapes of the stats. Each dump then only
+ * writes a block of doubles in schema order, optionally as the values
+ * that changed since the previous dump. The schema is written again
+ * only if the set of stats changes. util/stats_binary.py reads the file
+ * and converts it back to stats.txt.
+ *
+ * File layout (all integers and doubles little endian):
+ *   magic "GEM5STB1", u32 version
+ *   records: u8 type ('S' schema or 'D' dump), u8 compressed,
+ *            u64 raw size, u64 stored size, payload
+ */
+class Binary : public Output
+{
+  public:
+    enum Kind : uint8_t
+    {
+        ScalarKind,
+        VectorKind,
+        DistKind,
+        VectorDistKind,
+        Vector2dKind,
+        FormulaKind,
+        SparseHistKind,
+    };
+
+    /** Doubles written per bucket-less distribution. */
+    static constexpr size_t distFields = 11;
+
+    static constexpr uint32_t version = 1;
+
+    /**
+     * @param file Output file, relative to the output directory.
+     * @param delta Write the values that changed since the previous dump.
+     * @param compress Compress the records with zstd, if available.
+     */
+    Binary(const std::string &file, bool delta, bool compress);
+
+    Binary() = delete;
+    Binary(const Binary &other) = delete;
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /** A stat of the current dump. */
+    struct Entry
+    {
+        const Info *info;
+        Kind kind;
+        std::string name;
+        /** Number of doubles in the fixed value block. */
+        size_t numValues;
+        bool visible;
+    };
+
+    /** Byte buffer of a record. */
+    struct Buffer
+    {
+        std::vector<char> bytes;
+
+        template <typename T>
+        void
+        put(T value)
+        {
+            const char *p = reinterpret_cast<const char *>(&value);
+            bytes.insert(bytes.end(), p, p + sizeof(T));
+        }
+
+        void put(const std::string &str);
+        void put(const std::vector<std::string> &strs);
+    };
+
+    Entry &addEntry(const Info &info, Kind kind, size_t num_values);
+    void addDist(const DistData &data);
+
+    std::string statName(const std::string &name) const;
+
+    /** True if the schema of this dump differs from the last one. */
+    bool schemaChanged() const;
+    void writeSchema();
+    void writeDump();
+    void writeRecord(char type, const Buffer &payload);
+
+  protected:
+    const bool delta;
+    const bool compress;
+
+    std::ofstream stream;
+    std::stack<std::string> path;
+
+    /** Stats, fixed values and sparse values of the current dump. */
+    std::vector<Entry> entries;
+    std::vector<double> values;
+    Buffer sparse;
+
+    /** Stats and values of the previous dump. */
+    std::vector<std::pair<const Info *, size_t>> lastSchema;
+    std::vector<double> lastValues;
+    bool haveLast;
+};
+
+std::unique_ptr<Output> initBinary(const std::string &filename,
+                                   bool delta = true, bool compress = false);
+
+} // namespace statistics
+} // namespace gem5
+
+#endif // __BASE_STATS_BINARY_HH__
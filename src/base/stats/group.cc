@@ -85,8 +85,10 @@ Group::regStats()
 void
 Group::resetStats()
 {
-    for (auto &s : stats)
-        s->reset();
+    for (auto &s : stats) {
+        if (!s->disabled())
+            s->reset();
+    }
 
     for (auto &g : mergedStatGroups)
         g->resetStats();
@@ -485,6 +485,31 @@ TEST(StatsGroupTest, ResetStats)
     ASSERT_EQ(info5.value, 0);
 }
 
+/** Test that resetStats skips the stats that have been filtered out. */
+TEST(StatsGroupTest, ResetStatsDisabled)
+{
+    statistics::Group root(nullptr);
+
+    DummyInfo info;
+    info.setName("InfoResetStatsEnabled");
+    info.value = 1;
+    root.addStat(&info);
+
+    DummyInfo info2;
+    info2.setName("InfoResetStatsDisabled");
+    info2.flags.set(statistics::display);
+    info2.value = 2;
+    info2.disable();
+    root.addStat(&info2);
+
+    ASSERT_TRUE(info2.disabled());
+    ASSERT_FALSE(info2.flags.isSet(statistics::display));
+
+    root.resetStats();
+    ASSERT_EQ(info.value, 0);
+    ASSERT_EQ(info2.value, 2);
+}
+
 /**
  * Test that calling preDumpStats calls the respective function of all sub-
  * groups and merged groups.
@@ -70,7 +70,8 @@ nameMap()
 }
 
 Info::Info()
-    : flags(none), precision(-1), prereq(0), storageParams()
+    : flags(none), precision(-1), prereq(0), storageParams(),
+      _disabled(false)
 {
     id = id_count++;
     if (debug_break_id >= 0 and debug_break_id == id)
@@ -196,6 +197,13 @@ Info::enable()
 {
 }
 
+void
+Info::disable()
+{
+    _disabled = true;
+    flags.clear(display);
+}
+
 void
 VectorInfo::enable()
 {
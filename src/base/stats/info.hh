@@ -104,6 +104,9 @@ class Info
   private:
     std::unique_ptr<const StorageParams> storageParams;
 
+    /** Set once the stat has been filtered out. */
+    bool _disabled;
+
   public:
     Info();
     virtual ~Info();
@@ -141,6 +144,14 @@ class Info
      */
     virtual void enable();
 
+    /**
+     * Filter the stat out of the simulation. A disabled stat is not
+     * dumped, prepared or reset anymore, and stats that allocate storage
+     * per entry release it and let all entries update a single sink.
+     */
+    virtual void disable();
+    bool disabled() const { return _disabled; }
+
     /**
      * Prepare the stat for dumping.
      */
@@ -203,6 +214,12 @@ class DistInfo : public Info
   public:
     /** Local storage for the entry values, used for printing. */
     DistData data;
+
+    /**
+     * Only record every period-th sample, weighted by the period.
+     * @sa DistBase::samplePeriod()
+     */
+    virtual void samplePeriod(unsigned period) = 0;
 };
 
 class VectorDistInfo : public Info
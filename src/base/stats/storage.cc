@@ -41,6 +41,7 @@
 
 #include "base/stats/storage.hh"
 
+#include <atomic>
 #include <cmath>
 
 namespace gem5
@@ -50,6 +51,20 @@ GEM5_DEPRECATED_NAMESPACE(Stats, statistics);
 namespace statistics
 {
 
+int
+ThreadStatStor::threadSlot()
+{
+    static std::atomic<int> numSlots(0);
+    thread_local int slot = -1;
+    if (slot < 0) {
+        slot = numSlots++;
+        panic_if(slot >= maxThreads,
+                 "More than %d threads update thread-safe stats\n",
+                 maxThreads);
+    }
+    return slot;
+}
+
 void
 DistStor::sample(Counter val, int number)
 {
@@ -117,6 +117,80 @@ class StatStor
     bool zero() const { return data == Counter(); }
 };
 
+/**
+ * Storage for a scalar stat that is updated from several simulation
+ * threads, e.g. by objects on different event queues. Every thread
+ * accumulates into a slot of its own, so updates need neither locks nor
+ * atomics; the slots are reduced when the stat is read, which happens at
+ * dump time when all threads are stopped at a barrier.
+ */
+class ThreadStatStor
+{
+  public:
+    /** Maximum number of threads updating one stat. */
+    static constexpr int maxThreads = 32;
+
+  private:
+    /**
+     * Padded to a cache line to avoid false sharing between threads. The
+     * stat storage is only 8-byte aligned, so no alignas here.
+     */
+    struct Slot
+    {
+        Counter data = Counter();
+        char pad[64 - sizeof(Counter)];
+    };
+
+    Slot slots[maxThreads];
+
+    /** Slot of the calling thread, assigned on first use. */
+    static int threadSlot();
+
+  public:
+    struct Params : public StorageParams {};
+
+    ThreadStatStor(const StorageParams* const storage_params) { }
+
+    /**
+     * Set the stat to the given value. The other slots are cleared, so
+     * this must not race with updates from other threads.
+     * @param val The new value.
+     */
+    void
+    set(Counter val)
+    {
+        for (auto &slot : slots)
+            slot.data = Counter();
+        slots[threadSlot()].data = val;
+    }
+
+    void inc(Counter val) { slots[threadSlot()].data += val; }
+    void dec(Counter val) { slots[threadSlot()].data -= val; }
+
+    /** @return The sum over all threads. */
+    Counter
+    value() const
+    {
+        Counter sum = Counter();
+        for (const auto &slot : slots)
+            sum += slot.data;
+        return sum;
+    }
+
+    Result result() const { return (Result)value(); }
+
+    void prepare(const StorageParams* const storage_params) { }
+
+    void
+    reset(const StorageParams* const storage_params)
+    {
+        for (auto &slot : slots)
+            slot.data = Counter();
+    }
+
+    bool zero() const { return value() == Counter(); }
+};
+
 /**
  * Templatized storage and interface to a per-tick average stat. This keeps
  * a current count and updates a total (count * ticks) when this count
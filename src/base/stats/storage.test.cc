@@ -30,6 +30,8 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <thread>
+#include <vector>
 
 #include "base/gtest/cur_tick_fake.hh"
 #include "base/gtest/logging.hh"
@@ -129,6 +131,45 @@ TEST(StatsStatStorTest, ZeroReset)
     ASSERT_FALSE(stor.zero());
 }
 
+/** Test that updates from several threads are reduced on read. */
+TEST(StatsThreadStatStorTest, IncFromThreads)
+{
+    statistics::ThreadStatStor stor(nullptr);
+    const int num_threads = 4;
+    const int num_incs = 10000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&stor, num_incs]() {
+            for (int i = 0; i < num_incs; i++)
+                stor.inc(1);
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    ASSERT_EQ(stor.value(), num_threads * num_incs);
+    ASSERT_EQ(stor.result(), num_threads * num_incs);
+}
+
+/** Test that set() and reset() override the values of all threads. */
+TEST(StatsThreadStatStorTest, SetReset)
+{
+    statistics::ThreadStatStor stor(nullptr);
+
+    std::thread([&stor]() { stor.inc(5); }).join();
+    stor.inc(3);
+    ASSERT_EQ(stor.value(), 8);
+
+    stor.set(2);
+    ASSERT_EQ(stor.value(), 2);
+    stor.dec(1);
+    ASSERT_EQ(stor.value(), 1);
+
+    stor.reset(nullptr);
+    ASSERT_TRUE(stor.zero());
+}
+
 /** Test setting and getting a value to the storage. */
 TEST(StatsAvgStorTest, SetValueResult)
 {
@@ -34,6 +34,7 @@
 #include <cctype>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
 #include "base/atomicio.hh"
@@ -152,16 +153,23 @@ OstreamLogger::logMessage(Tick when, const std::string &name,
     if (!name.empty() && ignore.match(name))
         return;
 
+    // Format the whole line first and write it in one go, so that lines
+    // logged by simulation threads of different event queues don't mix.
+    std::ostringstream line;
     if (!debug::FmtTicksOff && (when != MaxTick))
-        ccprintf(stream, "%7d: ", when);
+        ccprintf(line, "%7d: ", when);
 
     if (debug::FmtFlag && !flag.empty())
-        stream << flag << ": ";
+        line << flag << ": ";
 
     if (!name.empty())
-        stream << name << ": ";
+        line << name << ": ";
 
-    stream << message;
+    line << message;
+
+    static std::mutex stream_mutex;
+    std::lock_guard<std::mutex> lock(stream_mutex);
+    stream << line.str();
     stream.flush();
 
     if (debug::FmtStackTrace) {
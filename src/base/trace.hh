@@ -39,6 +39,7 @@
 #include "base/compiler.hh"
 #include "base/cprintf.hh"
 #include "base/debug.hh"
+#include "base/flight_recorder.hh"
 #include "base/match.hh"
 #include "base/types.hh"
 #include "sim/cur_tick.hh"
@@ -83,6 +84,21 @@ class Logger
         logMessage(when, name, flag, line.str());
     }
 
+    /**
+     * Log a single message with a flag prefix, unless the flight recorder
+     * is on, in which case the message is kept unformatted in its ring.
+     */
+    template <typename ...Args>
+    void dprintf_flag(Tick when, const std::string &name, const char *flag,
+            const char *fmt, const Args &...args)
+    {
+        if (GEM5_UNLIKELY(FlightRecorder::enabled())) {
+            FlightRecorder::record(when, name, flag, fmt, args...);
+            return;
+        }
+        dprintf_flag(when, name, std::string(flag), fmt, args...);
+    }
+
     /** Dump a block of data of length len */
     void dump(Tick when, const std::string &name,
             const void *d, int len, const std::string &flag);
@@ -66,6 +66,7 @@
 #include "mem/page_table.hh"
 #include "params/BaseCPU.hh"
 #include "sim/clocked_object.hh"
+#include "sim/event_pool.hh"
 #include "sim/full_system.hh"
 #include "sim/process.hh"
 #include "sim/root.hh"
@@ -435,6 +436,9 @@ BaseCPU::probeInstCommit(const StaticInstPtr &inst, Addr pc)
 
     if (inst->isControl())
         ppRetiredBranches->notify(1);
+
+    if (TRACING_ON && GEM5_UNLIKELY(pc == Trace::FlightRecorder::triggerPC()))
+        Trace::FlightRecorder::dump(csprintf("commit of pc %#x", pc));
 }
 
 BaseCPU::
@@ -813,7 +817,18 @@ BaseCPU::GlobalStats::GlobalStats(statistics::Group *parent)
              "Simulator instruction rate (inst/s)"),
     ADD_STAT(hostOpRate, statistics::units::Rate<
                 statistics::units::Count, statistics::units::Second>::get(),
-             "Simulator op (including micro ops) rate (op/s)")
+             "Simulator op (including micro ops) rate (op/s)"),
+    ADD_STAT(simEventAllocs, statistics::units::Count::get(),
+             "Number of pooled events scheduled (formerly one heap "
+             "allocation each)"),
+    ADD_STAT(simEventHeapAllocs, statistics::units::Count::get(),
+             "Number of heap allocations made by the event pools"),
+    ADD_STAT(eventAllocsPerKInst, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Count>::get(),
+             "Pooled events scheduled per thousand instructions"),
+    ADD_STAT(eventHeapAllocsPerKInst, statistics::units::Rate<
+                statistics::units::Count, statistics::units::Count>::get(),
+             "Event pool heap allocations per thousand instructions")
 {
     simInsts
         .functor(BaseCPU::numSimulatedInsts)
@@ -839,6 +854,22 @@ BaseCPU::GlobalStats::GlobalStats(statistics::Group *parent)
 
     hostInstRate = simInsts / hostSeconds;
     hostOpRate = simOps / hostSeconds;
+
+    simEventAllocs
+        .functor(EventPoolStats::allocations)
+        .precision(0)
+        ;
+
+    simEventHeapAllocs
+        .functor(EventPoolStats::heapAllocations)
+        .precision(0)
+        ;
+
+    eventAllocsPerKInst.precision(4);
+    eventHeapAllocsPerKInst.precision(4);
+
+    eventAllocsPerKInst = simEventAllocs * 1000 / simInsts;
+    eventHeapAllocsPerKInst = simEventHeapAllocs * 1000 / simInsts;
 }
 
 
@@ -1229,6 +1260,8 @@ BaseCPU::difftestStep(ThreadID tid, InstSeqNum seq)
                 if (diff_at != NoneDiff) {
                     diffAllStates->proxy->isa_reg_display();
                     displayGem5Regs();
+                    if (Trace::FlightRecorder::enabled())
+                        Trace::FlightRecorder::dump("difftest mismatch");
                     panic("Difftest failed again!\n");
                 } else {
                     warn(
@@ -1244,6 +1277,8 @@ BaseCPU::difftestStep(ThreadID tid, InstSeqNum seq)
                     warn("V %s\n", msg);
                     diffInfo.lastCommittedMsg.pop();
                 }
+                if (Trace::FlightRecorder::enabled())
+                    Trace::FlightRecorder::dump("difftest mismatch");
                 panic("Difftest failed!\n");
             }
         }
@@ -186,6 +186,12 @@ class BaseCPU : public ClockedObject
 
         statistics::Formula hostInstRate;
         statistics::Formula hostOpRate;
+
+        /** Events taken from event pools, and heap allocations made. */
+        statistics::Value simEventAllocs;
+        statistics::Value simEventHeapAllocs;
+        statistics::Formula eventAllocsPerKInst;
+        statistics::Formula eventHeapAllocsPerKInst;
     };
 
     /**
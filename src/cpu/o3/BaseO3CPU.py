@@ -210,3 +210,16 @@ class BaseO3CPU(BaseCPU):
     scheduler = Param.Scheduler(KunminghuScheduler(), "")
 
     arch_db = Param.ArchDBer(Parent.any, "Arch DB")
+
+    pipe_trace_file = Param.String("",
+        "Binary pipeline trace file, compressed if it ends in .gz "
+        "(empty for no trace)")
+    pipe_trace_start = Param.Tick(0, "Tick to start the pipeline trace at")
+    pipe_trace_stop = Param.Tick(MaxTick, "Tick to stop the pipeline trace at")
+    pipe_trace_start_inst = Param.Counter(0,
+        "Committed instructions before the pipeline trace starts")
+    pipe_trace_insts = Param.Counter(0,
+        "Instructions to trace (0 for no limit)")
+    pipe_trace_ring = Param.Unsigned(0,
+        "Only keep the last records and write them at exit "
+        "(0 to stream all of them)")
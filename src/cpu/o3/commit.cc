@@ -412,6 +412,14 @@ Commit::drainResume()
     drainImminent = false;
 }
 
+void
+Commit::wakeFromQuiesce()
+{
+    // A thread that slept did not commit, but it is not stuck
+    lastCommitCycle = cpu->curCycle();
+    maybeStucked = false;
+}
+
 void
 Commit::drainSanityCheck() const
 {
@@ -628,10 +636,20 @@ Commit::squashAll(ThreadID tid)
     squashInflightAndUpdateVersion(tid);
 }
 
+void
+Commit::traceSquash(ThreadID tid, PipeTrace::SquashReason reason)
+{
+    if (cpu->pipeTrace) {
+        cpu->pipeTrace->squash(tid, toIEW->commitInfo[tid].doneSeqNum,
+                               reason);
+    }
+}
+
 void
 Commit::squashFromTrap(ThreadID tid)
 {
     squashAll(tid);
+    traceSquash(tid, PipeTrace::TrapSquash);
 
     toIEW->commitInfo[tid].isTrapSquash = true;
     toIEW->commitInfo[tid].committedPC = committedPC[tid];
@@ -652,6 +670,7 @@ void
 Commit::squashFromTC(ThreadID tid)
 {
     squashAll(tid);
+    traceSquash(tid, PipeTrace::TCSquash);
 
     DPRINTF(Commit, "Squashing from TC, restarting at PC %s\n", *pc[tid]);
 
@@ -671,6 +690,7 @@ Commit::squashFromSquashAfter(ThreadID tid)
             "restarting at PC %s\n", *pc[tid]);
 
     squashAll(tid);
+    traceSquash(tid, PipeTrace::SquashAfterSquash);
     // Make sure to inform the fetch stage of which instruction caused
     // the squash. It'll try to re-fetch an instruction executing in
     // microcode unless this is set.
@@ -948,6 +968,8 @@ Commit::commit()
             changedROBNumEntries[tid] = true;
 
             toIEW->commitInfo[tid].doneSeqNum = squashed_inst;
+            traceSquash(tid, fromIEW->mispredictInst[tid] ?
+                        PipeTrace::BranchSquash : PipeTrace::MemOrderSquash);
 
             toIEW->commitInfo[tid].squash = true;
 
@@ -1578,13 +1600,11 @@ Commit::commitHead(const DynInstPtr &head_inst, unsigned inst_num)
     // Finally clear the head ROB entry.
     rob->retireHead(tid);
 
-#if TRACING_ON
-    if (debug::O3PipeView) {
+    if (head_inst->fetchTick != -1) {
         head_inst->commitTick = curTick() - head_inst->fetchTick;
         DPRINTF(O3PipeView, "Record commit for inst sn:%lu, commitTick=%lu\n",
                 head_inst->seqNum, head_inst->commitTick);
     }
-#endif
 
     // If this was a store, record it for this cycle.
     if (head_inst->isStore() || head_inst->isAtomic())
@@ -55,6 +55,7 @@
 #include "cpu/o3/dyn_inst_ptr.hh"
 #include "cpu/o3/iew.hh"
 #include "cpu/o3/limits.hh"
+#include "cpu/o3/pipe_trace.hh"
 #include "cpu/o3/rename_map.hh"
 #include "cpu/o3/rob.hh"
 #include "cpu/pred/bpred_unit.hh"
@@ -213,6 +214,9 @@ class Commit
     /** Takes over from another CPU's thread. */
     void takeOverFrom();
 
+    /** Restarts the stuck check when a suspended thread wakes up. */
+    void wakeFromQuiesce();
+
     /** Deschedules a thread from scheduling */
     void deactivateThread(ThreadID tid);
 
@@ -256,6 +260,9 @@ class Commit
     /** Squashes all in flight instructions. */
     void squashAll(ThreadID tid);
 
+    /** Tells the pipeline trace why the last squash happened. */
+    void traceSquash(ThreadID tid, PipeTrace::SquashReason reason);
+
     /** Handles squashing due to a trap. */
     void squashFromTrap(ThreadID tid);
 
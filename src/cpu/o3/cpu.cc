@@ -149,6 +149,9 @@ CPU::CPU(const BaseO3CPUParams &params)
         checker = NULL;
     }
 
+    if (!params.pipe_trace_file.empty())
+        pipeTrace.reset(new PipeTrace(this, params));
+
     if (!FullSystem) {
         thread.resize(numThreads);
         tids.resize(numThreads);
@@ -641,6 +644,7 @@ CPU::activateContext(ThreadID tid)
         // deschedule itself.
         activityRec.activity();
         fetch.wakeFromQuiesce();
+        commit.wakeFromQuiesce();
 
         Cycles cycles(curCycle() - lastRunningCycle);
         // @todo: This is an oddity that is only here to match the stats
@@ -1602,7 +1606,7 @@ CPU::htmSendAbortSignal(ThreadID tid, uint64_t htm_uid,
 
     // notify l1 d-cache (ruby) that core has aborted transaction
     RequestPtr req =
-        std::make_shared<Request>(addr, size, flags, _dataRequestorId);
+        makeRequest(addr, size, flags, _dataRequestorId);
 
     req->taskId(taskId());
     req->setContext(thread[tid]->contextId());
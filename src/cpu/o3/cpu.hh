@@ -45,6 +45,7 @@
 
 #include <iostream>
 #include <list>
+#include <memory>
 #include <queue>
 #include <set>
 #include <vector>
@@ -64,6 +65,7 @@
 #include "cpu/o3/free_list.hh"
 #include "cpu/o3/iew.hh"
 #include "cpu/o3/limits.hh"
+#include "cpu/o3/pipe_trace.hh"
 #include "cpu/o3/rename.hh"
 #include "cpu/o3/rob.hh"
 #include "cpu/o3/scoreboard.hh"
@@ -401,6 +403,10 @@ class CPU : public BaseCPU
     uint32_t getIQInsts() { return iew.getIQInsts(); }
 
   public:
+    /** Binary pipeline trace, null when it is off. Declared before the
+     *  instruction lists as the instructions write to it when destroyed. */
+    std::unique_ptr<PipeTrace> pipeTrace;
+
 #ifndef NDEBUG
     /** Count of total number of dynamic instructions in flight. */
     int instcount;
@@ -47,6 +47,7 @@
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/dyn_inst.hh"
 #include "cpu/o3/limits.hh"
+#include "cpu/o3/pipe_trace.hh"
 #include "debug/Activity.hh"
 #include "debug/Decode.hh"
 #include "debug/DecoupleBP.hh"
@@ -303,6 +304,10 @@ Decode::squash(const DynInstPtr &inst, ThreadID tid)
     toFetch->decodeInfo[tid].mispredictInst = inst;
     toFetch->decodeInfo[tid].squash = true;
     toFetch->decodeInfo[tid].doneSeqNum = inst->seqNum;
+    if (cpu->pipeTrace) {
+        cpu->pipeTrace->squash(tid, inst->seqNum,
+                               PipeTrace::DecodeSquash);
+    }
     if (inst->isControl()) {
         if (!inst->isReturn()) {
             set(toFetch->decodeInfo[tid].nextPC, *inst->branchTarget());
@@ -764,13 +769,11 @@ Decode::decodeInsts(ThreadID tid)
         ++stats.decodedInsts;
         --insts_available;
 
-#if TRACING_ON
-        if (debug::O3PipeView) {
+        if (inst->fetchTick != -1) {
             inst->decodeTick = curTick() - inst->fetchTick;
             DPRINTF(O3PipeView, "Record decode for inst sn:%lu\n",
                     inst->seqNum);
         }
-#endif
 
         // Ensure that if it was predicted as a branch, it really is a
         // branch.
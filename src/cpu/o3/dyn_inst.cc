@@ -45,6 +45,7 @@
 #include <cstring>
 
 #include "base/intmath.hh"
+#include "cpu/o3/pipe_trace.hh"
 #include "debug/DynInst.hh"
 #include "debug/IQ.hh"
 #include "debug/O3PipeView.hh"
@@ -246,6 +247,9 @@ DynInst::~DynInst()
     }
 #endif
 
+    if (fetchTick != -1 && cpu->pipeTrace)
+        cpu->pipeTrace->record(*this);
+
     delete [] memData;
     delete traceData;
     fault = NoFault;
@@ -1093,10 +1093,10 @@ class DynInst : public ExecContext, public RefCounted
     uint64_t htmDepth = 0;
 
   public:
-#if TRACING_ON
     // Value -1 indicates that particular phase
     // hasn't happened (yet).
-    /** Tick records used for the pipeline activity viewer. */
+    /** Tick records used for the pipeline activity viewer and the pipeline
+     *  trace, only kept when fetchTick is set. */
     Tick fetchTick = -1;      // instruction fetch is completed.
     int32_t decodeTick = -1;  // instruction enters decode phase
     int32_t renameTick = -1;  // instruction enters rename phase
@@ -1105,7 +1105,9 @@ class DynInst : public ExecContext, public RefCounted
     int32_t completeTick = -1;
     int32_t commitTick = -1;
     int32_t storeTick = -1;
-#endif
+    /** Issue queue and port the instruction was last issued from. */
+    int8_t traceIQ = -1;
+    int8_t tracePort = -1;
 
     /* Values used by LoadToUse stat */
     Tick enterDQTick = -1;
@@ -59,6 +59,7 @@
 #include "cpu/o3/cpu.hh"
 #include "cpu/o3/dyn_inst.hh"
 #include "cpu/o3/limits.hh"
+#include "cpu/o3/pipe_trace.hh"
 #include "debug/Activity.hh"
 #include "debug/Counters.hh"
 #include "debug/DecoupleBPProbe.hh"
@@ -418,7 +419,7 @@ Fetch::processCacheCompletion(PacketPtr pkt)
                 DPRINTF(Fetch, "[tid:%i] send next pkt, addr: %#x, size: %d\n",
                         tid, pkt->req->getVaddr() + 64 - pkt->req->getVaddr() % 64, 
                         fetchBufferSize - pkt->getSize());
-                RequestPtr mem_req = std::make_shared<Request>(
+                RequestPtr mem_req = makeRequest(
                                     anotherPC, 
                                     anotherSize,
                                     Request::INST_FETCH, cpu->instRequestorId(), pkt->req->getPC(),
@@ -734,7 +735,7 @@ Fetch::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
         secondPkt[tid] = nullptr;
 
         fetchSize = 64 - fetchPC % 64;
-        RequestPtr mem_req = std::make_shared<Request>(
+        RequestPtr mem_req = makeRequest(
             fetchPC, fetchSize,
             Request::INST_FETCH, cpu->instRequestorId(), pc,
             cpu->thread[tid]->contextId());
@@ -768,7 +769,7 @@ Fetch::fetchCacheLine(Addr vaddr, ThreadID tid, Addr pc)
         return true;
     }
 
-    RequestPtr mem_req = std::make_shared<Request>(
+    RequestPtr mem_req = makeRequest(
         fetchPC, fetchSize,
         Request::INST_FETCH, cpu->instRequestorId(), pc,
         cpu->thread[tid]->contextId());
@@ -1796,13 +1797,12 @@ Fetch::fetch(bool &status_change)
             ppFetch->notify(instruction);
             numInst++;
 
-#if TRACING_ON
-            if (debug::O3PipeView) {
+            if ((TRACING_ON && debug::O3PipeView) ||
+                (cpu->pipeTrace && cpu->pipeTrace->traceFetch())) {
                 instruction->fetchTick = curTick();
                 DPRINTF(O3PipeView, "Record fetch for inst sn:%lu\n",
                         instruction->seqNum);
             }
-#endif
 
             set(next_pc, this_pc);
 
@@ -1289,9 +1289,8 @@ IEW::dispatchInstFromDispQue(ThreadID tid)
 
             inst->exitDQTick = curTick();
 
-    #if TRACING_ON
-            inst->dispatchTick = curTick() - inst->fetchTick;
-    #endif
+            if (inst->fetchTick != -1)
+                inst->dispatchTick = curTick() - inst->fetchTick;
             ppDispatch->notify(inst);
 
             dispQue[i].pop_front();
@@ -1795,11 +1794,9 @@ IEW::updateExeInstStats(const DynInstPtr& inst)
 
     iewStats.executedInstStats.numInsts++;
 
-#if TRACING_ON
-    if (debug::O3PipeView) {
+    if (inst->fetchTick != -1) {
         inst->completeTick = curTick() - inst->fetchTick;
     }
-#endif
 
     //
     //  Control operations
@@ -265,6 +265,8 @@ IssueQue::scheduleInst()
             iqstats->arbFailed++;
         } else {
             DPRINTF(Schedule, "[sn %ld] no conflict, scheduled\n", inst->seqNum);
+            inst->traceIQ = IQID;
+            inst->tracePort = toIssue->size;
             toIssue->push(inst);
             if (scheduler->getCorrectedOpLat(inst) <= 1) {
                 scheduler->wakeUpDependents(inst, this);
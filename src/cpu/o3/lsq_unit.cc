@@ -66,7 +66,7 @@ namespace o3
 
 LSQUnit::WritebackEvent::WritebackEvent(const DynInstPtr &_inst,
         PacketPtr _pkt, LSQUnit *lsq_ptr)
-    : Event(Default_Pri, AutoDelete),
+    : PooledEvent(Default_Pri),
       inst(_inst), pkt(_pkt), lsqPtr(lsq_ptr)
 {
     assert(_inst->savedRequest);
@@ -92,7 +92,7 @@ LSQUnit::WritebackEvent::description() const
 }
 
 LSQUnit::bankConflictReplayEvent::bankConflictReplayEvent(LSQUnit *lsq_ptr)
-    : Event(Default_Pri, AutoDelete), lsqPtr(lsq_ptr)
+    : PooledEvent(Default_Pri), lsqPtr(lsq_ptr)
 {
 }
 
@@ -252,7 +252,7 @@ LSQUnit::bankConflictReplay()
 void
 LSQUnit::bankConflictReplaySchedule()
 {
-    bankConflictReplayEvent *bk = new bankConflictReplayEvent(this);
+    bankConflictReplayEvent *bk = bankConflictReplayEventPool.allocate(this);
     cpu->schedule(bk, cpu->clockEdge(Cycles(1)));
 }
 
@@ -723,7 +723,7 @@ LSQUnit::triggerStorePFTrain(int sq_idx)
     Addr pc = inst->pcState().instAddr();
     // create request
     RequestPtr req =
-        std::make_shared<Request>(vaddr, 1, Request::STORE_PF_TRAIN, inst->requestorId(), pc, inst->contextId());
+        makeRequest(vaddr, 1, Request::STORE_PF_TRAIN, inst->requestorId(), pc, inst->contextId());
     req->setPaddr(inst->physEffAddr);
 
     // create packet
@@ -977,7 +977,7 @@ LSQUnit::writebackStores()
                         "Instantly completing it.\n",
                         inst->seqNum);
                 PacketPtr new_pkt = new Packet(*request->packet());
-                WritebackEvent *wb = new WritebackEvent(inst,
+                WritebackEvent *wb = writebackEventPool.allocate(inst,
                         new_pkt, this);
                 cpu->schedule(wb, curTick() + 1);
                 completeStore(storeWBIt);
@@ -1263,12 +1263,10 @@ LSQUnit::completeStore(typename StoreQueue::iterator store_idx)
             "idx:%i\n",
             store_inst->seqNum, store_idx.idx() - 1, storeQueue.head() - 1);
 
-#if TRACING_ON
-    if (debug::O3PipeView) {
+    if (store_inst->fetchTick != -1) {
         store_inst->storeTick =
             curTick() - store_inst->fetchTick;
     }
-#endif
 
     if (isStalled() &&
         store_inst->seqNum == stallingStoreIsn) {
@@ -1526,7 +1524,8 @@ LSQUnit::read(LSQRequest *request, ssize_t load_idx)
 
         Cycles delay = request->mainReq()->localAccessor(thread, main_pkt);
 
-        WritebackEvent *wb = new WritebackEvent(load_inst, main_pkt, this);
+        WritebackEvent *wb = writebackEventPool.allocate(load_inst, main_pkt,
+                                                         this);
         cpu->schedule(wb, cpu->clockEdge(delay));
         return NoFault;
     }
@@ -1679,8 +1678,8 @@ LSQUnit::read(LSQRequest *request, ssize_t load_idx)
                     request->discard();
                 }
 
-                WritebackEvent *wb = new WritebackEvent(load_inst, data_pkt,
-                        this);
+                WritebackEvent *wb = writebackEventPool.allocate(load_inst,
+                        data_pkt, this);
 
                 // We'll say this has a 1 cycle load-store forwarding latency
                 // for now.
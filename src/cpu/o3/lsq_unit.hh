@@ -63,6 +63,7 @@
 #include "debug/LSQUnit.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
+#include "sim/event_pool.hh"
 
 namespace gem5
 {
@@ -414,7 +415,7 @@ class LSQUnit
     RequestPort *dcachePort;
 
     /** Writeback event, specifically for when stores forward data to loads. */
-    class WritebackEvent : public Event
+    class WritebackEvent : public PooledEvent<WritebackEvent>
     {
       public:
         /** Constructs a writeback event. */
@@ -437,7 +438,7 @@ class LSQUnit
         /** The pointer to the LSQ unit that issued the store. */
         LSQUnit *lsqPtr;
     };
-    class bankConflictReplayEvent : public Event
+    class bankConflictReplayEvent : public PooledEvent<bankConflictReplayEvent>
     {
       public:
         /** Constructs a bankConflict event. */
@@ -454,6 +455,10 @@ class LSQUnit
         LSQUnit *lsqPtr;
     };
 
+    /** Recycled writeback and bank conflict replay events. */
+    EventPool<WritebackEvent> writebackEventPool;
+    EventPool<bankConflictReplayEvent> bankConflictReplayEventPool;
+
   public:
     /**
      * Handles writing back and completing the load or store that has
@@ -0,0 +1,232 @@
+#include "cpu/o3/pipe_trace.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "cpu/o3/cpu.hh"
+#include "cpu/o3/dyn_inst.hh"
+#include "params/BaseO3CPU.hh"
+#include "sim/core.hh"
+
+namespace gem5
+{
+
+namespace o3
+{
+
+namespace
+{
+
+/** Records written to the stream at once. */
+constexpr size_t bufferSize = 64 * 1024;
+
+/** Squashes remembered per thread to find the reason of a squash. */
+constexpr size_t squashHistory = 64;
+
+} // anonymous namespace
+
+PipeTrace::PipeTrace(CPU *_cpu, const BaseO3CPUParams &params)
+    : cpu(_cpu), startTick(params.pipe_trace_start),
+      stopTick(params.pipe_trace_stop),
+      startInsts(params.pipe_trace_start_inst),
+      maxInsts(params.pipe_trace_insts),
+      ringSize(params.pipe_trace_ring)
+{
+    fatal_if(stopTick <= startTick,
+             "%s: pipe_trace_stop must be after pipe_trace_start\n",
+             cpu->name());
+
+    OutputStream *os = simout.create(params.pipe_trace_file, true);
+    fatal_if(!os, "%s: could not open pipeline trace file %s\n",
+             cpu->name(), params.pipe_trace_file);
+    stream = os->stream();
+
+    stream->write("GEM5O3PT", 8);
+    stream->write(reinterpret_cast<const char *>(&version), sizeof(version));
+
+    buffer.reserve(bufferSize);
+    ring.reserve(ringSize);
+
+    registerExitCallback([this]() { flush(); });
+}
+
+PipeTrace::~PipeTrace()
+{
+    flush();
+}
+
+bool
+PipeTrace::checkStart()
+{
+    if (curTick() < startTick)
+        return false;
+    if (startInsts && cpu->totalInsts() < startInsts)
+        return false;
+    started = true;
+    return true;
+}
+
+void
+PipeTrace::squash(ThreadID tid, InstSeqNum seq_num, SquashReason reason)
+{
+    auto &history = squashes[tid];
+    if (history.size() == squashHistory)
+        history.pop_front();
+    history.push_back({curTick(), seq_num, reason});
+}
+
+PipeTrace::SquashReason
+PipeTrace::squashReason(const DynInst &inst) const
+{
+    // The instruction went away with the first squash after its fetch
+    // that covered it.
+    for (const auto &event : squashes[inst.threadNumber]) {
+        if (event.when >= inst.fetchTick && event.seqNum < inst.seqNum)
+            return event.reason;
+    }
+    return OtherSquash;
+}
+
+void
+PipeTrace::record(const DynInst &inst)
+{
+    Record rec;
+    rec.seqNum = inst.seqNum;
+    rec.pc = inst.pcState().instAddr();
+    rec.fetch = inst.fetchTick;
+    rec.decode = inst.decodeTick;
+    rec.rename = inst.renameTick;
+    rec.dispatch = inst.dispatchTick;
+    rec.issue = inst.issueTick;
+    rec.complete = inst.completeTick;
+    rec.retire = inst.commitTick;
+    rec.storeComplete = inst.storeTick;
+    rec.memLatency = 0;
+    if (inst.isMemRef() && inst.translatedTick != -1 &&
+        inst.completionTick != -1 &&
+        inst.completionTick >= inst.translatedTick) {
+        rec.memLatency = inst.completionTick - inst.translatedTick;
+    }
+    rec.opClass = inst.opClass();
+    rec.microPC = inst.pcState().microPC();
+    rec.tid = inst.threadNumber;
+    rec.issueQueue = inst.traceIQ;
+    rec.issuePort = inst.tracePort;
+
+    rec.flags = 0;
+    if (inst.isCommitted())
+        rec.flags |= Committed;
+    if (inst.isLoad())
+        rec.flags |= Load;
+    if (inst.isStore())
+        rec.flags |= Store;
+    if (inst.isControl()) {
+        rec.flags |= Control;
+        // A mispredicted branch squashes everything younger than itself.
+        for (const auto &event : squashes[inst.threadNumber]) {
+            if (event.seqNum == inst.seqNum &&
+                (event.reason == BranchSquash ||
+                 event.reason == DecodeSquash)) {
+                rec.flags |= Mispredicted;
+                break;
+            }
+        }
+    }
+
+    rec.squashReason = NoSquash;
+    if (inst.isSquashed() || !inst.isCommitted()) {
+        rec.flags |= Squashed;
+        rec.squashReason = squashReason(inst);
+    }
+
+    if (!disasms.count({rec.pc, rec.microPC}))
+        writeDisasm(inst);
+
+    if (ringSize) {
+        if (ring.size() < ringSize) {
+            ring.push_back(rec);
+        } else {
+            ring[ringHead] = rec;
+            ringHead = (ringHead + 1) % ringSize;
+        }
+    } else {
+        write(rec);
+    }
+}
+
+void
+PipeTrace::writeDisasm(const DynInst &inst)
+{
+    const Addr pc = inst.pcState().instAddr();
+    const uint8_t upc = inst.pcState().microPC();
+    auto &disasm = disasms[{pc, upc}];
+    disasm = inst.staticInst->disassemble(pc);
+    // In ring mode the names go out at exit along with the records.
+    if (!ringSize)
+        writeDisasm(pc, upc, disasm);
+}
+
+void
+PipeTrace::writeDisasm(Addr pc, uint8_t upc, const std::string &disasm)
+{
+    const uint16_t size = std::min<size_t>(disasm.size(), UINT16_MAX);
+    const size_t offset = buffer.size();
+    buffer.resize(offset + 1 + sizeof(uint64_t) + 1 + sizeof(size) + size);
+    char *p = buffer.data() + offset;
+    const uint64_t addr = pc;
+    *p++ = 'D';
+    std::memcpy(p, &addr, sizeof(addr));
+    p += sizeof(addr);
+    *p++ = upc;
+    std::memcpy(p, &size, sizeof(size));
+    p += sizeof(size);
+    std::memcpy(p, disasm.data(), size);
+
+    if (buffer.size() >= bufferSize)
+        flush();
+}
+
+void
+PipeTrace::write(const Record &rec)
+{
+    const size_t offset = buffer.size();
+    buffer.resize(offset + 1 + sizeof(rec));
+    buffer[offset] = 'I';
+    std::memcpy(buffer.data() + offset + 1, &rec, sizeof(rec));
+
+    if (buffer.size() >= bufferSize)
+        flush();
+}
+
+void
+PipeTrace::flush()
+{
+    if (ringSize && !ring.empty()) {
+        std::vector<Record> records;
+        records.swap(ring);
+        const size_t head = ringHead;
+        ringHead = 0;
+
+        std::set<std::pair<Addr, uint8_t>> named;
+        for (const auto &rec : records) {
+            if (named.insert({rec.pc, rec.microPC}).second)
+                writeDisasm(rec.pc, rec.microPC,
+                            disasms[{rec.pc, rec.microPC}]);
+        }
+        for (size_t i = 0; i < records.size(); i++)
+            write(records[(head + i) % records.size()]);
+        ring.reserve(ringSize);
+    }
+
+    if (!buffer.empty()) {
+        stream->write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    stream->flush();
+}
+
+} // namespace o3
+} // namespace gem5
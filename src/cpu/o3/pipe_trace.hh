@@ -0,0 +1,175 @@
+#ifndef __CPU_O3_PIPE_TRACE_HH__
+#define __CPU_O3_PIPE_TRACE_HH__
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "base/compiler.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/o3/limits.hh"
+#include "sim/cur_tick.hh"
+
+namespace gem5
+{
+
+struct BaseO3CPUParams;
+
+namespace o3
+{
+
+class CPU;
+
+/**
+ * Binary pipeline trace of the O3 CPU, a cheap replacement of the text
+ * printed by the O3PipeView debug flag.
+ *
+ * Instructions fetched inside the trace window have their stage ticks
+ * recorded in the DynInst, and a fixed size record is emitted when the
+ * instruction is destroyed, i.e. once it has committed (and its store
+ * has completed) or has been squashed. Records go through a buffer to
+ * the output file, which is gzip compressed if its name ends in .gz. In
+ * ring mode only the last records are kept and written at exit.
+ *
+ * util/o3-pipetrace.py converts the trace to the O3PipeView text read by
+ * util/o3-pipeview.py and to the Konata format.
+ *
+ * File layout (little endian): magic "GEM5O3PT", u32 version, then
+ * records starting with a type byte: 'I' followed by an Record, or 'D'
+ * followed by u64 pc, u8 micro pc, u16 length and the disassembly of an
+ * instruction seen for the first time.
+ */
+class PipeTrace
+{
+  public:
+    enum SquashReason : uint8_t
+    {
+        NoSquash,
+        /** Mispredicted branch resolved in execute. */
+        BranchSquash,
+        /** Load executed before an older store to the same address. */
+        MemOrderSquash,
+        /** Fault or interrupt taken at commit. */
+        TrapSquash,
+        /** State change from the thread context. */
+        TCSquash,
+        /** Squash after a serializing instruction. */
+        SquashAfterSquash,
+        /** Redirect from decode. */
+        DecodeSquash,
+        /** Removed by the front end without a squash seen here. */
+        OtherSquash,
+    };
+
+    enum Flags : uint8_t
+    {
+        Committed = 0x1,
+        Squashed = 0x2,
+        Load = 0x4,
+        Store = 0x8,
+        Control = 0x10,
+        Mispredicted = 0x20,
+    };
+
+    /** Lifecycle of one instruction, stage ticks relative to fetch. */
+    struct GEM5_PACKED Record
+    {
+        uint64_t seqNum;
+        uint64_t pc;
+        uint64_t fetch;
+        /** Ticks after fetch, -1 if the stage was not reached. */
+        int32_t decode;
+        int32_t rename;
+        int32_t dispatch;
+        int32_t issue;
+        int32_t complete;
+        int32_t retire;
+        int32_t storeComplete;
+        /** Ticks from address translation to completion of a memory op. */
+        uint32_t memLatency;
+        uint16_t opClass;
+        uint8_t microPC;
+        uint8_t tid;
+        uint8_t flags;
+        uint8_t squashReason;
+        int8_t issueQueue;
+        int8_t issuePort;
+    };
+
+    static constexpr uint32_t version = 1;
+
+    PipeTrace(CPU *_cpu, const BaseO3CPUParams &params);
+    ~PipeTrace();
+
+    /** Whether an instruction fetched now is traced. */
+    bool
+    traceFetch()
+    {
+        if (GEM5_UNLIKELY(!started) && !checkStart())
+            return false;
+        if (curTick() >= stopTick || (maxInsts && fetched >= maxInsts))
+            return false;
+        fetched++;
+        return true;
+    }
+
+    /**
+     * Note a squash of the instructions younger than seq_num, to give
+     * their records a reason.
+     */
+    void squash(ThreadID tid, InstSeqNum seq_num, SquashReason reason);
+
+    /** Emit the record of a traced instruction leaving the pipeline. */
+    void record(const DynInst &inst);
+
+    /** Write out the buffered records. */
+    void flush();
+
+  private:
+    struct SquashEvent
+    {
+        Tick when;
+        InstSeqNum seqNum;
+        SquashReason reason;
+    };
+
+    bool checkStart();
+    SquashReason squashReason(const DynInst &inst) const;
+    void write(const Record &rec);
+    void writeDisasm(const DynInst &inst);
+    void writeDisasm(Addr pc, uint8_t upc, const std::string &disasm);
+
+    CPU *cpu;
+
+    const Tick startTick;
+    const Tick stopTick;
+    const Counter startInsts;
+    const Counter maxInsts;
+    const size_t ringSize;
+
+    bool started = false;
+    Counter fetched = 0;
+
+    std::ostream *stream;
+    std::vector<char> buffer;
+
+    /** Last records in ring mode. */
+    std::vector<Record> ring;
+    size_t ringHead = 0;
+
+    /** Disassembly of the instructions seen so far. */
+    std::map<std::pair<Addr, uint8_t>, std::string> disasms;
+
+    /** Recent squashes of each thread. */
+    std::deque<SquashEvent> squashes[MaxThreads];
+};
+
+} // namespace o3
+} // namespace gem5
+
+#endif // __CPU_O3_PIPE_TRACE_HH__
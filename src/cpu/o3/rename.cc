@@ -908,11 +908,9 @@ Rename::sortInsts()
         } else {
             insts[inst->threadNumber].push_back(inst);
         }
-#if TRACING_ON
-        if (debug::O3PipeView) {
+        if (inst->fetchTick != -1) {
             inst->renameTick = curTick() - inst->fetchTick;
         }
-#endif
     }
 }
 
@@ -948,3 +948,7 @@ class DecoupledBPUWithFTB(BranchPredictor):
     enableLoopBuffer = Param.Bool(False, "Enable loop buffer to supply inst for loops")
     enableLoopPredictor = Param.Bool(False, "Use loop predictor to predict loop exit")
     enableJumpAheadPredictor = Param.Bool(False, "Use jump ahead predictor to skip no-need-to-predict blocks")
+    bpStateRestoreFile = Param.String("", "Restore trained predictor tables "
+        "and histories from this file at startup")
+    bpStateDumpFile = Param.String("", "Dump trained predictor tables and "
+        "histories to this file (relative to outdir) at exit")
@@ -0,0 +1,211 @@
+#include "cpu/pred/ftb/bp_state.hh"
+
+#include <zlib.h>
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+namespace ftb_pred
+{
+
+namespace
+{
+
+template <class T>
+void
+gzPut(gzFile f, const T &val, const std::string &path)
+{
+    if (gzwrite(f, &val, sizeof(T)) != (int)sizeof(T))
+        fatal("Write failed on predictor state file '%s'\n", path);
+}
+
+template <class T>
+bool
+gzGet(gzFile f, T &val)
+{
+    return gzread(f, &val, sizeof(T)) == (int)sizeof(T);
+}
+
+} // anonymous namespace
+
+void
+BPStateWriter::beginSection(const std::string &name, BPState::Kind kind,
+                            uint32_t elem_size, uint64_t num_elems)
+{
+    panic_if(inSection, "Nested predictor state section %s\n", name);
+    curName = _scope.empty() ? name : _scope + "." + name;
+    cur.kind = kind;
+    cur.elemSize = elem_size;
+    cur.numElems = num_elems;
+    cur.data.clear();
+    cur.data.reserve(kind == BPState::History ?
+                     (num_elems + 7) / 8 : elem_size * num_elems);
+    inSection = true;
+}
+
+void
+BPStateWriter::endSection()
+{
+    panic_if(!inSection, "No predictor state section is open\n");
+    uint64_t expected = cur.kind == BPState::History ?
+        (cur.numElems + 7) / 8 : cur.elemSize * cur.numElems;
+    panic_if(cur.data.size() != expected,
+             "Predictor state section %s has %d bytes, expected %d\n",
+             curName, cur.data.size(), expected);
+    sections.emplace_back(curName, std::move(cur));
+    cur = BPState::Section();
+    inSection = false;
+}
+
+void
+BPStateWriter::putHistory(const std::string &name,
+                          const boost::dynamic_bitset<> &hist)
+{
+    beginSection(name, BPState::History, 1, hist.size());
+    for (size_t i = 0; i < hist.size(); i += 8) {
+        uint8_t byte = 0;
+        for (size_t b = 0; b < 8 && i + b < hist.size(); b++) {
+            byte |= hist[i + b] << b;
+        }
+        put<uint8_t>(byte);
+    }
+    endSection();
+}
+
+void
+BPStateWriter::write(const std::string &path) const
+{
+    gzFile f = gzopen(path.c_str(), "wb");
+    if (f == NULL)
+        fatal("Can't open predictor state file '%s'\n", path);
+
+    if (gzwrite(f, BPState::magic, sizeof(BPState::magic)) !=
+            (int)sizeof(BPState::magic)) {
+        fatal("Write failed on predictor state file '%s'\n", path);
+    }
+    gzPut(f, BPState::version, path);
+    gzPut(f, (uint32_t)sections.size(), path);
+
+    for (const auto &[name, sec] : sections) {
+        gzPut(f, (uint16_t)name.size(), path);
+        if (gzwrite(f, name.data(), name.size()) != (int)name.size())
+            fatal("Write failed on predictor state file '%s'\n", path);
+        gzPut(f, sec.kind, path);
+        gzPut(f, sec.elemSize, path);
+        gzPut(f, sec.numElems, path);
+        if (!sec.data.empty() &&
+                gzwrite(f, sec.data.data(), sec.data.size()) !=
+                (int)sec.data.size()) {
+            fatal("Write failed on predictor state file '%s'\n", path);
+        }
+    }
+
+    if (gzclose(f))
+        fatal("Close failed on predictor state file '%s'\n", path);
+}
+
+bool
+BPStateReader::read(const std::string &path)
+{
+    gzFile f = gzopen(path.c_str(), "rb");
+    if (f == NULL) {
+        warn("Can't open predictor state file '%s'\n", path);
+        return false;
+    }
+
+    char magic[sizeof(BPState::magic)];
+    uint32_t version = 0, num_sections = 0;
+    bool ok = gzread(f, magic, sizeof(magic)) == (int)sizeof(magic) &&
+        std::memcmp(magic, BPState::magic, sizeof(magic)) == 0 &&
+        gzGet(f, version) && gzGet(f, num_sections);
+    if (ok && version != BPState::version) {
+        warn("Predictor state file '%s' has version %d, expected %d\n",
+             path, version, BPState::version);
+        ok = false;
+    }
+
+    for (uint32_t i = 0; ok && i < num_sections; i++) {
+        uint16_t name_len;
+        BPState::Section sec;
+        ok = gzGet(f, name_len);
+        std::string name(name_len, '\0');
+        ok = ok && gzread(f, name.data(), name_len) == (int)name_len &&
+            gzGet(f, sec.kind) && gzGet(f, sec.elemSize) &&
+            gzGet(f, sec.numElems);
+        if (!ok)
+            break;
+        uint64_t bytes = sec.kind == BPState::History ?
+            (sec.numElems + 7) / 8 : sec.elemSize * sec.numElems;
+        sec.data.resize(bytes);
+        ok = bytes == 0 ||
+            gzread(f, sec.data.data(), bytes) == (int)bytes;
+        sections[name] = std::move(sec);
+    }
+    gzclose(f);
+
+    if (!ok) {
+        warn("Predictor state file '%s' is malformed, ignoring it\n", path);
+        sections.clear();
+    }
+    return ok;
+}
+
+bool
+BPStateReader::beginSection(const std::string &name, BPState::Kind kind,
+                            uint32_t elem_size, uint64_t num_elems)
+{
+    panic_if(cur, "Nested predictor state section %s\n", name);
+    std::string full_name = _scope.empty() ? name : _scope + "." + name;
+    auto it = sections.find(full_name);
+    if (it == sections.end()) {
+        warn("Predictor state section %s not found, left cold\n",
+             full_name);
+        return false;
+    }
+    const auto &sec = it->second;
+    if (sec.kind != kind || sec.elemSize != elem_size ||
+            sec.numElems != num_elems) {
+        warn("Predictor state section %s has geometry %dx%d, expected "
+             "%dx%d, left cold\n", full_name, sec.numElems, sec.elemSize,
+             num_elems, elem_size);
+        return false;
+    }
+    cur = &sec;
+    pos = 0;
+    return true;
+}
+
+void
+BPStateReader::endSection()
+{
+    panic_if(!cur, "No predictor state section is open\n");
+    panic_if(pos != cur->data.size(),
+             "Predictor state section has %d unread bytes\n",
+             cur->data.size() - pos);
+    cur = nullptr;
+}
+
+bool
+BPStateReader::getHistory(const std::string &name,
+                          boost::dynamic_bitset<> &hist)
+{
+    if (!beginSection(name, BPState::History, 1, hist.size()))
+        return false;
+    for (size_t i = 0; i < hist.size(); i += 8) {
+        uint8_t byte = get<uint8_t>();
+        for (size_t b = 0; b < 8 && i + b < hist.size(); b++) {
+            hist[i + b] = (byte >> b) & 1;
+        }
+    }
+    endSection();
+    return true;
+}
+
+} // namespace ftb_pred
+
+} // namespace branch_prediction
+
+} // namespace gem5
@@ -0,0 +1,152 @@
+#ifndef __CPU_PRED_FTB_BP_STATE_HH__
+#define __CPU_PRED_FTB_BP_STATE_HH__
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace branch_prediction
+{
+
+namespace ftb_pred
+{
+
+/**
+ * Binary container for saved predictor tables and histories.
+ *
+ * The file is a gzip stream with the following little-endian layout:
+ *   char     magic[8]      "XSBPSTAT"
+ *   uint32_t version
+ *   uint32_t numSections
+ * followed by numSections sections, each of them being
+ *   uint16_t nameLen, char name[nameLen]
+ *   uint8_t  kind         (see Kind)
+ *   uint32_t elemSize     (bytes per element)
+ *   uint64_t numElems
+ *   uint8_t  data[elemSize * numElems]
+ *
+ * Section names are "<component>.<table>", e.g. "tage.T0". The kind tells
+ * util/bpstate_merge.py how to combine the section when merging states
+ * trained on different intervals.
+ */
+struct BPState
+{
+    static constexpr char magic[8] = {'X', 'S', 'B', 'P', 'S', 'T', 'A', 'T'};
+    static constexpr uint32_t version = 1;
+
+    enum Kind : uint8_t
+    {
+        /** Opaque data, the primary input wins when merging. */
+        Raw = 0,
+        /** Signed saturating counters of elemSize bytes, averaged. */
+        Counters = 1,
+        /** Table entries whose first byte is a valid flag. */
+        Entries = 2,
+        /** A history bit vector, numElems is the number of bits. */
+        History = 3
+    };
+
+    struct Section
+    {
+        Kind kind;
+        uint32_t elemSize;
+        uint64_t numElems;
+        std::vector<uint8_t> data;
+    };
+};
+
+class BPStateWriter
+{
+  public:
+    /** Prefix prepended to every section name, usually the component. */
+    void setScope(const std::string &scope) { _scope = scope; }
+
+    void beginSection(const std::string &name, BPState::Kind kind,
+                      uint32_t elem_size, uint64_t num_elems);
+
+    template <class T>
+    void
+    put(T val)
+    {
+        static_assert(std::is_arithmetic_v<T>, "Only scalars are stored");
+        panic_if(!inSection,
+                 "Writing predictor state outside of a section\n");
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(&val);
+        cur.data.insert(cur.data.end(), p, p + sizeof(T));
+    }
+
+    void endSection();
+
+    /** Store a history bit vector as a section of its own. */
+    void putHistory(const std::string &name,
+                    const boost::dynamic_bitset<> &hist);
+
+    /** Write all sections to path, fatal on I/O errors. */
+    void write(const std::string &path) const;
+
+  private:
+    std::string _scope;
+    std::vector<std::pair<std::string, BPState::Section>> sections;
+    std::string curName;
+    BPState::Section cur;
+    bool inSection = false;
+};
+
+class BPStateReader
+{
+  public:
+    /** Load a state file, returns false if it is missing or malformed. */
+    bool read(const std::string &path);
+
+    void setScope(const std::string &scope) { _scope = scope; }
+
+    /**
+     * Open a section for reading. A missing section or one whose geometry
+     * differs from the expected one is reported and skipped, leaving the
+     * corresponding table cold.
+     */
+    bool beginSection(const std::string &name, BPState::Kind kind,
+                      uint32_t elem_size, uint64_t num_elems);
+
+    template <class T>
+    T
+    get()
+    {
+        static_assert(std::is_arithmetic_v<T>, "Only scalars are stored");
+        panic_if(!cur || pos + sizeof(T) > cur->data.size(),
+                 "Reading past the end of a predictor state section\n");
+        T val;
+        std::memcpy(&val, cur->data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return val;
+    }
+
+    void endSection();
+
+    /** Restore a history written by putHistory, hist keeps its size. */
+    bool getHistory(const std::string &name, boost::dynamic_bitset<> &hist);
+
+  private:
+    std::string _scope;
+    std::map<std::string, BPState::Section> sections;
+    const BPState::Section *cur = nullptr;
+    size_t pos = 0;
+};
+
+} // namespace ftb_pred
+
+} // namespace branch_prediction
+
+} // namespace gem5
+
+#endif // __CPU_PRED_FTB_BP_STATE_HH__
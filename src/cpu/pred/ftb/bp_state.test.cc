@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+#include <zlib.h>
+
+#include <cstdint>
+#include <string>
+
+#include "base/gtest/logging.hh"
+#include "cpu/pred/ftb/bp_state.hh"
+
+using namespace gem5;
+using namespace gem5::branch_prediction::ftb_pred;
+
+namespace
+{
+
+/** A predictor state file, removed at the end of the test. */
+class BPStateTest : public testing::Test
+{
+  protected:
+    std::string path;
+
+    void
+    SetUp() override
+    {
+        char name[] = "bp_state-XXXXXX";
+        const int fd = mkstemp(name);
+        ASSERT_NE(fd, -1);
+        close(fd);
+        path = name;
+    }
+
+    void TearDown() override { unlink(path.c_str()); }
+
+    /** A table of 16 bit counters and a table of entries, in scope. */
+    void
+    writeTables(BPStateWriter &writer, const std::string &scope)
+    {
+        writer.setScope(scope);
+        writer.beginSection("T0", BPState::Counters, 2, 3);
+        for (int16_t ctr : {-4, 0, 3})
+            writer.put<int16_t>(ctr);
+        writer.endSection();
+        writer.beginSection("entries", BPState::Entries, 9, 2);
+        for (uint64_t tag : {0x1234ULL, 0xfedcba9876543210ULL}) {
+            writer.put<uint8_t>(true);
+            writer.put<uint64_t>(tag);
+        }
+        writer.endSection();
+    }
+
+    /** Write raw bytes through gzip, as a state file would be. */
+    void
+    writeRaw(const std::string &bytes)
+    {
+        gzFile f = gzopen(path.c_str(), "wb");
+        ASSERT_NE(f, nullptr);
+        ASSERT_EQ(gzwrite(f, bytes.data(), bytes.size()), (int)bytes.size());
+        ASSERT_EQ(gzclose(f), Z_OK);
+    }
+};
+
+} // anonymous namespace
+
+TEST_F(BPStateTest, RoundTrip)
+{
+    BPStateWriter writer;
+    writeTables(writer, "tage");
+    writeTables(writer, "ittage");
+    writer.write(path);
+
+    BPStateReader reader;
+    ASSERT_TRUE(reader.read(path));
+    reader.setScope("ittage");
+    ASSERT_TRUE(reader.beginSection("T0", BPState::Counters, 2, 3));
+    EXPECT_EQ(reader.get<int16_t>(), -4);
+    EXPECT_EQ(reader.get<int16_t>(), 0);
+    EXPECT_EQ(reader.get<int16_t>(), 3);
+    reader.endSection();
+    ASSERT_TRUE(reader.beginSection("entries", BPState::Entries, 9, 2));
+    EXPECT_EQ(reader.get<uint8_t>(), 1);
+    EXPECT_EQ(reader.get<uint64_t>(), 0x1234);
+    EXPECT_EQ(reader.get<uint8_t>(), 1);
+    EXPECT_EQ(reader.get<uint64_t>(), 0xfedcba9876543210ULL);
+    reader.endSection();
+}
+
+/** Histories keep their bits, including a last partial byte. */
+TEST_F(BPStateTest, History)
+{
+    boost::dynamic_bitset<> hist(21);
+    for (size_t i : {0, 3, 7, 8, 15, 20})
+        hist[i] = true;
+    BPStateWriter writer;
+    writer.setScope("bpu");
+    writer.putHistory("ghr", hist);
+    writer.write(path);
+
+    BPStateReader reader;
+    ASSERT_TRUE(reader.read(path));
+    reader.setScope("bpu");
+    boost::dynamic_bitset<> restored(21);
+    ASSERT_TRUE(reader.getHistory("ghr", restored));
+    EXPECT_EQ(restored, hist);
+
+    boost::dynamic_bitset<> longer(22);
+    gtestLogOutput.str("");
+    EXPECT_FALSE(reader.getHistory("ghr", longer));
+    EXPECT_TRUE(longer.none());
+}
+
+/** Sections which are missing or of another geometry are left cold. */
+TEST_F(BPStateTest, LeftCold)
+{
+    BPStateWriter writer;
+    writeTables(writer, "tage");
+    writer.write(path);
+
+    BPStateReader reader;
+    ASSERT_TRUE(reader.read(path));
+    gtestLogOutput.str("");
+    EXPECT_FALSE(reader.beginSection("T0", BPState::Counters, 2, 3));
+    EXPECT_NE(gtestLogOutput.str().find("T0 not found"), std::string::npos);
+
+    reader.setScope("tage");
+    gtestLogOutput.str("");
+    EXPECT_FALSE(reader.beginSection("T0", BPState::Counters, 2, 4));
+    EXPECT_FALSE(reader.beginSection("T0", BPState::Counters, 1, 3));
+    EXPECT_FALSE(reader.beginSection("T0", BPState::Raw, 2, 3));
+    EXPECT_NE(gtestLogOutput.str().find("geometry"), std::string::npos);
+
+    // The mismatches did not leave a section open, and sections are
+    // named in their scope.
+    ASSERT_TRUE(reader.beginSection("T0", BPState::Counters, 2, 3));
+}
+
+TEST_F(BPStateTest, ReadPastSection)
+{
+    BPStateWriter writer;
+    writeTables(writer, "tage");
+    writer.write(path);
+
+    BPStateReader reader;
+    ASSERT_TRUE(reader.read(path));
+    reader.setScope("tage");
+    ASSERT_TRUE(reader.beginSection("T0", BPState::Counters, 2, 3));
+    reader.get<uint32_t>();
+    EXPECT_ANY_THROW(reader.get<uint32_t>());
+    EXPECT_ANY_THROW(reader.endSection());
+}
+
+TEST_F(BPStateTest, WrongSize)
+{
+    BPStateWriter writer;
+    writer.beginSection("T0", BPState::Counters, 2, 3);
+    writer.put<int16_t>(1);
+    EXPECT_ANY_THROW(writer.endSection());
+}
+
+TEST_F(BPStateTest, Malformed)
+{
+    BPStateReader reader;
+    gtestLogOutput.str("");
+
+    writeRaw("XSBPSTA");
+    EXPECT_FALSE(reader.read(path));
+    EXPECT_NE(gtestLogOutput.str().find("malformed"), std::string::npos);
+
+    writeRaw("NOTSTATE" + std::string(8, '\0'));
+    EXPECT_FALSE(reader.read(path));
+
+    // A version from the future.
+    std::string header(BPState::magic, sizeof(BPState::magic));
+    const uint32_t version = BPState::version + 1, num_sections = 0;
+    header.append(reinterpret_cast<const char *>(&version), 4);
+    header.append(reinterpret_cast<const char *>(&num_sections), 4);
+    gtestLogOutput.str("");
+    writeRaw(header);
+    EXPECT_FALSE(reader.read(path));
+    EXPECT_NE(gtestLogOutput.str().find("version"), std::string::npos);
+
+    // A section cut short drops the whole file.
+    BPStateWriter writer;
+    writeTables(writer, "tage");
+    writer.write(path);
+    std::string bytes(256, '\0');
+    gzFile f = gzopen(path.c_str(), "rb");
+    ASSERT_NE(f, nullptr);
+    bytes.resize(gzread(f, bytes.data(), bytes.size()));
+    gzclose(f);
+    writeRaw(bytes.substr(0, bytes.size() - 1));
+    EXPECT_FALSE(reader.read(path));
+    reader.setScope("tage");
+    gtestLogOutput.str("");
+    EXPECT_FALSE(reader.beginSection("T0", BPState::Counters, 2, 3));
+
+    unlink(path.c_str());
+    EXPECT_FALSE(reader.read(path));
+}
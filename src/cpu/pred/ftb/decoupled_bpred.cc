@@ -39,6 +39,8 @@ DecoupledBPUWithFTB::DecoupledBPUWithFTB(const DecoupledBPUWithFTBParams &p)
       uras(p.uras),
     //   enableDB(p.enableBPDB),
       bpDBSwitches(p.bpDBSwitches),
+      bpStateRestoreFile(p.bpStateRestoreFile),
+      bpStateDumpFile(p.bpStateDumpFile),
       numStages(p.numStages),
       historyManager(p.numBr),
       dbpFtbStats(this, p.numStages, p.fsq_size)
@@ -99,6 +101,7 @@ DecoupledBPUWithFTB::DecoupledBPUWithFTB(const DecoupledBPUWithFTBParams &p)
     components.push_back(tage);
     components.push_back(ras);
     components.push_back(ittage);
+    componentStateNames = {"uftb", "uras", "ftb", "tage", "ras", "ittage"};
     numComponents = components.size();
     for (int i = 0; i < numComponents; i++) {
         components[i]->setComponentIdx(i);
@@ -149,6 +152,12 @@ DecoupledBPUWithFTB::DecoupledBPUWithFTB(const DecoupledBPUWithFTBParams &p)
     commitFsqEntryFetchedInstsVector.resize(16+1, 0);
     lastPhaseFsqEntryNumFetchedInstDist.resize(16+1, 0);
 
+    if (!bpStateDumpFile.empty()) {
+        registerExitCallback([this]() {
+            saveBPState(simout.resolve(bpStateDumpFile));
+        });
+    }
+
     registerExitCallback([this]() {
         auto out_handle = simout.create("topMisPredicts.txt", false, true);
         *out_handle->stream() << "startPC" << " " << "control pc" << " " << "count" << std::endl;
@@ -2513,6 +2522,70 @@ DecoupledBPUWithFTB::getPreservedReturnAddr(const DynInstPtr &dynInst)
     return retAddr;
 }
 
+void
+DecoupledBPUWithFTB::saveBPState(const std::string &path) const
+{
+    BPStateWriter writer;
+    for (int i = 0; i < numComponents; i++) {
+        writer.setScope(componentStateNames[i]);
+        components[i]->saveState(writer);
+    }
+    // the folded histories saved by the components follow s0History, so
+    // save the speculative one; it equals commitHistory once drained
+    writer.setScope("bpu");
+    writer.putHistory("history", s0History);
+    writer.write(path);
+    inform("Saved branch predictor state to %s\n", path);
+}
+
+bool
+DecoupledBPUWithFTB::restoreBPState(const std::string &path)
+{
+    BPStateReader reader;
+    if (!reader.read(path)) {
+        return false;
+    }
+    for (int i = 0; i < numComponents; i++) {
+        reader.setScope(componentStateNames[i]);
+        components[i]->restoreState(reader);
+    }
+    reader.setScope("bpu");
+    if (reader.getHistory("history", s0History)) {
+        commitHistory = s0History;
+    }
+    inform("Restored branch predictor state from %s\n", path);
+    return true;
+}
+
+void
+DecoupledBPUWithFTB::startup()
+{
+    BPredUnit::startup();
+    if (!bpStateRestoreFile.empty()) {
+        fatal_if(!restoreBPState(bpStateRestoreFile),
+                 "Failed to restore branch predictor state from %s\n",
+                 bpStateRestoreFile);
+    }
+}
+
+void
+DecoupledBPUWithFTB::serialize(CheckpointOut &cp) const
+{
+    std::string bp_state_file = name() + ".bpstate";
+    SERIALIZE_SCALAR(bp_state_file);
+    saveBPState(CheckpointIn::dir() + "/" + bp_state_file);
+}
+
+void
+DecoupledBPUWithFTB::unserialize(CheckpointIn &cp)
+{
+    std::string bp_state_file;
+    // checkpoints taken without predictor state start cold
+    if (UNSERIALIZE_OPT_SCALAR(bp_state_file)) {
+        restoreBPState(cp.getCptDir() + "/" + bp_state_file);
+    }
+}
+
 }  // namespace ftb_pred
 
 }  // namespace branch_prediction
@@ -255,6 +255,10 @@ class DecoupledBPUWithFTB : public BPredUnit
 
 
     std::vector<TimedBaseFTBPredictor*> components{};
+    // section prefixes of each component in the predictor state file
+    std::vector<std::string> componentStateNames{};
+    std::string bpStateRestoreFile;
+    std::string bpStateDumpFile;
     std::vector<FullFTBPrediction> predsOfEachStage{};
     unsigned numComponents{};
     unsigned numStages{};
@@ -749,6 +753,18 @@ class DecoupledBPUWithFTB : public BPredUnit
 
     void notifyInstCommit(const DynInstPtr &inst);
 
+    /** Save all predictor tables and histories to a state file. */
+    void saveBPState(const std::string &path) const;
+
+    /** Restore predictor tables and histories, returns false on failure. */
+    bool restoreBPState(const std::string &path);
+
+    void startup() override;
+
+    void serialize(CheckpointOut &cp) const override;
+
+    void unserialize(CheckpointIn &cp) override;
+
     std::map<Addr, unsigned> topMispredIndirect;
 
     int currentFtqEntryInstNum{0};
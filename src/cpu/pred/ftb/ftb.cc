@@ -26,6 +26,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <algorithm>
 
 #include "base/intmath.hh"
 #include "base/trace.hh"
@@ -567,6 +568,125 @@ DefaultFTB::commitBranch(const FetchStream &stream, const DynInstPtr &inst)
     }
 }
 
+void
+DefaultFTB::saveState(BPStateWriter &writer)
+{
+    // lets util/bpstate_merge.py merge the table set by set
+    writer.beginSection("ways", BPState::Raw, sizeof(uint32_t), 1);
+    writer.put<uint32_t>(numWays);
+    writer.endSection();
+
+    writer.beginSection("table", BPState::Entries, stateEntrySize(),
+                        numSets * numWays);
+    for (unsigned s = 0; s < numSets; ++s) {
+        assert(ftb[s].size() == numWays);
+        // ticks are meaningless in another run, store the LRU rank instead
+        std::vector<FTBMapIter> ways;
+        for (auto it = ftb[s].begin(); it != ftb[s].end(); it++) {
+            ways.push_back(it);
+        }
+        std::stable_sort(ways.begin(), ways.end(),
+            [](const FTBMapIter &a, const FTBMapIter &b) {
+                return a->second.tick < b->second.tick;
+            });
+        for (unsigned rank = 0; rank < numWays; ++rank) {
+            const auto &e = ways[rank]->second;
+            writer.put<uint8_t>(e.valid);
+            writer.put<uint8_t>(e.slots.size());
+            writer.put<uint8_t>(e.tid);
+            writer.put<uint64_t>(ways[rank]->first);
+            writer.put<uint64_t>(rank);
+            writer.put<uint64_t>(e.tag);
+            writer.put<uint64_t>(e.fallThruAddr);
+            for (unsigned b = 0; b < numBr; ++b) {
+                if (b >= e.slots.size()) {
+                    writer.put<uint64_t>(0);
+                    writer.put<uint64_t>(0);
+                    writer.put<uint8_t>(0);
+                    writer.put<uint8_t>(0);
+                    writer.put<int32_t>(0);
+                    continue;
+                }
+                const auto &slot = e.slots[b];
+                uint8_t flags = slot.valid | slot.isCond << 1 |
+                    slot.isIndirect << 2 | slot.isCall << 3 |
+                    slot.isReturn << 4 | slot.alwaysTaken << 5;
+                writer.put<uint64_t>(slot.pc);
+                writer.put<uint64_t>(slot.target);
+                writer.put<uint8_t>(slot.size);
+                writer.put<uint8_t>(flags);
+                writer.put<int32_t>(slot.ctr);
+            }
+        }
+    }
+    writer.endSection();
+}
+
+void
+DefaultFTB::restoreState(BPStateReader &reader)
+{
+    if (reader.beginSection("ways", BPState::Raw, sizeof(uint32_t), 1)) {
+        uint32_t ways = reader.get<uint32_t>();
+        reader.endSection();
+        if (ways != numWays) {
+            warn("%s: saved FTB has %d ways instead of %d, not restored\n",
+                 name(), ways, numWays);
+            return;
+        }
+    }
+    if (!reader.beginSection("table", BPState::Entries, stateEntrySize(),
+                             numSets * numWays)) {
+        return;
+    }
+    for (unsigned s = 0; s < numSets; ++s) {
+        ftb[s].clear();
+        mruList[s].clear();
+        for (unsigned w = 0; w < numWays; ++w) {
+            TickedFTBEntry e;
+            e.valid = reader.get<uint8_t>();
+            unsigned num_slots = reader.get<uint8_t>();
+            e.tid = reader.get<uint8_t>();
+            Addr key = reader.get<uint64_t>();
+            // older ways get smaller ticks, everything looked up from
+            // now on is younger than the restored entries
+            e.tick = reader.get<uint64_t>();
+            e.tag = reader.get<uint64_t>();
+            e.fallThruAddr = reader.get<uint64_t>();
+            for (unsigned b = 0; b < numBr; ++b) {
+                FTBSlot slot;
+                slot.pc = reader.get<uint64_t>();
+                slot.target = reader.get<uint64_t>();
+                slot.size = reader.get<uint8_t>();
+                uint8_t flags = reader.get<uint8_t>();
+                slot.ctr = reader.get<int32_t>();
+                slot.valid = flags & 1;
+                slot.isCond = flags & 2;
+                slot.isIndirect = flags & 4;
+                slot.isCall = flags & 8;
+                slot.isReturn = flags & 16;
+                slot.alwaysTaken = flags & 32;
+                if (b < num_slots) {
+                    e.slots.push_back(slot);
+                }
+            }
+            auto [it, inserted] = ftb[s].emplace(key, e);
+            if (!inserted) {
+                // a tag can only be in one way, e.g. after a bad merge;
+                // keep the set full with a dummy way like a cold one
+                e.valid = false;
+                Addr dummy = 0xfffffff - w;
+                while (ftb[s].count(dummy)) {
+                    dummy--;
+                }
+                it = ftb[s].emplace(dummy, e).first;
+            }
+            mruList[s].push_back(it);
+        }
+        std::make_heap(mruList[s].begin(), mruList[s].end(), older());
+    }
+    reader.endSection();
+}
+
 DefaultFTB::FTBStats::FTBStats(statistics::Group* parent) :
     statistics::Group(parent),
     ADD_STAT(newEntry, statistics::units::Count::get(), "number of new ftb entries generated"),
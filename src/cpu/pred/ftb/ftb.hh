@@ -122,6 +122,10 @@ class DefaultFTB : public TimedBaseFTBPredictor
 
     void commitBranch(const FetchStream &stream, const DynInstPtr &inst) override;
 
+    void saveState(BPStateWriter &writer) override;
+
+    void restoreState(BPStateReader &reader) override;
+
     /**
      * @brief derive new ftb entry from old ones and set updateFTBEntry field in stream
      *        only in L1FTB will this function be called when update
@@ -216,6 +220,9 @@ class DefaultFTB : public TimedBaseFTBPredictor
 
     bool isL0() { return getDelay() == 0; }
 
+    /** Bytes per FTB way in the predictor state file. */
+    unsigned stateEntrySize() { return 35 + numBr * 22; }
+
     void updateCtr(int &ctr, bool taken) {
         if (taken && ctr < 1) {ctr++;}
         if (!taken && ctr > -2) {ctr--;}
@@ -519,6 +519,64 @@ FTBITTAGE::commitBranch(const FetchStream &stream, const DynInstPtr &inst)
 {
 }
 
+void
+FTBITTAGE::saveState(BPStateWriter &writer)
+{
+    for (int t = 0; t < numPredictors; t++) {
+        writer.beginSection("T" + std::to_string(t), BPState::Entries, 20,
+                            tableSizes[t]);
+        for (auto &entry : tageTable[t]) {
+            writer.put<uint8_t>(entry.valid);
+            writer.put<uint8_t>(entry.useful);
+            writer.put<int16_t>(entry.counter);
+            writer.put<uint64_t>(entry.tag);
+            writer.put<uint64_t>(entry.target);
+        }
+        writer.endSection();
+        writer.putHistory("idxHist" + std::to_string(t),
+                          indexFoldedHist[t].get());
+        writer.putHistory("tagHist" + std::to_string(t),
+                          tagFoldedHist[t].get());
+        writer.putHistory("altTagHist" + std::to_string(t),
+                          altTagFoldedHist[t].get());
+    }
+
+    writer.beginSection("misc", BPState::Raw, sizeof(uint64_t), 2);
+    writer.put<uint64_t>(allocLFSR.lfsr);
+    writer.put<int64_t>(usefulResetCnt);
+    writer.endSection();
+}
+
+void
+FTBITTAGE::restoreState(BPStateReader &reader)
+{
+    for (int t = 0; t < numPredictors; t++) {
+        if (reader.beginSection("T" + std::to_string(t), BPState::Entries,
+                                20, tableSizes[t])) {
+            for (auto &entry : tageTable[t]) {
+                entry.valid = reader.get<uint8_t>();
+                entry.useful = reader.get<uint8_t>();
+                entry.counter = reader.get<int16_t>();
+                entry.tag = reader.get<uint64_t>();
+                entry.target = reader.get<uint64_t>();
+            }
+            reader.endSection();
+        }
+        reader.getHistory("idxHist" + std::to_string(t),
+                          indexFoldedHist[t].get());
+        reader.getHistory("tagHist" + std::to_string(t),
+                          tagFoldedHist[t].get());
+        reader.getHistory("altTagHist" + std::to_string(t),
+                          altTagFoldedHist[t].get());
+    }
+
+    if (reader.beginSection("misc", BPState::Raw, sizeof(uint64_t), 2)) {
+        allocLFSR.lfsr = reader.get<uint64_t>();
+        usefulResetCnt = reader.get<int64_t>();
+        reader.endSection();
+    }
+}
+
 } // namespace ftb_pred
 
 }  // namespace branch_prediction
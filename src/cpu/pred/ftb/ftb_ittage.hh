@@ -99,6 +99,10 @@ class FTBITTAGE : public TimedBaseFTBPredictor
 
     void commitBranch(const FetchStream &stream, const DynInstPtr &inst) override;
 
+    void saveState(BPStateWriter &writer) override;
+
+    void restoreState(BPStateReader &reader) override;
+
     // check folded hists after speculative update and recover
     void checkFoldedHist(const bitset &history, const char *when);
 
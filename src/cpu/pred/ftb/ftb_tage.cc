@@ -864,6 +864,59 @@ FTBTAGE::StatisticalCorrector::doUpdateHist(const boost::dynamic_bitset<> &histo
     }
 }
 
+void
+FTBTAGE::StatisticalCorrector::saveState(BPStateWriter &writer)
+{
+    for (int t = 0; t < numPredictors; t++) {
+        writer.beginSection("sc.T" + std::to_string(t), BPState::Counters,
+                            sizeof(int32_t), tableSizes[t] * numBr * 2);
+        for (auto &br_counters : scCntTable[t]) {
+            for (auto &tOrNt : br_counters) {
+                for (auto ctr : tOrNt) {
+                    writer.put<int32_t>(ctr);
+                }
+            }
+        }
+        writer.endSection();
+        writer.putHistory("sc.hist" + std::to_string(t), foldedHist[t].get());
+    }
+    writer.beginSection("sc.thresholds", BPState::Counters, sizeof(int32_t),
+                        numBr * 2);
+    for (int b = 0; b < numBr; b++) {
+        writer.put<int32_t>(thresholds[b]);
+        writer.put<int32_t>(TCs[b]);
+    }
+    writer.endSection();
+}
+
+void
+FTBTAGE::StatisticalCorrector::restoreState(BPStateReader &reader)
+{
+    for (int t = 0; t < numPredictors; t++) {
+        if (reader.beginSection("sc.T" + std::to_string(t),
+                BPState::Counters, sizeof(int32_t),
+                tableSizes[t] * numBr * 2)) {
+            for (auto &br_counters : scCntTable[t]) {
+                for (auto &tOrNt : br_counters) {
+                    for (auto &ctr : tOrNt) {
+                        ctr = reader.get<int32_t>();
+                    }
+                }
+            }
+            reader.endSection();
+        }
+        reader.getHistory("sc.hist" + std::to_string(t), foldedHist[t].get());
+    }
+    if (reader.beginSection("sc.thresholds", BPState::Counters,
+                            sizeof(int32_t), numBr * 2)) {
+        for (int b = 0; b < numBr; b++) {
+            thresholds[b] = reader.get<int32_t>();
+            TCs[b] = reader.get<int32_t>();
+        }
+        reader.endSection();
+    }
+}
+
 FTBTAGE::TageBankStats::TageBankStats(statistics::Group* parent, const char *name, int numPredictors):
     statistics::Group(parent, name),
     ADD_STAT(predTableHits, statistics::units::Count::get(), "hit of each tage table on prediction"),
@@ -945,6 +998,117 @@ FTBTAGE::commitBranch(const FetchStream &stream, const DynInstPtr &inst)
 {
 }
 
+void
+FTBTAGE::saveState(BPStateWriter &writer)
+{
+    for (int t = 0; t < numPredictors; t++) {
+        writer.beginSection("T" + std::to_string(t), BPState::Entries, 12,
+                            tableSizes[t] * numBr);
+        for (auto &way : tageTable[t]) {
+            for (auto &entry : way) {
+                writer.put<uint8_t>(entry.valid);
+                writer.put<uint8_t>(entry.useful);
+                writer.put<int16_t>(entry.counter);
+                writer.put<uint64_t>(entry.tag);
+            }
+        }
+        writer.endSection();
+        writer.putHistory("idxHist" + std::to_string(t),
+                          indexFoldedHist[t].get());
+        writer.putHistory("tagHist" + std::to_string(t),
+                          tagFoldedHist[t].get());
+        writer.putHistory("altTagHist" + std::to_string(t),
+                          altTagFoldedHist[t].get());
+    }
+
+    writer.beginSection("base", BPState::Counters, sizeof(int16_t),
+                        baseTable.size() * numBr);
+    for (auto &ctrs : baseTable) {
+        for (auto ctr : ctrs) {
+            writer.put<int16_t>(ctr);
+        }
+    }
+    writer.endSection();
+
+    writer.beginSection("useAlt", BPState::Counters, sizeof(int16_t),
+                        useAlt.size() * numBr);
+    for (auto &ctrs : useAlt) {
+        for (auto ctr : ctrs) {
+            writer.put<int16_t>(ctr);
+        }
+    }
+    writer.endSection();
+
+    writer.beginSection("misc", BPState::Raw, sizeof(uint64_t), numBr + 1);
+    writer.put<uint64_t>(allocLFSR.lfsr);
+    for (auto cnt : usefulResetCnt) {
+        writer.put<int64_t>(cnt);
+    }
+    writer.endSection();
+
+    if (enableSC) {
+        sc.saveState(writer);
+    }
+}
+
+void
+FTBTAGE::restoreState(BPStateReader &reader)
+{
+    for (int t = 0; t < numPredictors; t++) {
+        if (reader.beginSection("T" + std::to_string(t), BPState::Entries,
+                                12, tableSizes[t] * numBr)) {
+            for (auto &way : tageTable[t]) {
+                for (auto &entry : way) {
+                    entry.valid = reader.get<uint8_t>();
+                    entry.useful = reader.get<uint8_t>();
+                    entry.counter = reader.get<int16_t>();
+                    entry.tag = reader.get<uint64_t>();
+                }
+            }
+            reader.endSection();
+        }
+        reader.getHistory("idxHist" + std::to_string(t),
+                          indexFoldedHist[t].get());
+        reader.getHistory("tagHist" + std::to_string(t),
+                          tagFoldedHist[t].get());
+        reader.getHistory("altTagHist" + std::to_string(t),
+                          altTagFoldedHist[t].get());
+    }
+
+    if (reader.beginSection("base", BPState::Counters, sizeof(int16_t),
+                            baseTable.size() * numBr)) {
+        for (auto &ctrs : baseTable) {
+            for (auto &ctr : ctrs) {
+                ctr = reader.get<int16_t>();
+            }
+        }
+        reader.endSection();
+    }
+
+    if (reader.beginSection("useAlt", BPState::Counters, sizeof(int16_t),
+                            useAlt.size() * numBr)) {
+        for (auto &ctrs : useAlt) {
+            for (auto &ctr : ctrs) {
+                ctr = reader.get<int16_t>();
+            }
+        }
+        reader.endSection();
+    }
+
+    if (reader.beginSection("misc", BPState::Raw, sizeof(uint64_t),
+                            numBr + 1)) {
+        allocLFSR.lfsr = reader.get<uint64_t>();
+        for (auto &cnt : usefulResetCnt) {
+            cnt = reader.get<int64_t>();
+        }
+        reader.endSection();
+    }
+
+    if (enableSC) {
+        sc.restoreState(reader);
+    }
+}
+
 } // namespace ftb_pred
 
 }  // namespace branch_prediction
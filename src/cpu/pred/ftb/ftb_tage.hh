@@ -100,6 +100,10 @@ class FTBTAGE : public TimedBaseFTBPredictor
 
     void setTrace() override;
 
+    void saveState(BPStateWriter &writer) override;
+
+    void restoreState(BPStateReader &reader) override;
+
     // check folded hists after speculative update and recover
     void checkFoldedHist(const bitset &history, const char *when);
 
@@ -331,6 +335,10 @@ public:
           this->stats = stats;
         }
 
+        void saveState(BPStateWriter &writer);
+
+        void restoreState(BPStateReader &reader);
+
       private:
         int numBr;
 
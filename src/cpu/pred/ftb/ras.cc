@@ -262,6 +262,48 @@ RAS::pop()
     //}
 }
 
+void
+RAS::saveState(BPStateWriter &writer)
+{
+    // only the committed stack is meaningful outside of this run, the
+    // inflight stack holds speculative pushes
+    writer.beginSection("stack", BPState::Raw, 12, numEntries);
+    for (auto &entry : stack) {
+        writer.put<uint64_t>(entry.data.retAddr);
+        writer.put<uint32_t>(entry.data.ctr);
+    }
+    writer.endSection();
+    writer.beginSection("sp", BPState::Raw, sizeof(int32_t), 1);
+    writer.put<int32_t>(nsp);
+    writer.endSection();
+}
+
+void
+RAS::restoreState(BPStateReader &reader)
+{
+    if (reader.beginSection("stack", BPState::Raw, 12, numEntries)) {
+        for (auto &entry : stack) {
+            entry.data.retAddr = reader.get<uint64_t>();
+            entry.data.ctr = reader.get<uint32_t>();
+        }
+        reader.endSection();
+    }
+    if (reader.beginSection("sp", BPState::Raw, sizeof(int32_t), 1)) {
+        int sp = reader.get<int32_t>();
+        if (sp >= 0 && sp < (int)numEntries) {
+            nsp = sp;
+        }
+        reader.endSection();
+    }
+    // start from the committed stack with an empty inflight stack
+    ssp = nsp;
+    sctr = stack[nsp].data.ctr;
+    TOSW = 0;
+    TOSR = 0;
+    inflightPtrDec(TOSR);
+    BOS = 0;
+}
+
 void
 RAS::ptrInc(int &ptr)
 {
@@ -79,6 +79,10 @@ class RAS : public TimedBaseFTBPredictor
 
         void commitBranch(const FetchStream &stream, const DynInstPtr &inst) override;
 
+        void saveState(BPStateWriter &writer) override;
+
+        void restoreState(BPStateReader &reader) override;
+
         Addr getTopAddrFromMetas(const FetchStream &stream);
 
     private:
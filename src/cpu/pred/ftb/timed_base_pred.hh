@@ -8,6 +8,7 @@
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/dyn_inst_ptr.hh"
+#include "cpu/pred/ftb/bp_state.hh"
 #include "cpu/pred/ftb/stream_struct.hh"
 #include "sim/sim_object.hh"
 #include "params/TimedBaseFTBPredictor.hh"
@@ -46,6 +47,9 @@ class TimedBaseFTBPredictor: public SimObject
     virtual unsigned getDelay() {return 0;}
     // do some statistics on a per-branch and per-predictor basis
     virtual void commitBranch(const FetchStream &entry, const DynInstPtr &inst) {}
+    // save/restore trained tables and folded histories, see bp_state.hh
+    virtual void saveState(BPStateWriter &writer) {}
+    virtual void restoreState(BPStateReader &reader) {}
 
     int componentIdx;
     int getComponentIdx() { return componentIdx; }
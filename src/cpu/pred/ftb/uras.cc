@@ -222,6 +222,39 @@ uRAS::pop(std::vector<uRASEntry> &stack, int &sp)
     }
 }
 
+void
+uRAS::saveState(BPStateWriter &writer)
+{
+    // only the committed stack is meaningful outside of this run
+    writer.beginSection("stack", BPState::Raw, 12, numEntries);
+    for (auto &entry : nonSpecStack) {
+        writer.put<uint64_t>(entry.retAddr);
+        writer.put<uint32_t>(entry.ctr);
+    }
+    writer.endSection();
+    writer.beginSection("sp", BPState::Raw, sizeof(int32_t), 1);
+    writer.put<int32_t>(nonSpecSp);
+    writer.endSection();
+}
+
+void
+uRAS::restoreState(BPStateReader &reader)
+{
+    if (reader.beginSection("stack", BPState::Raw, 12, numEntries)) {
+        for (auto &entry : nonSpecStack) {
+            entry.retAddr = reader.get<uint64_t>();
+            entry.ctr = reader.get<uint32_t>();
+        }
+        reader.endSection();
+    }
+    if (reader.beginSection("sp", BPState::Raw, sizeof(int32_t), 1)) {
+        nonSpecSp = reader.get<int32_t>();
+        reader.endSection();
+    }
+    specStack = nonSpecStack;
+    specSp = nonSpecSp;
+}
+
 void
 uRAS::ptrInc(int &ptr)
 {
@@ -65,38 +65,25 @@ NonCachingSimpleCPU::verifyMemoryMode() const
 Tick
 NonCachingSimpleCPU::sendPacket(RequestPort &port, const PacketPtr &pkt)
 {
-    MemBackdoorPtr bd = nullptr;
-    Tick latency = port.sendAtomicBackdoor(pkt, bd);
-
-    // If the target gave us a backdoor for next time and we didn't
-    // already have it, record it.
-    if (bd && memBackdoors.insert(bd->range(), bd) != memBackdoors.end()) {
-        // Install a callback to erase this backdoor if it goes away.
-        auto callback = [this](const MemBackdoor &backdoor) {
-                for (auto it = memBackdoors.begin();
-                        it != memBackdoors.end(); it++) {
-                    if (it->second == &backdoor) {
-                        memBackdoors.erase(it);
-                        return;
-                    }
-                }
-                panic("Got invalidation for unknown memory backdoor.");
-            };
-        bd->addInvalidationCallback(callback);
-    }
-    return latency;
+    // Plain loads and stores to memory we hold a backdoor to go straight
+    // to host memory, like the instruction fetches below. A backdoor has
+    // no latency, so when data stalls are simulated the packets still go
+    // to the memory, which reports its latency.
+    if (!simulate_data_stalls && memBackdoors.access(pkt))
+        return 0;
+    return memBackdoors.sendAtomic(port, pkt);
 }
 
 Tick
 NonCachingSimpleCPU::fetchInstMem()
 {
-    auto bd_it = memBackdoors.contains(ifetch_req->getPaddr());
-    if (bd_it == memBackdoors.end())
+    auto *bd = memBackdoors.find(RangeSize(ifetch_req->getPaddr(),
+                                           ifetch_req->getSize()));
+    if (!bd)
         return AtomicSimpleCPU::fetchInstMem();
 
     auto &decoder = threadInfo[curThread]->thread->decoder;
 
-    auto *bd = bd_it->second;
     Addr offset = ifetch_req->getPaddr() - bd->range().start();
     memcpy(decoder->moreBytesPtr(), bd->ptr() + offset, ifetch_req->getSize());
     return 0;
@@ -38,9 +38,8 @@
 #ifndef __CPU_SIMPLE_NONCACHING_HH__
 #define __CPU_SIMPLE_NONCACHING_HH__
 
-#include "base/addr_range_map.hh"
 #include "cpu/simple/atomic.hh"
-#include "mem/backdoor.hh"
+#include "mem/backdoor_cache.hh"
 #include "params/BaseNonCachingSimpleCPU.hh"
 
 namespace gem5
@@ -58,7 +57,13 @@ class NonCachingSimpleCPU : public AtomicSimpleCPU
     void verifyMemoryMode() const override;
 
   protected:
-    AddrRangeMap<MemBackdoorPtr, 1> memBackdoors;
+    /**
+     * Backdoors to the memories, for fetches and plain loads and stores.
+     * Only this CPU uses them: in the 'atomic' mode of AtomicSimpleCPU
+     * the accesses go through the caches to warm them, and caches never
+     * hand out backdoors.
+     */
+    MemBackdoorCache memBackdoors;
 
     Tick sendPacket(RequestPort &port, const PacketPtr &pkt) override;
     Tick fetchInstMem() override;
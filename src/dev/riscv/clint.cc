@@ -68,6 +68,9 @@ Clint::raiseInterruptPin(int id)
     for (int context_id = 0; context_id < nThread; context_id++) {
 
         auto tc = system->threads[context_id];
+        // The core may be simulated on an event queue of its own
+        EventQueue::ScopedMigration migrate(tc->getCpuPtr()->eventQueue(),
+                                            inParallelMode);
 
         // Update misc reg file
         ISA* isa = dynamic_cast<ISA*>(tc->getIsaPtr());
@@ -133,6 +136,8 @@ Clint::readMSIP(Register32& reg, const int thread_id)
 {
     // To avoid discrepancies if mip is externally set using remote_gdb etc.
     auto tc = system->threads[thread_id];
+    EventQueue::ScopedMigration migrate(tc->getCpuPtr()->eventQueue(),
+                                        inParallelMode);
     RegVal mip = tc->readMiscReg(MISCREG_IP);
     uint32_t msip = bits<uint32_t>(mip, ExceptionCode::INT_SOFTWARE_MACHINE);
     reg.update(msip);
@@ -145,6 +150,8 @@ Clint::writeMSIP(Register32& reg, const uint32_t& data, const int thread_id)
     reg.update(data);
     assert(data <= 1);
     auto tc = system->threads[thread_id];
+    EventQueue::ScopedMigration migrate(tc->getCpuPtr()->eventQueue(),
+                                        inParallelMode);
     if (data > 0) {
         DPRINTF(Clint, "MSIP posted - thread: %d\n", thread_id);
         tc->getCpuPtr()->postInterrupt(tc->threadId(),
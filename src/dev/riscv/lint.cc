@@ -93,6 +93,8 @@ Lint::update_mtip(void)
         DPRINTF(Lint, "post mtip! time:%x cmp:%x\n", mtime, mtimecmp);
         for (int context_id = 0; context_id < numThreads; context_id++) {
             auto tc = sys->threads[context_id];
+            EventQueue::ScopedMigration migrate(
+                tc->getCpuPtr()->eventQueue(), inParallelMode);
             tc->getCpuPtr()->postInterrupt(tc->threadId(), INT_TIMER_MACHINE,
                                            0);
         }
@@ -116,6 +118,8 @@ Lint::tryClearMtip()
         DPRINTF(Lint, "Clear mtip! time:%x cmp:%x\n", mtime, mtimecmp);
         for (int context_id = 0; context_id < numThreads; context_id++) {
             auto tc = sys->threads[context_id];
+            EventQueue::ScopedMigration migrate(
+                tc->getCpuPtr()->eventQueue(), inParallelMode);
             tc->getCpuPtr()->clearInterrupt(tc->threadId(), INT_TIMER_MACHINE,
                                             0);
         }
@@ -446,6 +446,9 @@ Plic::updateInt()
             ExceptionCode::INT_EXT_SUPER : ExceptionCode::INT_EXT_MACHINE;
 
         auto tc = system->threads[thread_id];
+        // The core may be simulated on an event queue of its own
+        EventQueue::ScopedMigration migrate(tc->getCpuPtr()->eventQueue(),
+                                            inParallelMode);
         uint32_t max_id = output.maxID[i];
         uint32_t priority = output.maxPriority[i];
         uint32_t threshold = registers.threshold[i].get();
@@ -0,0 +1,21 @@
+from m5.params import *
+from m5.proxy import *
+from m5.objects.ClockedObject import ClockedObject
+
+# Fixed-latency link whose two sides may be simulated on different main
+# event queues, see mem/parallel_link.hh. The cpu side is on the event
+# queue of the link (eventq_index), the mem side on mem_side_eventq_index.
+class ParallelLink(ClockedObject):
+    type = 'ParallelLink'
+    cxx_header = 'mem/parallel_link.hh'
+    cxx_class = 'gem5::ParallelLink'
+
+    mem_side_port = RequestPort("This port sends requests and "
+                                "receives responses")
+    cpu_side_port = ResponsePort("This port receives requests and "
+                                 "sends responses")
+
+    latency = Param.Latency("Crossing latency, at least Root.sim_quantum "
+                            "when the two sides are on different queues")
+    mem_side_eventq_index = Param.UInt32(Parent.eventq_index,
+                                         "Event queue of the mem side")
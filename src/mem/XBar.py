@@ -144,6 +144,12 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MiB', "Maximum capacity of snoop filter")
 
+    # The lines are kept in a set associative table of max_capacity
+    # lines. Lines that find their set full are still tracked, and
+    # counted as the back-invalidations a directory of this geometry
+    # would have to do.
+    assoc = Param.Unsigned(8, "Associativity of the snoop filter table")
+
 # We use a coherent crossbar to connect multiple requestors to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
@@ -0,0 +1,67 @@
+#include "mem/backdoor_cache.hh"
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+Tick
+MemBackdoorCache::sendAtomic(RequestPort &port, PacketPtr pkt)
+{
+    MemBackdoorPtr bd = nullptr;
+    Tick latency = port.sendAtomicBackdoor(pkt, bd);
+
+    // If the target gave us a backdoor for next time and we didn't
+    // already have it, record it.
+    if (bd && backdoors.insert(bd->range(), bd) != backdoors.end()) {
+        // Install a callback to erase this backdoor if it goes away.
+        auto callback = [this](const MemBackdoor &backdoor) {
+                for (auto it = backdoors.begin();
+                        it != backdoors.end(); it++) {
+                    if (it->second == &backdoor) {
+                        backdoors.erase(it);
+                        return;
+                    }
+                }
+                panic("Got invalidation for unknown memory backdoor.");
+            };
+        bd->addInvalidationCallback(callback);
+    }
+    return latency;
+}
+
+MemBackdoorPtr
+MemBackdoorCache::find(const AddrRange &range)
+{
+    auto it = backdoors.contains(range);
+    return it == backdoors.end() ? nullptr : it->second;
+}
+
+bool
+MemBackdoorCache::access(PacketPtr pkt)
+{
+    // Locked, swapping and ordered accesses need the memory to see them.
+    if (pkt->cmd != MemCmd::ReadReq && pkt->cmd != MemCmd::WriteReq)
+        return false;
+    if (pkt->req->isUncacheable() || pkt->req->isStrictlyOrdered())
+        return false;
+
+    MemBackdoorPtr bd = find(pkt->getAddrRange());
+    if (!bd)
+        return false;
+
+    uint8_t *host_addr = bd->ptr() + (pkt->getAddr() - bd->range().start());
+    if (pkt->isRead()) {
+        if (!bd->readable())
+            return false;
+        pkt->setData(host_addr);
+    } else {
+        if (!bd->writeable())
+            return false;
+        pkt->writeData(host_addr);
+    }
+    pkt->makeResponse();
+    return true;
+}
+
+} // namespace gem5
@@ -0,0 +1,50 @@
+#ifndef __MEM_BACKDOOR_CACHE_HH__
+#define __MEM_BACKDOOR_CACHE_HH__
+
+#include "base/addr_range_map.hh"
+#include "base/types.hh"
+#include "mem/backdoor.hh"
+#include "mem/packet.hh"
+#include "mem/port.hh"
+
+namespace gem5
+{
+
+/**
+ * The memory backdoors handed out to a requestor, so that it can read
+ * and write host memory directly instead of sending packets.
+ *
+ * Backdoors are only handed out along paths without caches, and a
+ * backdoor is dropped as soon as the memory invalidates it, e.g. when
+ * its range changes or an address gets locked for an LL/SC pair.
+ */
+class MemBackdoorCache
+{
+  public:
+    MemBackdoorCache() = default;
+    MemBackdoorCache(const MemBackdoorCache &) = delete;
+    MemBackdoorCache &operator=(const MemBackdoorCache &) = delete;
+
+    /**
+     * Send an atomic packet through the port, asking for a backdoor, and
+     * keep the backdoor if one is handed out.
+     */
+    Tick sendAtomic(RequestPort &port, PacketPtr pkt);
+
+    /**
+     * Do a plain read or write through a backdoor, if one covers it.
+     *
+     * @return true if the packet was done, and turned into a response.
+     */
+    bool access(PacketPtr pkt);
+
+    /** The backdoor covering a range, or nullptr. */
+    MemBackdoorPtr find(const AddrRange &range);
+
+  private:
+    AddrRangeMap<MemBackdoorPtr, 1> backdoors;
+};
+
+} // namespace gem5
+
+#endif // __MEM_BACKDOOR_CACHE_HH__
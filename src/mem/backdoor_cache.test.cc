@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "mem/backdoor.hh"
+#include "mem/backdoor_cache.hh"
+#include "mem/packet.hh"
+#include "mem/packet_access.hh"
+#include "mem/port.hh"
+#include "mem/request.hh"
+#include "sim/cur_tick.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+const Addr Base = 0x1000;
+const Addr Size = 0x1000;
+
+/** A memory that hands out a backdoor to all of its range. */
+class TestMemPort : public ResponsePort
+{
+  public:
+    uint8_t data[Size] = {};
+    MemBackdoor backdoor{RangeSize(Base, Size), data,
+                         MemBackdoor::Flags(MemBackdoor::Readable |
+                                             MemBackdoor::Writeable)};
+    bool giveBackdoor = true;
+    int packets = 0;
+
+    TestMemPort() : ResponsePort("mem", nullptr) {}
+
+    Tick
+    recvAtomic(PacketPtr pkt) override
+    {
+        packets++;
+        Addr offset = pkt->getAddr() - Base;
+        if (pkt->isRead())
+            pkt->setData(data + offset);
+        else if (pkt->isWrite())
+            pkt->writeData(data + offset);
+        pkt->makeResponse();
+        return 100;
+    }
+
+    Tick
+    recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &bd) override
+    {
+        if (giveBackdoor)
+            bd = &backdoor;
+        return recvAtomic(pkt);
+    }
+
+    void recvFunctional(PacketPtr pkt) override { recvAtomic(pkt); }
+    bool recvTimingReq(PacketPtr) override { return false; }
+    void recvRespRetry() override {}
+
+    AddrRangeList
+    getAddrRanges() const override
+    {
+        return {RangeSize(Base, Size)};
+    }
+};
+
+class TestCpuPort : public RequestPort
+{
+  public:
+    TestCpuPort() : RequestPort("cpu", nullptr) {}
+
+    bool recvTimingResp(PacketPtr) override { return false; }
+    void recvReqRetry() override {}
+};
+
+class BackdoorCacheTest : public testing::Test
+{
+  protected:
+    TestMemPort mem;
+    TestCpuPort cpu;
+    MemBackdoorCache cache;
+
+    void
+    SetUp() override
+    {
+        // Requests are stamped with the current tick
+        Gem5Internal::_curTickPtr = &tick;
+        cpu.bind(mem);
+    }
+
+    PacketPtr
+    packet(MemCmd cmd, Addr addr, unsigned size, Request::Flags flags = 0)
+    {
+        requests.push_back(std::make_shared<Request>(
+            addr, size, flags, Request::funcRequestorId));
+        packets.emplace_back(new Packet(requests.back(), cmd));
+        packets.back()->allocate();
+        return packets.back().get();
+    }
+
+    /** Get the backdoor handed out with a first access. */
+    void
+    getBackdoor()
+    {
+        cache.sendAtomic(cpu, packet(MemCmd::ReadReq, Base, 8));
+        ASSERT_NE(cache.find(RangeSize(Base, 8)), nullptr);
+        mem.packets = 0;
+    }
+
+  private:
+    Tick tick = 0;
+    std::vector<RequestPtr> requests;
+    std::vector<std::unique_ptr<Packet>> packets;
+};
+
+} // anonymous namespace
+
+TEST_F(BackdoorCacheTest, NoBackdoorYet)
+{
+    PacketPtr pkt = packet(MemCmd::ReadReq, Base, 8);
+    EXPECT_FALSE(cache.access(pkt));
+    EXPECT_FALSE(pkt->isResponse());
+    EXPECT_EQ(cache.find(RangeSize(Base, 8)), nullptr);
+}
+
+TEST_F(BackdoorCacheTest, NoBackdoorHandedOut)
+{
+    mem.giveBackdoor = false;
+    EXPECT_EQ(cache.sendAtomic(cpu, packet(MemCmd::ReadReq, Base, 8)), 100);
+    EXPECT_EQ(mem.packets, 1);
+    EXPECT_FALSE(cache.access(packet(MemCmd::ReadReq, Base, 8)));
+}
+
+TEST_F(BackdoorCacheTest, ReadThroughBackdoor)
+{
+    getBackdoor();
+    const uint64_t value = 0x0123456789abcdefULL;
+    memcpy(mem.data + 0x10, &value, sizeof(value));
+
+    PacketPtr pkt = packet(MemCmd::ReadReq, Base + 0x10, 8);
+    ASSERT_TRUE(cache.access(pkt));
+    EXPECT_TRUE(pkt->isResponse());
+    EXPECT_EQ(pkt->getRaw<uint64_t>(), value);
+    EXPECT_EQ(mem.packets, 0);
+}
+
+TEST_F(BackdoorCacheTest, WriteThroughBackdoor)
+{
+    getBackdoor();
+    PacketPtr pkt = packet(MemCmd::WriteReq, Base + 0x20, 4);
+    pkt->setRaw<uint32_t>(0xdeadbeef);
+    ASSERT_TRUE(cache.access(pkt));
+    EXPECT_TRUE(pkt->isResponse());
+
+    uint32_t stored;
+    memcpy(&stored, mem.data + 0x20, sizeof(stored));
+    EXPECT_EQ(stored, 0xdeadbeef);
+    EXPECT_EQ(mem.packets, 0);
+}
+
+TEST_F(BackdoorCacheTest, NotWriteable)
+{
+    getBackdoor();
+    mem.backdoor.writeable(false);
+    PacketPtr pkt = packet(MemCmd::WriteReq, Base, 4);
+    pkt->setRaw<uint32_t>(1);
+    EXPECT_FALSE(cache.access(pkt));
+    EXPECT_FALSE(pkt->isResponse());
+    EXPECT_TRUE(cache.access(packet(MemCmd::ReadReq, Base, 4)));
+}
+
+TEST_F(BackdoorCacheTest, OutsideBackdoor)
+{
+    getBackdoor();
+    EXPECT_FALSE(cache.access(packet(MemCmd::ReadReq, Base - 8, 8)));
+    EXPECT_FALSE(cache.access(packet(MemCmd::ReadReq, Base + Size, 8)));
+    // Only partly covered
+    EXPECT_FALSE(cache.access(packet(MemCmd::ReadReq, Base + Size - 4, 8)));
+}
+
+TEST_F(BackdoorCacheTest, LockedAndSwapGoToMemory)
+{
+    getBackdoor();
+    EXPECT_FALSE(cache.access(packet(MemCmd::LoadLockedReq, Base, 8)));
+    EXPECT_FALSE(cache.access(packet(MemCmd::StoreCondReq, Base, 8)));
+    EXPECT_FALSE(cache.access(packet(MemCmd::SwapReq, Base, 8)));
+}
+
+TEST_F(BackdoorCacheTest, UncacheableAndOrderedGoToMemory)
+{
+    getBackdoor();
+    EXPECT_FALSE(cache.access(
+        packet(MemCmd::ReadReq, Base, 8, Request::UNCACHEABLE)));
+    EXPECT_FALSE(cache.access(
+        packet(MemCmd::ReadReq, Base, 8, Request::STRICT_ORDER)));
+    EXPECT_TRUE(cache.access(packet(MemCmd::ReadReq, Base, 8)));
+}
+
+TEST_F(BackdoorCacheTest, Invalidation)
+{
+    getBackdoor();
+    mem.backdoor.invalidate();
+    EXPECT_EQ(cache.find(RangeSize(Base, 8)), nullptr);
+    EXPECT_FALSE(cache.access(packet(MemCmd::ReadReq, Base, 8)));
+
+    // The next packet through the port brings it back
+    cache.sendAtomic(cpu, packet(MemCmd::ReadReq, Base, 8));
+    EXPECT_EQ(mem.packets, 1);
+    EXPECT_TRUE(cache.access(packet(MemCmd::ReadReq, Base, 8)));
+}
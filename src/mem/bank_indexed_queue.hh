@@ -0,0 +1,201 @@
+#ifndef __MEM_BANK_INDEXED_QUEUE_HH__
+#define __MEM_BANK_INDEXED_QUEUE_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+#include "base/intmath.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * A queue of memory packets, in arrival order, that also indexes its
+ * packets by bank. The scheduler looks up the packets of the banks that
+ * have any, and the row hits of a bank, instead of walking the whole
+ * queue, and uses the arrival order kept by the index to pick the same
+ * packet a walk of the queue would.
+ *
+ * Packet is MemPacket in the controllers. It needs isDram(),
+ * pseudoChannel, bankId and row.
+ */
+template <class Packet>
+class BankIndexedQueue
+{
+  private:
+    typedef std::deque<Packet*> Container;
+
+  public:
+    typedef typename Container::iterator iterator;
+    typedef typename Container::const_iterator const_iterator;
+
+    /** A queued packet and its position in the arrival order. */
+    struct Entry
+    {
+        uint64_t seq;
+        Packet *pkt;
+    };
+
+    /** The packets of one bank, in arrival order. */
+    struct BankPackets
+    {
+        std::vector<Entry> entries;
+
+        /** Number of packets to each of the rows of the bank. */
+        std::vector<std::pair<uint32_t, unsigned>> rows;
+
+        /** Number of packets to a row of the bank. */
+        unsigned
+        rowCount(uint32_t row) const
+        {
+            for (const auto &r : rows) {
+                if (r.first == row)
+                    return r.second;
+            }
+            return 0;
+        }
+    };
+
+    /**
+     * The packets to the memory of one kind (DRAM or NVM) of one pseudo
+     * channel, by bank id, with a bitmap of the banks that have packets.
+     */
+    struct BankIndex
+    {
+        bool dram;
+        uint8_t pseudoChannel;
+        size_t size = 0;
+        std::vector<BankPackets> banks;
+        std::vector<uint64_t> occupied;
+
+        /** Call f(bank_id, packets) for the banks with packets. */
+        template <typename F>
+        void
+        forEachBank(F f) const
+        {
+            for (size_t w = 0; w < occupied.size(); w++) {
+                for (uint64_t bits = occupied[w]; bits; bits &= bits - 1) {
+                    const size_t bank_id = w * 64 + __builtin_ctzll(bits);
+                    f(bank_id, banks[bank_id]);
+                }
+            }
+        }
+    };
+
+    iterator begin() { return packets.begin(); }
+    iterator end() { return packets.end(); }
+    const_iterator begin() const { return packets.begin(); }
+    const_iterator end() const { return packets.end(); }
+
+    size_t size() const { return packets.size(); }
+    bool empty() const { return packets.empty(); }
+    Packet *front() const { return packets.front(); }
+    Packet *back() const { return packets.back(); }
+
+    void
+    push_back(Packet *pkt)
+    {
+        packets.push_back(pkt);
+
+        BankIndex &index = indexOf(pkt);
+        if (pkt->bankId >= index.banks.size()) {
+            index.banks.resize(pkt->bankId + 1);
+            index.occupied.resize(divCeil(index.banks.size(), 64), 0);
+        }
+        BankPackets &bank = index.banks[pkt->bankId];
+        bank.entries.push_back({nextSeq++, pkt});
+        auto same_row = [pkt](const auto &r) { return r.first == pkt->row; };
+        auto row = std::find_if(bank.rows.begin(), bank.rows.end(),
+                                same_row);
+        if (row == bank.rows.end())
+            bank.rows.emplace_back(pkt->row, 1);
+        else
+            row->second++;
+        index.occupied[pkt->bankId / 64] |= 1ULL << (pkt->bankId % 64);
+        index.size++;
+    }
+
+    void pop_front() { erase(packets.begin()); }
+
+    iterator
+    erase(iterator it)
+    {
+        Packet *pkt = *it;
+
+        BankIndex &index = indexOf(pkt);
+        BankPackets &bank = index.banks[pkt->bankId];
+        auto entry = std::find_if(bank.entries.begin(), bank.entries.end(),
+            [pkt](const Entry &e) { return e.pkt == pkt; });
+        assert(entry != bank.entries.end());
+        bank.entries.erase(entry);
+        auto same_row = [pkt](const auto &r) { return r.first == pkt->row; };
+        auto row = std::find_if(bank.rows.begin(), bank.rows.end(),
+                                same_row);
+        assert(row != bank.rows.end());
+        if (--row->second == 0)
+            bank.rows.erase(row);
+        if (bank.entries.empty()) {
+            index.occupied[pkt->bankId / 64] &=
+                ~(1ULL << (pkt->bankId % 64));
+        }
+        index.size--;
+
+        return packets.erase(it);
+    }
+
+    /** The position of a queued packet. */
+    iterator
+    find(const Packet *pkt)
+    {
+        return std::find(packets.begin(), packets.end(), pkt);
+    }
+
+    /**
+     * The index of the packets to a memory of a pseudo channel, or
+     * nullptr if none were ever queued.
+     */
+    const BankIndex *
+    bankIndex(bool dram, uint8_t pseudo_channel) const
+    {
+        for (const auto &index : indices) {
+            if (index.dram == dram && index.pseudoChannel == pseudo_channel)
+                return &index;
+        }
+        return nullptr;
+    }
+
+  private:
+    BankIndex &
+    indexOf(const Packet *pkt)
+    {
+        for (auto &index : indices) {
+            if (index.dram == pkt->isDram() &&
+                index.pseudoChannel == pkt->pseudoChannel) {
+                return index;
+            }
+        }
+        indices.emplace_back();
+        indices.back().dram = pkt->isDram();
+        indices.back().pseudoChannel = pkt->pseudoChannel;
+        return indices.back();
+    }
+
+    Container packets;
+
+    /** One per memory and pseudo channel, there are only a few. */
+    std::vector<BankIndex> indices;
+
+    uint64_t nextSeq = 0;
+};
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_BANK_INDEXED_QUEUE_HH__
@@ -73,6 +73,7 @@
 #include "params/WriteAllocator.hh"
 #include "sim/arch_db.hh"
 #include "sim/clocked_object.hh"
+#include "sim/event_pool.hh"
 #include "sim/eventq.hh"
 #include "sim/probe/probe.hh"
 #include "sim/serialize.hh"
@@ -345,7 +346,7 @@ class BaseCache : public ClockedObject
     CpuSidePort cpuSidePort;
     MemSidePort memSidePort;
 
-    class SendTimingRespEvent : public Event
+    class SendTimingRespEvent : public PooledEvent<SendTimingRespEvent>
     {
       private:
         BaseCache* cache;
@@ -356,6 +357,9 @@ class BaseCache : public ClockedObject
         const char* description() const override;
     };
 
+    /** Recycled load responses of the L1 load pipe. */
+    EventPool<SendTimingRespEvent> sendTimingRespEventPool;
+
 
   protected:
 
@@ -65,11 +65,11 @@ Queued::DeferredPacket::createPkt(Addr paddr, unsigned blk_size, RequestorID req
     /* Create a prefetch memory request */
     RequestPtr req;
     if (owner->useVirtualAddresses && pfInfo.hasPC()) {
-        req = std::make_shared<Request>(pfInfo.getAddr(), blk_size, 0,
-                                        requestor_id, pfInfo.getPC(), 0);
+        req = makeRequest(pfInfo.getAddr(), blk_size, 0,
+                          requestor_id, pfInfo.getPC(), 0);
         req->setPaddr(paddr);
     } else {
-        req = std::make_shared<Request>(paddr, blk_size, 0, requestor_id);
+        req = makeRequest(paddr, blk_size, 0, requestor_id);
     }
 
     req->setFlags(Request::PREFETCH);
@@ -464,7 +464,7 @@ Queued::alreadyInQueue(std::list<DeferredPacket> &queue,
 RequestPtr
 Queued::createPrefetchRequest(Addr addr, PrefetchInfo const &pfi, PacketPtr pkt, PrefetchSourceType pf_src, int pf_depth)
 {
-    RequestPtr translation_req = std::make_shared<Request>(
+    RequestPtr translation_req = makeRequest(
             addr, blkSize, pkt->req->getFlags(), requestorId, pfi.getPC(),
             pkt->req->contextId());
     translation_req->setFlags(Request::PF_EXCLUSIVE);
@@ -330,22 +330,19 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
             // response
             if (expect_snoop_resp) {
                 // we should never have an exsiting request outstanding
-                assert(outstandingSnoop.find(pkt->req) ==
-                       outstandingSnoop.end());
-                outstandingSnoop.insert(pkt->req);
+                routeTo.setSnoop(pkt->req);
 
                 // basic sanity check on the outstanding snoops
-                panic_if(outstandingSnoop.size() > maxOutstandingSnoopCheck,
+                panic_if(routeTo.numSnoops() > maxOutstandingSnoopCheck,
                          "%s: Outstanding snoop requests exceeded %d\n",
                          name(), maxOutstandingSnoopCheck);
             }
 
             // remember where to route the normal response to
             if (expect_response || expect_snoop_resp) {
-                assert(routeTo.find(pkt->req) == routeTo.end());
-                routeTo[pkt->req] = cpu_side_port_id;
+                routeTo.setRoute(pkt->req, cpu_side_port_id);
 
-                panic_if(routeTo.size() > maxRoutingTableSizeCheck,
+                panic_if(routeTo.numRoutes() > maxRoutingTableSizeCheck,
                          "%s: Routing table exceeds %d packets\n",
                          name(), maxRoutingTableSizeCheck);
             }
@@ -397,23 +394,20 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID cpu_side_port_id)
                 assert(rsp_pkt);
 
                 // determine the destination
-                const auto route_lookup = routeTo.find(rsp_pkt->req);
-                assert(route_lookup != routeTo.end());
-                rsp_port_id = route_lookup->second;
+                rsp_port_id = routeTo.route(rsp_pkt->req);
                 assert(rsp_port_id != InvalidPortID);
                 assert(rsp_port_id < respLayers.size());
                 // remove the request from the routing table
-                routeTo.erase(route_lookup);
+                routeTo.clearRoute(rsp_pkt->req);
             }
             outstandingCMO.erase(cmo_lookup);
         } else {
             respond_directly = false;
             outstandingCMO.emplace(pkt->id, deferred_rsp);
             if (!pkt->isWrite()) {
-                assert(routeTo.find(pkt->req) == routeTo.end());
-                routeTo[pkt->req] = cpu_side_port_id;
+                routeTo.setRoute(pkt->req, cpu_side_port_id);
 
-                panic_if(routeTo.size() > maxRoutingTableSizeCheck,
+                panic_if(routeTo.numRoutes() > maxRoutingTableSizeCheck,
                          "%s: Routing table exceeds %d packets\n",
                          name(), maxRoutingTableSizeCheck);
             }
@@ -452,9 +446,7 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
     RequestPort *src_port = memSidePorts[mem_side_port_id];
 
     // determine the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID cpu_side_port_id = route_lookup->second;
+    const PortID cpu_side_port_id = routeTo.route(pkt->req);
     assert(cpu_side_port_id != InvalidPortID);
     assert(cpu_side_port_id < respLayers.size());
 
@@ -497,7 +489,7 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID mem_side_port_id)
                                         + latency);
 
     // remove the request from the routing table
-    routeTo.erase(route_lookup);
+    routeTo.clearRoute(pkt->req);
 
     DPRINTF(CoherentXBar, "%s: will holdin the resp layer until %d\n", __func__, packetFinishTime);
     respLayers[cpu_side_port_id]->succeededTiming(packetFinishTime);
@@ -558,8 +550,7 @@ CoherentXBar::recvTimingSnoopReq(PacketPtr pkt, PortID mem_side_port_id)
 
     // if we can expect a response, remember how to route it
     if (!cache_responding && pkt->cacheResponding()) {
-        assert(routeTo.find(pkt->req) == routeTo.end());
-        routeTo[pkt->req] = mem_side_port_id;
+        routeTo.setRoute(pkt->req, mem_side_port_id);
     }
 
     // a snoop request came from a connected CPU-side-port device (one of
@@ -577,17 +568,14 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id)
     ResponsePort* src_port = cpuSidePorts[cpu_side_port_id];
 
     // get the destination
-    const auto route_lookup = routeTo.find(pkt->req);
-    assert(route_lookup != routeTo.end());
-    const PortID dest_port_id = route_lookup->second;
+    const PortID dest_port_id = routeTo.route(pkt->req);
     assert(dest_port_id != InvalidPortID);
 
     // determine if the response is from a snoop request we
-    // created as the result of a normal request (in which case it
-    // should be in the outstandingSnoop), or if we merely forwarded
+    // created as the result of a normal request (in which case we
+    // expect its snoop response), or if we merely forwarded
     // someone else's snoop request
-    const bool forwardAsSnoop = outstandingSnoop.find(pkt->req) ==
-        outstandingSnoop.end();
+    const bool forwardAsSnoop = !routeTo.snoop(pkt->req);
 
     // test if the crossbar should be considered occupied for the
     // current port, note that the check is bypassed if the response
@@ -659,7 +647,7 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id)
         // i.e. from a coherent requestor connected to the crossbar, and
         // since we created the snoop request as part of recvTiming,
         // this should now be a normal response again
-        outstandingSnoop.erase(pkt->req);
+        routeTo.clearSnoop(pkt->req);
 
         // this is a snoop response from a coherent requestor, hence it
         // should never go back to where the snoop response came from,
@@ -689,7 +677,7 @@ CoherentXBar::recvTimingSnoopResp(PacketPtr pkt, PortID cpu_side_port_id)
     }
 
     // remove the request from the routing table
-    routeTo.erase(route_lookup);
+    routeTo.clearRoute(pkt->req);
 
     // stats updates
     transDist[pkt_cmd]++;
@@ -47,7 +47,6 @@
 #define __MEM_COHERENT_XBAR_HH__
 
 #include <unordered_map>
-#include <unordered_set>
 
 #include "mem/snoop_filter.hh"
 #include "mem/xbar.hh"
@@ -253,13 +252,6 @@ class CoherentXBar : public BaseXBar
 
     std::vector<QueuedResponsePort*> snoopPorts;
 
-    /**
-     * Store the outstanding requests that we are expecting snoop
-     * responses from so we can determine which snoop responses we
-     * generated and which ones were merely forwarded.
-     */
-    std::unordered_set<RequestPtr> outstandingSnoop;
-
     /**
      * Store the outstanding cache maintenance that we are expecting
      * snoop responses from so we can determine when we received all
@@ -625,6 +625,28 @@ class DRAMInterface : public MemInterface
      */
     Tick writeToReadDelay() const override { return tBURST + tWTR + tWL; }
 
+    /** The state of the ranks and banks that frfcfs.hh reads. */
+    class SchedState
+    {
+      public:
+        typedef MemInterface::Bank Bank;
+
+        explicit SchedState(const DRAMInterface &_dram) : dram(_dram) {}
+
+        const Bank &bank(unsigned rank, unsigned bank) const;
+        bool rankReady(unsigned rank) const;
+        bool readBus() const;
+        unsigned ranks() const { return dram.ranksPerChannel; }
+        unsigned banks() const { return dram.banksPerRank; }
+        uint8_t pseudoChannel() const { return dram.pseudoChannel; }
+        Tick tRP() const { return dram.tRP; }
+        Tick tRCD() const;
+        Tick now() const { return curTick(); }
+
+      private:
+        const DRAMInterface &dram;
+    };
+
     /**
      * Find which are the earliest banks ready to issue an activate
      * for the enqueued requests. Assumes maximum of 32 banks per rank
@@ -0,0 +1,270 @@
+#ifndef __MEM_FRFCFS_HH__
+#define __MEM_FRFCFS_HH__
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace memory
+{
+
+/**
+ * The FR-FCFS selection of DRAMInterface, on the bank index of a
+ * BankIndexedQueue. It is kept apart from the interface so that it can be
+ * checked on its own against a walk of the whole queue.
+ *
+ * Memory is the state of the ranks and banks of one DRAM pseudo channel:
+ * - Bank, the bank type, with openRow, NO_ROW and the *AllowedAt ticks;
+ * - bank(rank, bank), the state of a bank;
+ * - rankReady(rank), the rank is not refreshing;
+ * - readBus(), the bus is in the read state;
+ * - ranks(), banks(), pseudoChannel(), tRP(), tRCD() for the bus state,
+ *   and now().
+ */
+
+/**
+ * Find which are the earliest banks ready to issue an activate
+ * for the enqueued requests. Assumes maximum of 32 banks per rank
+ * Also checks if the bank is already prepped.
+ *
+ * @param queue Queued requests to consider
+ * @param min_col_at time of seamless burst command
+ * @return One-hot encoded mask of bank indices
+ * @return boolean indicating burst can issue seamlessly, with no gaps
+ */
+template <class Memory, class Queue>
+std::pair<std::vector<uint32_t>, bool>
+frfcfsMinBankPrep(const Memory &mem, const Queue &queue, Tick min_col_at)
+{
+    typedef typename Memory::Bank Bank;
+
+    const unsigned num_ranks = mem.ranks();
+    const unsigned num_banks = mem.banks();
+    const Tick now = mem.now();
+
+    Tick min_act_at = MaxTick;
+    std::vector<uint32_t> bank_mask(num_ranks, 0);
+
+    // Flag condition when burst can issue back-to-back with previous burst
+    bool found_seamless_bank = false;
+
+    // Flag condition when bank can be opened without incurring additional
+    // delay on the data bus
+    bool hidden_bank_prep = false;
+
+    // determine if we have queued transactions targetting the
+    // bank in question
+    std::vector<bool> got_waiting(num_ranks * num_banks, false);
+    if (auto index = queue.bankIndex(true, mem.pseudoChannel())) {
+        index->forEachBank([&](size_t bank_id, const auto &) {
+            if (mem.rankReady(bank_id / num_banks))
+                got_waiting[bank_id] = true;
+        });
+    }
+
+    // latest Tick for which ACT can occur without
+    // incurring additoinal delay on the data bus
+    const Tick tRCD = mem.tRCD();
+    const Tick hidden_act_max = std::max(min_col_at - tRCD, now);
+
+    // Find command with optimal bank timing
+    // Will prioritize commands that can issue seamlessly.
+    for (unsigned i = 0; i < num_ranks; i++) {
+        for (unsigned j = 0; j < num_banks; j++) {
+            // if we have waiting requests for the bank, and it is
+            // amongst the first available, update the mask
+            if (!got_waiting[i * num_banks + j])
+                continue;
+
+            // make sure this rank is not currently refreshing.
+            assert(mem.rankReady(i));
+            const Bank &bank = mem.bank(i, j);
+            // simplistic approximation of when the bank can issue
+            // an activate, ignoring any rank-to-rank switching
+            // cost in this calculation
+            Tick act_at = bank.openRow == Bank::NO_ROW ?
+                std::max(bank.actAllowedAt, now) :
+                std::max(bank.preAllowedAt, now) + mem.tRP();
+
+            // When is the earliest the R/W burst can issue?
+            const Tick col_allowed_at = mem.readBus() ?
+                bank.rdAllowedAt : bank.wrAllowedAt;
+            Tick col_at = std::max(col_allowed_at, act_at + tRCD);
+
+            // bank can issue burst back-to-back (seamlessly) with
+            // previous burst
+            bool new_seamless_bank = col_at <= min_col_at;
+
+            // if we found a new seamless bank or we have no
+            // seamless banks, and got a bank with an earlier
+            // activate time, it should be added to the bit mask
+            if (new_seamless_bank ||
+                (!found_seamless_bank && act_at <= min_act_at)) {
+                // if we did not have a seamless bank before, and
+                // we do now, reset the bank mask, also reset it
+                // if we have not yet found a seamless bank and
+                // the activate time is smaller than what we have
+                // seen so far
+                if (!found_seamless_bank &&
+                    (new_seamless_bank || act_at < min_act_at)) {
+                    std::fill(bank_mask.begin(), bank_mask.end(), 0);
+                }
+
+                found_seamless_bank |= new_seamless_bank;
+
+                // ACT can occur 'behind the scenes'
+                hidden_bank_prep = act_at <= hidden_act_max;
+
+                // set the bit corresponding to the available bank
+                replaceBits(bank_mask[i], j, j, 1);
+                min_act_at = act_at;
+            }
+        }
+    }
+
+    return std::make_pair(bank_mask, hidden_bank_prep);
+}
+
+/**
+ * Select the next DRAM packet of a queue, in FR-FCFS order.
+ *
+ * @param queue Queued requests to consider
+ * @param min_col_at Minimum tick for 'seamless' issue
+ * @return an iterator to the selected packet, else queue.end()
+ * @return the tick when the packet selected will issue
+ */
+template <class Memory, class Queue>
+std::pair<typename Queue::iterator, Tick>
+frfcfsChoose(const Memory &mem, Queue &queue, Tick min_col_at)
+{
+    typedef typename Memory::Bank Bank;
+    typedef typename Queue::Entry Entry;
+
+    // The packets are looked up by bank, but the selection is the one of
+    // a walk of the queue in arrival order:
+    // 1) the first seamless row hit, that can issue without additional
+    //    delay, such as same rank accesses and/or different bank-group
+    //    accesses
+    // 2) else the first packet to a closed row of one of the earliest
+    //    banks, if it can issue the bank commands 'behind the scenes' or
+    //    there is no row hit, selecting closed rows first enables more
+    //    open row possibilities in future selections
+    // 3) else the first row hit, not seamless, but bank prepped and ready
+    const auto *index = queue.bankIndex(true, mem.pseudoChannel());
+
+    auto earlier = [](const Entry *a, const Entry *b) {
+        return !b || a->seq < b->seq;
+    };
+    auto col_allowed_at = [&mem](const auto *pkt) {
+        const Bank &bank = mem.bank(pkt->rank, pkt->bank);
+        return pkt->isRead() ? bank.rdAllowedAt : bank.wrAllowedAt;
+    };
+
+    const Entry *seamless = nullptr;
+    const Entry *prepped = nullptr;
+    // is there a packet to a closed row in an available rank?
+    bool found_closed_row = false;
+
+    if (index) {
+        index->forEachBank([&](size_t, const auto &packets) {
+            const auto *first = packets.entries.front().pkt;
+
+            // check if rank is not doing a refresh and thus is available,
+            // if not, skip the bank
+            if (!mem.rankReady(first->rank))
+                return;
+
+            const Bank &bank = mem.bank(first->rank, first->bank);
+            const unsigned hits = packets.rowCount(bank.openRow);
+            found_closed_row |= hits < packets.entries.size();
+
+            // the first row hit, and the first seamless one, the column
+            // command timing only depends on the direction
+            const bool rd_seamless = bank.rdAllowedAt <= min_col_at;
+            const bool wr_seamless = bank.wrAllowedAt <= min_col_at;
+            unsigned hits_left = hits;
+            for (const Entry &e : packets.entries) {
+                if (!hits_left)
+                    break;
+                if (e.pkt->row != bank.openRow)
+                    continue;
+                if (hits_left-- == hits && earlier(&e, prepped))
+                    prepped = &e;
+                if (e.pkt->isRead() ? rd_seamless : wr_seamless) {
+                    if (earlier(&e, seamless))
+                        seamless = &e;
+                    break;
+                }
+                if (!rd_seamless && !wr_seamless)
+                    break;
+            }
+        });
+    }
+
+    if (seamless) {
+        return std::make_pair(queue.find(seamless->pkt),
+                              col_allowed_at(seamless->pkt));
+    }
+
+    // if we have no row hit, prepped or not, and no seamless packet,
+    // just go for the earliest possible
+    const Entry *earliest = nullptr;
+    // can the PRE/ACT sequence be done without impacting utlization?
+    bool hidden_bank_prep = false;
+
+    if (found_closed_row) {
+        // determine entries with earliest bank delay
+        std::vector<uint32_t> earliest_banks;
+        std::tie(earliest_banks, hidden_bank_prep) =
+            frfcfsMinBankPrep(mem, queue, min_col_at);
+
+        index->forEachBank([&](size_t, const auto &packets) {
+            const auto *first = packets.entries.front().pkt;
+
+            // bank is amongst first available banks
+            // minBankPrep will give priority to packets that can
+            // issue seamlessly
+            if (!mem.rankReady(first->rank) ||
+                !bits(earliest_banks[first->rank], first->bank,
+                      first->bank)) {
+                return;
+            }
+
+            const Bank &bank = mem.bank(first->rank, first->bank);
+            for (const Entry &e : packets.entries) {
+                if (e.pkt->row != bank.openRow) {
+                    if (earlier(&e, earliest))
+                        earliest = &e;
+                    break;
+                }
+            }
+        });
+    }
+
+    // give priority to packets that can issue bank commands 'behind the
+    // scenes', any additional delay if any will be due to col-to-col
+    // command requirements
+    const Entry *selected = prepped;
+    if (earliest && (hidden_bank_prep || !prepped))
+        selected = earliest;
+
+    if (!selected)
+        return std::make_pair(queue.end(), MaxTick);
+
+    return std::make_pair(queue.find(selected->pkt),
+                          col_allowed_at(selected->pkt));
+}
+
+} // namespace memory
+} // namespace gem5
+
+#endif // __MEM_FRFCFS_HH__
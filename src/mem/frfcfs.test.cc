@@ -0,0 +1,317 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/types.hh"
+#include "mem/bank_indexed_queue.hh"
+#include "mem/frfcfs.hh"
+
+using namespace gem5;
+using namespace gem5::memory;
+
+namespace
+{
+
+struct Packet
+{
+    bool read;
+    bool dram;
+    uint8_t pseudoChannel;
+    uint8_t rank;
+    uint8_t bank;
+    uint32_t row;
+    uint16_t bankId;
+
+    bool isRead() const { return read; }
+    bool isDram() const { return dram; }
+};
+
+typedef BankIndexedQueue<Packet> Queue;
+
+struct Bank
+{
+    static const uint32_t NO_ROW = -1;
+
+    uint32_t openRow = NO_ROW;
+    Tick rdAllowedAt = 0;
+    Tick wrAllowedAt = 0;
+    Tick preAllowedAt = 0;
+    Tick actAllowedAt = 0;
+};
+
+/** The rank and bank state of one pseudo channel, as frfcfs.hh reads it. */
+struct Memory
+{
+    typedef ::Bank Bank;
+
+    unsigned numRanks = 2;
+    unsigned numBanks = 8;
+    uint8_t channel = 0;
+    std::vector<std::vector<Bank>> state;
+    std::vector<bool> refreshing;
+    bool rdBus = true;
+    Tick curTick = 0;
+
+    void
+    resize(unsigned ranks, unsigned banks)
+    {
+        numRanks = ranks;
+        numBanks = banks;
+        state.assign(ranks, std::vector<Bank>(banks));
+        refreshing.assign(ranks, false);
+    }
+
+    const Bank &bank(unsigned r, unsigned b) const { return state[r][b]; }
+    bool rankReady(unsigned r) const { return !refreshing[r]; }
+    bool readBus() const { return rdBus; }
+    unsigned ranks() const { return numRanks; }
+    unsigned banks() const { return numBanks; }
+    uint8_t pseudoChannel() const { return channel; }
+    Tick tRP() const { return 15; }
+    Tick tRCD() const { return rdBus ? 14 : 12; }
+    Tick now() const { return curTick; }
+};
+
+/**
+ * The bank selection as DRAMInterface did it before the bank index, by
+ * walking the whole queue.
+ */
+std::pair<std::vector<uint32_t>, bool>
+walkMinBankPrep(const Memory &mem, const Queue &queue, Tick min_col_at)
+{
+    Tick min_act_at = MaxTick;
+    std::vector<uint32_t> bank_mask(mem.ranks(), 0);
+    bool found_seamless_bank = false;
+    bool hidden_bank_prep = false;
+
+    std::vector<bool> got_waiting(mem.ranks() * mem.banks(), false);
+    for (const auto &p : queue) {
+        if (p->pseudoChannel != mem.pseudoChannel())
+            continue;
+        if (p->isDram() && mem.rankReady(p->rank))
+            got_waiting[p->bankId] = true;
+    }
+
+    for (unsigned i = 0; i < mem.ranks(); i++) {
+        for (unsigned j = 0; j < mem.banks(); j++) {
+            if (!got_waiting[i * mem.banks() + j])
+                continue;
+
+            const Bank &bank = mem.bank(i, j);
+            Tick act_at = bank.openRow == Bank::NO_ROW ?
+                std::max(bank.actAllowedAt, mem.now()) :
+                std::max(bank.preAllowedAt, mem.now()) + mem.tRP();
+            const Tick hidden_act_max =
+                std::max(min_col_at - mem.tRCD(), mem.now());
+            const Tick col_allowed_at = mem.readBus() ?
+                bank.rdAllowedAt : bank.wrAllowedAt;
+            Tick col_at = std::max(col_allowed_at, act_at + mem.tRCD());
+            bool new_seamless_bank = col_at <= min_col_at;
+
+            if (new_seamless_bank ||
+                (!found_seamless_bank && act_at <= min_act_at)) {
+                if (!found_seamless_bank &&
+                    (new_seamless_bank || act_at < min_act_at)) {
+                    std::fill(bank_mask.begin(), bank_mask.end(), 0);
+                }
+                found_seamless_bank |= new_seamless_bank;
+                hidden_bank_prep = act_at <= hidden_act_max;
+                replaceBits(bank_mask[i], j, j, 1);
+                min_act_at = act_at;
+            }
+        }
+    }
+
+    return std::make_pair(bank_mask, hidden_bank_prep);
+}
+
+std::pair<Queue::iterator, Tick>
+walkChoose(const Memory &mem, Queue &queue, Tick min_col_at)
+{
+    std::vector<uint32_t> earliest_banks(mem.ranks(), 0);
+    bool filled_earliest_banks = false;
+    bool hidden_bank_prep = false;
+    bool found_hidden_bank = false;
+    bool found_prepped_pkt = false;
+    bool found_earliest_pkt = false;
+
+    Tick selected_col_at = MaxTick;
+    auto selected_pkt_it = queue.end();
+
+    for (auto i = queue.begin(); i != queue.end(); ++i) {
+        Packet *pkt = *i;
+        if (!pkt->isDram() || pkt->pseudoChannel != mem.pseudoChannel() ||
+            !mem.rankReady(pkt->rank)) {
+            continue;
+        }
+
+        const Bank &bank = mem.bank(pkt->rank, pkt->bank);
+        const Tick col_allowed_at = pkt->isRead() ? bank.rdAllowedAt :
+                                                    bank.wrAllowedAt;
+        if (bank.openRow == pkt->row) {
+            if (col_allowed_at <= min_col_at) {
+                selected_pkt_it = i;
+                selected_col_at = col_allowed_at;
+                break;
+            } else if (!found_hidden_bank && !found_prepped_pkt) {
+                selected_pkt_it = i;
+                selected_col_at = col_allowed_at;
+                found_prepped_pkt = true;
+            }
+        } else if (!found_earliest_pkt) {
+            if (!filled_earliest_banks) {
+                std::tie(earliest_banks, hidden_bank_prep) =
+                    walkMinBankPrep(mem, queue, min_col_at);
+                filled_earliest_banks = true;
+            }
+            if (bits(earliest_banks[pkt->rank], pkt->bank, pkt->bank)) {
+                found_earliest_pkt = true;
+                found_hidden_bank = hidden_bank_prep;
+                if (hidden_bank_prep || !found_prepped_pkt) {
+                    selected_pkt_it = i;
+                    selected_col_at = col_allowed_at;
+                }
+            }
+        }
+    }
+
+    return std::make_pair(selected_pkt_it, selected_col_at);
+}
+
+} // anonymous namespace
+
+TEST(FRFCFSTest, EmptyQueue)
+{
+    Memory mem;
+    mem.resize(2, 8);
+    Queue queue;
+
+    auto selected = frfcfsChoose(mem, queue, 0);
+    EXPECT_EQ(selected.first, queue.end());
+    EXPECT_EQ(selected.second, MaxTick);
+}
+
+TEST(FRFCFSTest, SeamlessRowHitFirst)
+{
+    Memory mem;
+    mem.resize(1, 4);
+    mem.state[0][1].openRow = 7;
+    mem.state[0][1].rdAllowedAt = 10;
+    mem.state[0][2].openRow = 3;
+    mem.state[0][2].rdAllowedAt = 50;
+
+    // A closed row, a row hit that is not seamless, then a seamless one
+    Packet miss{true, true, 0, 0, 0, 1, 0};
+    Packet late_hit{true, true, 0, 0, 2, 3, 2};
+    Packet hit{true, true, 0, 0, 1, 7, 1};
+    Queue queue;
+    queue.push_back(&miss);
+    queue.push_back(&late_hit);
+    queue.push_back(&hit);
+
+    auto selected = frfcfsChoose(mem, queue, 20);
+    ASSERT_NE(selected.first, queue.end());
+    EXPECT_EQ(*selected.first, &hit);
+    EXPECT_EQ(selected.second, 10);
+}
+
+TEST(FRFCFSTest, RefreshingRankSkipped)
+{
+    Memory mem;
+    mem.resize(2, 2);
+    mem.refreshing[0] = true;
+
+    Packet busy{true, true, 0, 0, 0, 0, 0};
+    Packet idle{true, true, 0, 1, 1, 0, 3};
+    Queue queue;
+    queue.push_back(&busy);
+    queue.push_back(&idle);
+
+    auto selected = frfcfsChoose(mem, queue, 0);
+    ASSERT_NE(selected.first, queue.end());
+    EXPECT_EQ(*selected.first, &idle);
+
+    auto prep = frfcfsMinBankPrep(mem, queue, 0);
+    EXPECT_EQ(prep.first, (std::vector<uint32_t>{0, 0b10}));
+}
+
+/**
+ * The selection on the bank index picks the same packet, at the same tick,
+ * as a walk of the queue, on random queues and bank states.
+ */
+TEST(FRFCFSTest, MatchesQueueWalk)
+{
+    std::mt19937_64 rng(1);
+    Memory mem;
+    std::vector<std::unique_ptr<Packet>> packets;
+    unsigned selected = 0;
+
+    for (int iter = 0; iter < 500; iter++) {
+        mem.resize(1 + rng() % 2, 1 + rng() % 16);
+        mem.channel = rng() % 2;
+        const unsigned rows = 1 + rng() % 4;
+        std::vector<Queue> queues(3);
+
+        for (int step = 0; step < 200; step++) {
+            Queue &queue = queues[rng() % queues.size()];
+            const unsigned op = rng() % 10;
+            if (op < 5 || queue.empty()) {
+                packets.emplace_back(new Packet);
+                Packet *pkt = packets.back().get();
+                pkt->read = rng() % 8 ? mem.rdBus : !mem.rdBus;
+                pkt->dram = rng() % 6 != 0;
+                pkt->pseudoChannel = rng() % 4 ? mem.channel : !mem.channel;
+                pkt->rank = rng() % mem.ranks();
+                pkt->bank = rng() % mem.banks();
+                pkt->row = rng() % rows;
+                pkt->bankId = pkt->rank * mem.banks() + pkt->bank;
+                queue.push_back(pkt);
+            } else if (op < 7) {
+                queue.erase(queue.begin() + rng() % queue.size());
+            } else if (op < 8) {
+                queue.pop_front();
+            }
+
+            mem.curTick = rng() % 100;
+            mem.rdBus = rng() % 2;
+            for (unsigned r = 0; r < mem.ranks(); r++) {
+                mem.refreshing[r] = rng() % 5 == 0;
+                for (auto &bank : mem.state[r]) {
+                    if (rng() % 3 == 0)
+                        bank.openRow = rng() % 3 ? rng() % rows : Bank::NO_ROW;
+                    bank.rdAllowedAt = rng() % 120;
+                    bank.wrAllowedAt = rng() % 2 ? bank.rdAllowedAt :
+                                                   rng() % 120;
+                    bank.preAllowedAt = rng() % 120;
+                    bank.actAllowedAt = rng() % 120;
+                }
+            }
+            const Tick min_col_at = mem.curTick + rng() % 60;
+
+            for (auto &q : queues) {
+                auto expected = walkChoose(mem, q, min_col_at);
+                auto actual = frfcfsChoose(mem, q, min_col_at);
+                ASSERT_EQ(actual.first - q.begin(),
+                          expected.first - q.begin())
+                    << "iteration " << iter << ", step " << step;
+                ASSERT_EQ(actual.second, expected.second)
+                    << "iteration " << iter << ", step " << step;
+                if (actual.first != q.end())
+                    selected++;
+
+                ASSERT_EQ(frfcfsMinBankPrep(mem, q, min_col_at),
+                          walkMinBankPrep(mem, q, min_col_at))
+                    << "iteration " << iter << ", step " << step;
+            }
+        }
+    }
+
+    // Most decisions select a packet, the queues are rarely empty
+    EXPECT_GT(selected, 500 * 200 * 3 / 2);
+}
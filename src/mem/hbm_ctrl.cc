@@ -333,27 +333,21 @@ HBMCtrl::recvTimingReq(PacketPtr pkt)
 void
 HBMCtrl::pruneRowBurstTick()
 {
-    auto it = rowBurstTicks.begin();
-    while (it != rowBurstTicks.end()) {
-        auto current_it = it++;
-        if (MemCtrl::getBurstWindow(curTick()) > *current_it) {
-            DPRINTF(MemCtrl, "Removing burstTick for %d\n", *current_it);
-            rowBurstTicks.erase(current_it);
-        }
-    }
+    const size_t removed =
+        rowBurstTicks.prune(MemCtrl::getBurstWindow(curTick()));
+    if (removed)
+        DPRINTF(MemCtrl, "Removed %d row burstTicks before %d\n", removed,
+                MemCtrl::getBurstWindow(curTick()));
 }
 
 void
 HBMCtrl::pruneColBurstTick()
 {
-    auto it = colBurstTicks.begin();
-    while (it != colBurstTicks.end()) {
-        auto current_it = it++;
-        if (MemCtrl::getBurstWindow(curTick()) > *current_it) {
-            DPRINTF(MemCtrl, "Removing burstTick for %d\n", *current_it);
-            colBurstTicks.erase(current_it);
-        }
-    }
+    const size_t removed =
+        colBurstTicks.prune(MemCtrl::getBurstWindow(curTick()));
+    if (removed)
+        DPRINTF(MemCtrl, "Removed %d col burstTicks before %d\n", removed,
+                MemCtrl::getBurstWindow(curTick()));
 }
 
 void
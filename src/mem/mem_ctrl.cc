@@ -40,6 +40,9 @@
 
 #include "mem/mem_ctrl.hh"
 
+#include <algorithm>
+
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
 #include "debug/Drain.hh"
@@ -652,14 +655,10 @@ MemCtrl::accessAndRespond(PacketPtr pkt, Tick static_latency,
 void
 MemCtrl::pruneBurstTick()
 {
-    auto it = burstTicks.begin();
-    while (it != burstTicks.end()) {
-        auto current_it = it++;
-        if (curTick() > *current_it) {
-            DPRINTF(MemCtrl, "Removing burstTick for %d\n", *current_it);
-            burstTicks.erase(current_it);
-        }
-    }
+    const size_t removed = burstTicks.prune(curTick());
+    if (removed)
+        DPRINTF(MemCtrl, "Removed %d burstTicks before %d\n", removed,
+                curTick());
 }
 
 Tick
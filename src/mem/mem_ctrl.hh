@@ -46,7 +46,9 @@
 #ifndef __MEM_CTRL_HH__
 #define __MEM_CTRL_HH__
 
+#include <algorithm>
 #include <deque>
+#include <map>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -55,6 +57,7 @@
 #include "base/callback.hh"
 #include "base/statistics.hh"
 #include "enums/MemSched.hh"
+#include "mem/bank_indexed_queue.hh"
 #include "mem/qos/mem_ctrl.hh"
 #include "mem/qport.hh"
 #include "params/MemCtrl.hh"
@@ -215,11 +218,48 @@ class MemPacket
 
 };
 
-// The memory packets are store in a multiple dequeue structure,
-// based on their QoS priority
-typedef std::deque<MemPacket*> MemPacketQueue;
+typedef BankIndexedQueue<MemPacket> MemPacketQueue;
 
 
+/**
+ * The number of commands issued in the burst windows, by the Tick the
+ * window starts at. The windows are kept in order, so that the ones that
+ * are over are pruned without looking at the others.
+ */
+class BurstTickCounts
+{
+  public:
+    /** Number of commands issued in the window at burst_tick. */
+    size_t
+    count(Tick burst_tick) const
+    {
+        auto it = counts.find(burst_tick);
+        return it == counts.end() ? 0 : it->second;
+    }
+
+    /** Add a command to the window at burst_tick. */
+    void insert(Tick burst_tick) { counts[burst_tick]++; }
+
+    /**
+     * Remove the windows that start before a tick.
+     *
+     * @return number of commands removed
+     */
+    size_t
+    prune(Tick tick)
+    {
+        size_t removed = 0;
+        auto end = counts.lower_bound(tick);
+        for (auto it = counts.begin(); it != end; ++it)
+            removed += it->second;
+        counts.erase(counts.begin(), end);
+        return removed;
+    }
+
+  private:
+    std::map<Tick, size_t> counts;
+};
+
 /**
  * The memory controller is a single-channel memory controller capturing
  * the most important timing constraints associated with a
@@ -486,14 +526,14 @@ class MemCtrl : public qos::MemCtrl
      * as sizing the read queue, this and the main read queue need to
      * be added together.
      */
-    std::deque<MemPacket*> respQueue;
+    MemPacketQueue respQueue;
 
     /**
      * Holds count of commands issued in burst window starting at
      * defined Tick. This is used to ensure that the command bandwidth
      * does not exceed the allowable media constraints.
      */
-    std::unordered_multiset<Tick> burstTicks;
+    BurstTickCounts burstTicks;
 
     /**
 +    * Create pointer to interface of the actual memory media when connected
@@ -58,6 +58,7 @@
 #include "base/flags.hh"
 #include "base/logging.hh"
 #include "base/printable.hh"
+#include "base/slab_pool.hh"
 #include "base/types.hh"
 #include "mem/htm.hh"
 #include "mem/request.hh"
@@ -1093,6 +1094,20 @@ class Packet : public Printable
         deleteData();
     }
 
+    /**
+     * Packets are created and deleted for every access, so their memory
+     * comes from the SlabPool.
+     * @{
+     */
+    static void *operator new(size_t size) { return SlabPool::allocate(size); }
+
+    static void
+    operator delete(void *p, size_t size)
+    {
+        SlabPool::deallocate(p, size);
+    }
+    /** @} */
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -139,7 +139,7 @@ PacketQueue::schedSendTiming(PacketPtr pkt, Tick when)
         if ((forceOrder && it->pkt->matchAddr(pkt)) || it->tick <= when) {
             // emplace inserts the element before the position pointed to by
             // the iterator, so advance it one step
-            transmitList.emplace(++it, when, pkt);
+            insertDeferred(++it, when, pkt);
             DPRINTF(PacketQueue, "%s for %s address %x size %d when %lu ord: %i (reordered)\n",
                     __func__, pkt->cmdString(), pkt->getAddr(), pkt->getSize(), when,
                     forceOrder);
@@ -151,10 +151,22 @@ PacketQueue::schedSendTiming(PacketPtr pkt, Tick when)
             forceOrder);
     // either the packet list is empty or this has to be inserted
     // before every other packet
-    transmitList.emplace_front(when, pkt);
+    insertDeferred(transmitList.begin(), when, pkt);
     schedSendEvent(when);
 }
 
+void
+PacketQueue::insertDeferred(DeferredPacketList::iterator pos, Tick when,
+                            PacketPtr pkt)
+{
+    if (freeNodes.empty()) {
+        transmitList.emplace(pos, when, pkt);
+    } else {
+        freeNodes.front() = DeferredPacket(when, pkt);
+        transmitList.splice(pos, freeNodes, freeNodes.begin());
+    }
+}
+
 void
 PacketQueue::schedSendEvent(Tick when)
 {
@@ -219,7 +231,7 @@ PacketQueue::sendDeferredPacket()
     // (most notaly when responding to the timing CPU, leading to a
     // new request hitting in the L1 icache, leading to a new
     // response)
-    transmitList.pop_front();
+    freeNodes.splice(freeNodes.begin(), transmitList, transmitList.begin());
 
     // use the appropriate implementation of sendTiming based on the
     // type of queue
@@ -231,7 +243,7 @@ PacketQueue::sendDeferredPacket()
         schedSendEvent(deferredPacketReadyTime());
     } else {
         // put the packet back at the front of the list
-        transmitList.emplace_front(dp);
+        insertDeferred(transmitList.begin(), dp.tick, dp.pkt);
     }
 }
 
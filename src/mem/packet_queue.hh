@@ -81,6 +81,17 @@ class PacketQueue : public Drainable
     /** A list of outgoing packets. */
     DeferredPacketList transmitList;
 
+    /**
+     * Nodes of packets that have been sent, spliced back into
+     * transmitList by insertDeferred() so that queueing a packet does not
+     * allocate.
+     */
+    DeferredPacketList freeNodes;
+
+    /** Insert a packet into transmitList before pos. */
+    void insertDeferred(DeferredPacketList::iterator pos, Tick when,
+                        PacketPtr pkt);
+
     /** The manager which is used for the event queue */
     EventManager& em;
 
@@ -0,0 +1,215 @@
+#include "mem/parallel_link.hh"
+
+#include "base/trace.hh"
+#include "debug/ParallelLink.hh"
+#include "params/ParallelLink.hh"
+
+namespace gem5
+{
+
+ParallelLink::ParallelLink(const ParallelLinkParams &p)
+    : ClockedObject(p),
+      memSideQueue(getEventQueue(p.mem_side_eventq_index)),
+      memSideManager(memSideQueue),
+      latency(p.latency),
+      requestPort(name() + ".mem_side_port", *this),
+      responsePort(name() + ".cpu_side_port", *this),
+      reqQueue(memSideManager, requestPort),
+      respQueue(*this, responsePort),
+      snoopRespQueue(memSideManager, requestPort)
+{
+}
+
+void
+ParallelLink::init()
+{
+    if (!responsePort.isConnected() || !requestPort.isConnected())
+        fatal("Parallel link %s is not connected on both sides.\n", name());
+
+    // Packets handed to the other queue are only inserted there at the
+    // next quantum barrier, so they must not be due before it.
+    fatal_if(memSideQueue != eventQueue() && latency < simQuantum,
+             "%s: latency %d is below the simulation quantum %d, the "
+             "quantum must not exceed the crossing latency\n",
+             name(), latency, simQuantum);
+}
+
+void
+ParallelLink::startup()
+{
+    DPRINTF(ParallelLink, "cpu side on %s, mem side on %s, latency %d\n",
+            eventQueue()->name(), memSideQueue->name(), latency);
+}
+
+DrainState
+ParallelLink::drain()
+{
+    std::lock_guard<std::mutex> lock(inFlightMutex);
+    return inFlight.empty() ? DrainState::Drained : DrainState::Draining;
+}
+
+Port &
+ParallelLink::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "mem_side_port") {
+        return requestPort;
+    } else if (if_name == "cpu_side_port") {
+        return responsePort;
+    } else {
+        return ClockedObject::getPort(if_name, idx);
+    }
+}
+
+void
+ParallelLink::handOff(PacketPtr pkt, Kind kind)
+{
+    // technically the packet only reaches us after the header delay,
+    // and typically we also need to deserialise any payload
+    const Tick when = curTick() + latency + pkt->headerDelay +
+        pkt->payloadDelay;
+    pkt->headerDelay = pkt->payloadDelay = 0;
+
+    std::list<PacketPtr>::iterator it;
+    {
+        std::lock_guard<std::mutex> lock(inFlightMutex);
+        it = inFlight.insert(inFlight.end(), pkt);
+    }
+
+    EventQueue *target = kind == Kind::Resp ? eventQueue() : memSideQueue;
+    auto *event = new EventFunctionWrapper(
+        [this, pkt, kind, it]() {
+            bool drained;
+            {
+                std::lock_guard<std::mutex> lock(inFlightMutex);
+                inFlight.erase(it);
+                drained = inFlight.empty();
+            }
+
+            switch (kind) {
+              case Kind::Req:
+                requestPort.schedTimingReq(pkt, curTick());
+                break;
+              case Kind::Resp:
+                responsePort.schedTimingResp(pkt, curTick());
+                break;
+              case Kind::SnoopResp:
+                requestPort.schedTimingSnoopResp(pkt, curTick());
+                break;
+            }
+
+            if (drained && drainState() == DrainState::Draining)
+                signalDrainDone();
+        }, name() + ".handOff", true);
+
+    DPRINTF(ParallelLink, "Hand off %s to %s at %d\n", pkt->print(),
+            target->name(), when);
+
+    // Inserted asynchronously when the target queue belongs to another
+    // thread, see EventQueue::schedule().
+    target->schedule(event, when);
+}
+
+bool
+ParallelLink::trySatisfyFunctional(PacketPtr pkt)
+{
+    {
+        std::lock_guard<std::mutex> lock(inFlightMutex);
+        for (auto p : inFlight) {
+            if (pkt->trySatisfyFunctional(p))
+                return true;
+        }
+    }
+    return responsePort.trySatisfyFunctional(pkt) ||
+        requestPort.trySatisfyFunctional(pkt);
+}
+
+ParallelLink::RequestPort::RequestPort(const std::string &_name,
+                                       ParallelLink &_parent)
+    : QueuedRequestPort(_name, &_parent,
+                        _parent.reqQueue, _parent.snoopRespQueue),
+      parent(_parent)
+{
+}
+
+bool
+ParallelLink::RequestPort::recvTimingResp(PacketPtr pkt)
+{
+    parent.handOff(pkt, Kind::Resp);
+    return true;
+}
+
+void
+ParallelLink::RequestPort::recvFunctionalSnoop(PacketPtr pkt)
+{
+    if (parent.trySatisfyFunctional(pkt)) {
+        pkt->makeResponse();
+    } else {
+        EventQueue::ScopedMigration migrate(parent.eventQueue(),
+                                            inParallelMode);
+        parent.responsePort.sendFunctionalSnoop(pkt);
+    }
+}
+
+Tick
+ParallelLink::RequestPort::recvAtomicSnoop(PacketPtr pkt)
+{
+    EventQueue::ScopedMigration migrate(parent.eventQueue(), inParallelMode);
+    return parent.latency + parent.responsePort.sendAtomicSnoop(pkt);
+}
+
+void
+ParallelLink::RequestPort::recvTimingSnoopReq(PacketPtr pkt)
+{
+    // Snoopers have to mark the packet before the snoop returns, so the
+    // snoop is delivered synchronously on the cpu side queue.
+    EventQueue::ScopedMigration migrate(parent.eventQueue(), inParallelMode);
+    parent.responsePort.sendTimingSnoopReq(pkt);
+}
+
+ParallelLink::ResponsePort::ResponsePort(const std::string &_name,
+                                         ParallelLink &_parent)
+    : QueuedResponsePort(_name, &_parent, _parent.respQueue),
+      parent(_parent)
+{
+}
+
+Tick
+ParallelLink::ResponsePort::recvAtomic(PacketPtr pkt)
+{
+    EventQueue::ScopedMigration migrate(parent.memSideQueue, inParallelMode);
+    return 2 * parent.latency + parent.requestPort.sendAtomic(pkt);
+}
+
+bool
+ParallelLink::ResponsePort::recvTimingReq(PacketPtr pkt)
+{
+    if (pkt->isExpressSnoop()) {
+        // express snoops are neither delayed nor flow controlled
+        EventQueue::ScopedMigration migrate(parent.memSideQueue,
+                                            inParallelMode);
+        return parent.requestPort.sendTimingReq(pkt);
+    }
+    parent.handOff(pkt, Kind::Req);
+    return true;
+}
+
+void
+ParallelLink::ResponsePort::recvFunctional(PacketPtr pkt)
+{
+    if (parent.trySatisfyFunctional(pkt)) {
+        pkt->makeResponse();
+    } else {
+        EventQueue::ScopedMigration migrate(parent.memSideQueue,
+                                            inParallelMode);
+        parent.requestPort.sendFunctional(pkt);
+    }
+}
+
+bool
+ParallelLink::ResponsePort::recvTimingSnoopResp(PacketPtr pkt)
+{
+    parent.handOff(pkt, Kind::SnoopResp);
+    return true;
+}
+
+} // namespace gem5
@@ -0,0 +1,122 @@
+#ifndef __MEM_PARALLEL_LINK_HH__
+#define __MEM_PARALLEL_LINK_HH__
+
+#include <list>
+#include <mutex>
+
+#include "mem/qport.hh"
+#include "sim/clocked_object.hh"
+
+namespace gem5
+{
+
+struct ParallelLinkParams;
+
+/**
+ * A fixed-latency link between two parts of the memory system that may
+ * be simulated on different main event queues, e.g. a core with its
+ * private caches on one queue and the shared L3 and memory on another.
+ *
+ * The cpu side of the link lives on the event queue of the link itself,
+ * the mem side on mem_side_eventq_index. Timing requests, responses and
+ * snoop responses are handed across with an event scheduled on the
+ * queue of the receiving side, latency ticks in the future. The latency
+ * therefore is the lookahead of the two queues and has to be at least
+ * the simulation quantum when the queues differ.
+ *
+ * Timing snoop requests, atomic and functional accesses cannot be
+ * delayed; they migrate to the other queue for the duration of the call
+ * and are thus only loosely timed within a quantum.
+ */
+class ParallelLink : public ClockedObject
+{
+  public:
+    ParallelLink(const ParallelLinkParams &params);
+
+    void init() override;
+    void startup() override;
+    DrainState drain() override;
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+  protected:
+    class RequestPort : public QueuedRequestPort
+    {
+      public:
+        RequestPort(const std::string &_name, ParallelLink &_parent);
+
+      protected:
+        bool recvTimingResp(PacketPtr pkt) override;
+        void recvFunctionalSnoop(PacketPtr pkt) override;
+        Tick recvAtomicSnoop(PacketPtr pkt) override;
+        void recvTimingSnoopReq(PacketPtr pkt) override;
+
+        void recvRangeChange() override {
+            parent.responsePort.sendRangeChange();
+        }
+
+        bool isSnooping() const override {
+            return parent.responsePort.isSnooping();
+        }
+
+      private:
+        ParallelLink &parent;
+    };
+
+    class ResponsePort : public QueuedResponsePort
+    {
+      public:
+        ResponsePort(const std::string &_name, ParallelLink &_parent);
+
+      protected:
+        Tick recvAtomic(PacketPtr pkt) override;
+        bool recvTimingReq(PacketPtr pkt) override;
+        void recvFunctional(PacketPtr pkt) override;
+        bool recvTimingSnoopResp(PacketPtr pkt) override;
+
+        AddrRangeList getAddrRanges() const override {
+            return parent.requestPort.getAddrRanges();
+        }
+
+        bool tryTiming(PacketPtr pkt) override { return true; }
+
+      private:
+        ParallelLink &parent;
+    };
+
+    /** Packets on their way across, kind tells where they go. */
+    enum class Kind { Req, Resp, SnoopResp };
+
+    /**
+     * Send pkt across the link. The hand-off event is scheduled on the
+     * queue of the receiving side and can be inserted from any thread.
+     */
+    void handOff(PacketPtr pkt, Kind kind);
+
+    bool trySatisfyFunctional(PacketPtr pkt);
+
+    /** Event queue of the mem side, the cpu side uses eventQueue(). */
+    EventQueue *memSideQueue;
+    EventManager memSideManager;
+
+    const Tick latency;
+
+    RequestPort requestPort;
+    ResponsePort responsePort;
+
+    /** Lives on the mem side queue. */
+    ReqPacketQueue reqQueue;
+    /** Lives on the cpu side queue. */
+    RespPacketQueue respQueue;
+    /** Lives on the mem side queue. */
+    SnoopRespPacketQueue snoopRespQueue;
+
+    /** Packets in flight between the two queues, for functional checks. */
+    std::list<PacketPtr> inFlight;
+    std::mutex inFlightMutex;
+};
+
+} // namespace gem5
+
+#endif // __MEM_PARALLEL_LINK_HH__
@@ -54,11 +54,13 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/amo.hh"
 #include "base/compiler.hh"
 #include "base/flags.hh"
+#include "base/slab_pool.hh"
 #include "base/types.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/o3/dyn_inst_xsmeta.hh"
@@ -604,7 +606,7 @@ class Request
     static RequestPtr
     createMemManagement(Flags flags, RequestorID id)
     {
-        auto mgmt_req = std::make_shared<Request>();
+        auto mgmt_req = makeSlabShared<Request>();
         mgmt_req->_flags.set(flags);
         mgmt_req->_requestorId = id;
         mgmt_req->_time = curTick();
@@ -706,8 +708,8 @@ class Request
         assert(hasVaddr());
         assert(!hasPaddr());
         assert(split_addr > _vaddr && split_addr < _vaddr + _size);
-        req1 = std::make_shared<Request>(*this);
-        req2 = std::make_shared<Request>(*this);
+        req1 = makeSlabShared<Request>(*this);
+        req2 = makeSlabShared<Request>(*this);
         req1->_size = split_addr - _vaddr;
         req2->_vaddr = split_addr;
         req2->_size = _size - req1->_size;
@@ -1264,8 +1266,41 @@ class Request
 
     bool isFirstReqAfterSquash() { return firstReqAfterSquash; }
     void setFirstReqAfterSquash() { firstReqAfterSquash = true; }
+
+  public:
+    /**
+     * The state a crossbar keeps for a request in flight through it, see
+     * XBarRoutes. It lives in the request, that all the packets of the
+     * request point to, rather than in a table of the crossbar keyed on
+     * the request. It is not copied with the request.
+     */
+    struct XBarSlot
+    {
+        /** The crossbar using the slot, nullptr when it is free. */
+        const void *owner = nullptr;
+        /** Where to route the response. */
+        PortID route = InvalidPortID;
+        /** Is the crossbar expecting a snoop response it created? */
+        bool snoop = false;
+    };
+
+    /** As many as the crossbars of a cache hierarchy on the way down. */
+    static constexpr int NumXBarSlots = 3;
+    XBarSlot xbarSlots[NumXBarSlots];
 };
 
+/**
+ * Create a request, and its reference count, from the SlabPool. The
+ * memory system creates requests for every access, miss, prefetch and
+ * writeback.
+ */
+template <typename ...Args>
+RequestPtr
+makeRequest(Args &&...args)
+{
+    return makeSlabShared<Request>(std::forward<Args>(args)...);
+}
+
 } // namespace gem5
 
 #endif // __MEM_REQUEST_HH__
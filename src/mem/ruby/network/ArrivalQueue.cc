@@ -0,0 +1,72 @@
+#include "mem/ruby/network/ArrivalQueue.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+ArrivalQueue::Bucket &
+ArrivalQueue::newBucket(std::deque<Bucket>::iterator pos, Tick when)
+{
+    Bucket &bucket = *m_buckets.insert(pos, Bucket{when, 0, {}});
+    if (!m_spare.empty()) {
+        bucket.msgs.swap(m_spare.back());
+        m_spare.pop_back();
+    }
+    return bucket;
+}
+
+void
+ArrivalQueue::push(const MsgPtr &msg)
+{
+    const Tick when = msg->getLastEnqueueTime();
+    const uint64_t counter = msg->getMsgCounter();
+    m_size++;
+
+    // Find the last bucket not after the arrival tick, from the back.
+    auto it = m_buckets.end();
+    while (it != m_buckets.begin() && std::prev(it)->when > when)
+        --it;
+
+    if (it == m_buckets.begin() || std::prev(it)->when != when) {
+        newBucket(it, when).msgs.push_back(msg);
+        return;
+    }
+
+    // Messages put back after a stall or a recycle can be older than those
+    // of their tick already queued.
+    std::vector<MsgPtr> &msgs = std::prev(it)->msgs;
+    const size_t head = std::prev(it)->head;
+    auto pos = msgs.end();
+    while (pos != msgs.begin() + head &&
+           (*std::prev(pos))->getMsgCounter() > counter) {
+        --pos;
+    }
+    msgs.insert(pos, msg);
+}
+
+void
+ArrivalQueue::pop()
+{
+    assert(!empty());
+    Bucket &bucket = m_buckets.front();
+    bucket.msgs[bucket.head++].reset();
+    m_size--;
+
+    if (bucket.head == bucket.msgs.size()) {
+        bucket.msgs.clear();
+        m_spare.emplace_back(std::move(bucket.msgs));
+        m_buckets.pop_front();
+    }
+}
+
+void
+ArrivalQueue::clear()
+{
+    while (!empty())
+        pop();
+}
+
+} // namespace ruby
+} // namespace gem5
@@ -0,0 +1,76 @@
+#ifndef __MEM_RUBY_NETWORK_ARRIVALQUEUE_HH__
+#define __MEM_RUBY_NETWORK_ARRIVALQUEUE_HH__
+
+#include <cassert>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/ruby/slicc_interface/Message.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+/**
+ * Messages of a MessageBuffer in the order they are dequeued: by arrival
+ * tick, then by the order they were enqueued in (see operator> on MsgPtr).
+ *
+ * This is a calendar queue with one bucket per arrival tick, the buckets
+ * sorted by tick. Most messages arrive a few cycles after those already
+ * queued, so a message usually goes to the back of the last bucket or to
+ * a new bucket after it, and popping takes the front of the first bucket.
+ * The storage of emptied buckets is kept for the next ones.
+ */
+class ArrivalQueue
+{
+  public:
+    bool empty() const { return m_size == 0; }
+    size_t size() const { return m_size; }
+
+    const MsgPtr &
+    front() const
+    {
+        assert(!empty());
+        const Bucket &bucket = m_buckets.front();
+        return bucket.msgs[bucket.head];
+    }
+
+    void push(const MsgPtr &msg);
+    void pop();
+    void clear();
+
+    /** Call f on every message, in the order they will be dequeued. */
+    template <typename F>
+    void
+    forEach(F f) const
+    {
+        for (const Bucket &bucket : m_buckets) {
+            for (size_t i = bucket.head; i < bucket.msgs.size(); i++)
+                f(bucket.msgs[i]);
+        }
+    }
+
+  private:
+    struct Bucket
+    {
+        Tick when;
+        /** First message not dequeued yet. */
+        size_t head;
+        std::vector<MsgPtr> msgs;
+    };
+
+    Bucket &newBucket(std::deque<Bucket>::iterator pos, Tick when);
+
+    std::deque<Bucket> m_buckets;
+    std::vector<std::vector<MsgPtr>> m_spare;
+    size_t m_size = 0;
+};
+
+} // namespace ruby
+} // namespace gem5
+
+#endif //__MEM_RUBY_NETWORK_ARRIVALQUEUE_HH__
@@ -60,6 +60,8 @@
 #include "mem/port.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/ArrivalQueue.hh"
+#include "mem/ruby/network/StallMap.hh"
 #include "mem/ruby/network/dummy_port.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 #include "params/MessageBuffer.hh"
@@ -92,10 +94,8 @@ class MessageBuffer : public SimObject
     void
     delayHead(Tick current_time, Tick delta)
     {
-        MsgPtr m = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MsgPtr>());
-        m_prio_heap.pop_back();
+        MsgPtr m = m_arrivals.front();
+        m_arrivals.pop();
         enqueue(m, current_time, delta);
     }
 
@@ -121,7 +121,7 @@ class MessageBuffer : public SimObject
     //! message queue.  The function assumes that the queue is nonempty.
     const Message* peek() const;
 
-    const MsgPtr &peekMsgPtr() const { return m_prio_heap.front(); }
+    const MsgPtr &peekMsgPtr() const { return m_arrivals.front(); }
 
     void enqueue(MsgPtr message, Tick curTime, Tick delta);
 
@@ -145,8 +145,8 @@ class MessageBuffer : public SimObject
     void unregisterDequeueCallback();
 
     void recycle(Tick current_time, Tick recycle_latency);
-    bool isEmpty() const { return m_prio_heap.size() == 0; }
-    bool isStallMapEmpty() { return m_stall_msg_map.size() == 0; }
+    bool isEmpty() const { return m_arrivals.empty(); }
+    bool isStallMapEmpty() { return m_stall_msg_map.empty(); }
     unsigned int getStallMapSize() { return m_stall_msg_map.size(); }
 
     unsigned int getSize(Tick curTime);
@@ -193,7 +193,7 @@ class MessageBuffer : public SimObject
     int routingPriority() const { return m_routing_priority; }
 
   private:
-    void reanalyzeList(std::list<MsgPtr> &, Tick);
+    void reanalyzeList(StallMap::MsgVec &, Tick);
 
     uint32_t functionalAccess(Packet *pkt, bool is_read, WriteMask *mask);
 
@@ -201,28 +201,28 @@ class MessageBuffer : public SimObject
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
-    std::vector<MsgPtr> m_prio_heap;
+    ArrivalQueue m_arrivals;
 
     std::function<void()> m_dequeue_callback;
 
-    // use a std::map for the stalled messages as this container is
-    // sorted and ensures a well-defined iteration order
-    typedef std::map<Addr, std::list<MsgPtr> > StallMsgMapType;
-
     /**
      * A map from line addresses to lists of stalled messages for that line.
      * If this buffer allows the receiver to stall messages, on a stall
-     * request, the stalled message is removed from the m_prio_heap and placed
+     * request, the stalled message is removed from m_arrivals and placed
      * in the m_stall_msg_map. Messages are held there until the receiver
      * requests they be reanalyzed, at which point they are moved back to
-     * m_prio_heap.
+     * m_arrivals.
      *
      * NOTE: The stall map holds messages in the order in which they were
-     * initially received, and when a line is unblocked, the messages are
-     * moved back to the m_prio_heap in the same order. This prevents starving
-     * older requests with younger ones.
+     * initially received. Messages moved back to m_arrivals keep their
+     * arrival time and enqueue order, so they are dequeued before younger
+     * ones. This prevents starving older requests with younger ones, and
+     * makes the order lines are unblocked in irrelevant.
      */
-    StallMsgMapType m_stall_msg_map;
+    StallMap m_stall_msg_map;
+
+    /** Messages of the line being reanalyzed, kept to reuse its storage. */
+    StallMap::MsgVec m_reanalyzed;
 
     /**
      * A map from line addresses to corresponding vectors of messages that
@@ -236,7 +236,7 @@ class MessageBuffer : public SimObject
      * Current size of the stall map.
      * Track the number of messages held in stall map lists. This is used to
      * ensure that if the buffer is finite-sized, it blocks further requests
-     * when the m_prio_heap and m_stall_msg_map contain m_max_size messages.
+     * when m_arrivals and m_stall_msg_map contain m_max_size messages.
      */
     int m_stall_map_size;
 
@@ -0,0 +1,73 @@
+#include "mem/ruby/network/StallMap.hh"
+
+#include <cassert>
+#include <utility>
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+StallMap::MsgVec &
+StallMap::get(Addr addr)
+{
+    size_t pos = find(addr);
+    if (!m_slots[pos].used) {
+        if (2 * (m_size + 1) > m_slots.size()) {
+            grow();
+            pos = find(addr);
+        }
+        m_slots[pos].used = true;
+        m_slots[pos].addr = addr;
+        m_size++;
+    }
+    return m_slots[pos].msgs;
+}
+
+void
+StallMap::take(Addr addr, MsgVec &msgs)
+{
+    size_t pos = find(addr);
+    assert(m_slots[pos].used);
+    msgs.swap(m_slots[pos].msgs);
+    m_slots[pos].msgs.clear();
+    m_slots[pos].used = false;
+    m_size--;
+
+    // Shift back the lines that follow in the probe sequence, so that no
+    // lookup stops early at the hole left behind.
+    for (size_t next = (pos + 1) & m_mask; m_slots[next].used;
+         next = (next + 1) & m_mask) {
+        const size_t home = hash(m_slots[next].addr);
+        if (((next - home) & m_mask) >= ((next - pos) & m_mask)) {
+            std::swap(m_slots[pos], m_slots[next]);
+            pos = next;
+        }
+    }
+}
+
+void
+StallMap::clear()
+{
+    for (auto &slot : m_slots) {
+        slot.used = false;
+        slot.msgs.clear();
+    }
+    m_size = 0;
+}
+
+void
+StallMap::grow()
+{
+    std::vector<Slot> old(2 * m_slots.size());
+    old.swap(m_slots);
+    m_mask = m_slots.size() - 1;
+    for (auto &slot : old) {
+        if (slot.used)
+            m_slots[find(slot.addr)] = std::move(slot);
+    }
+}
+
+} // namespace ruby
+} // namespace gem5
@@ -0,0 +1,89 @@
+#ifndef __MEM_RUBY_NETWORK_STALLMAP_HH__
+#define __MEM_RUBY_NETWORK_STALLMAP_HH__
+
+#include <vector>
+
+#include "mem/ruby/common/Address.hh"
+#include "mem/ruby/slicc_interface/Message.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+/**
+ * Messages stalled in a MessageBuffer, by line address, each line keeping
+ * its messages in the order they were stalled.
+ *
+ * The lines are kept in an open-addressed, linearly probed table at most
+ * half full, so looking a line up does not chase pointers, and the
+ * message vectors of removed lines are kept for the next ones.
+ */
+class StallMap
+{
+  public:
+    typedef std::vector<MsgPtr> MsgVec;
+
+    StallMap() : m_slots(8), m_mask(7) {}
+
+    /** Number of lines with stalled messages. */
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    bool contains(Addr addr) const { return m_slots[find(addr)].used; }
+
+    /** Messages of a line, added if it is not there. */
+    MsgVec &get(Addr addr);
+
+    /** Move the messages of a line to msgs and remove the line. */
+    void take(Addr addr, MsgVec &msgs);
+
+    void clear();
+
+    /** Call f on every line and its messages. */
+    template <typename F>
+    void
+    forEach(F f)
+    {
+        for (auto &slot : m_slots) {
+            if (slot.used)
+                f(slot.addr, slot.msgs);
+        }
+    }
+
+  private:
+    struct Slot
+    {
+        Addr addr = 0;
+        bool used = false;
+        MsgVec msgs;
+    };
+
+    size_t
+    hash(Addr addr) const
+    {
+        return ((addr >> 6) * 0x9e3779b97f4a7c15ULL >> 32) & m_mask;
+    }
+
+    /** Slot of addr, or the empty slot where it would go. */
+    size_t
+    find(Addr addr) const
+    {
+        size_t pos = hash(addr);
+        while (m_slots[pos].used && m_slots[pos].addr != addr)
+            pos = (pos + 1) & m_mask;
+        return pos;
+    }
+
+    void grow();
+
+    std::vector<Slot> m_slots;
+    size_t m_mask;
+    size_t m_size = 0;
+};
+
+} // namespace ruby
+} // namespace gem5
+
+#endif //__MEM_RUBY_NETWORK_STALLMAP_HH__
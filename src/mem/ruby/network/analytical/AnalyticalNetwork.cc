@@ -0,0 +1,455 @@
+#include "mem/ruby/network/analytical/AnalyticalNetwork.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "debug/RubyNetwork.hh"
+#include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/network/BasicLink.hh"
+#include "mem/ruby/network/BasicRouter.hh"
+#include "mem/ruby/network/MessageBuffer.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+namespace
+{
+
+// NetDest of the single node with the given global id
+NetDest
+nodeDest(NodeID id)
+{
+    NetDest dest;
+    for (int m = 0; m < (int) MachineType_NUM; m++) {
+        if ((id >= MachineType_base_number((MachineType) m)) &&
+            id < MachineType_base_number((MachineType) (m+1))) {
+            dest.add((MachineID) {(MachineType) m,
+                (id - MachineType_base_number((MachineType) m))});
+            break;
+        }
+    }
+    return dest;
+}
+
+} // anonymous namespace
+
+AnalyticalNetwork::AnalyticalNetwork(const Params &p)
+    : Network(p), Consumer(this),
+      m_flit_size(p.ni_flit_size), m_epoch(p.epoch),
+      m_queueing_scale(p.queueing_scale),
+      m_max_utilization(p.max_utilization),
+      m_in_link(m_nodes, -1), m_out_link(m_nodes, -1),
+      m_epoch_start(0), networkStats(this)
+{
+    fatal_if(m_flit_size == 0, "%s: ni_flit_size must not be 0\n", name());
+    fatal_if(m_epoch == 0, "%s: epoch must not be 0\n", name());
+    fatal_if(m_max_utilization <= 0 || m_max_utilization >= 1,
+             "%s: max_utilization must be between 0 and 1\n", name());
+
+    for (auto *router : p.routers) {
+        auto id = static_cast<size_t>(router->params().router_id);
+        if (m_router_latency.size() <= id)
+            m_router_latency.resize(id + 1, Cycles(0));
+        m_router_latency[id] = router->params().latency;
+    }
+}
+
+void
+AnalyticalNetwork::init()
+{
+    Network::init();
+
+    // The topology pointer should have already been initialized in
+    // the parent class network constructor.
+    assert(m_topology_ptr != NULL);
+    m_topology_ptr->createLinks(this);
+
+    makeRoutes();
+    m_last_arrival.resize(m_nodes * m_virtual_networks, 0);
+}
+
+void
+AnalyticalNetwork::regStats()
+{
+    Network::regStats();
+    networkStats.init(m_virtual_networks, m_links.size());
+}
+
+int
+AnalyticalNetwork::addLink(int src, int dst, BasicLink *link)
+{
+    Link l;
+    l.src = src;
+    l.dst = dst;
+    l.latency = link->m_latency;
+    l.weight = link->m_weight;
+    m_links.push_back(l);
+    return m_links.size() - 1;
+}
+
+// From a switch to an endpoint node
+void
+AnalyticalNetwork::makeExtOutLink(SwitchID src, NodeID global_dest,
+                                  BasicLink* link,
+                                  std::vector<NetDest>& routing_table_entry)
+{
+    NodeID local_dest = getLocalNodeID(global_dest);
+    assert(local_dest < m_nodes);
+    fatal_if(m_out_link[local_dest] != -1,
+             "%s: node %d has more than one link from the network\n",
+             name(), local_dest);
+
+    m_out_link[local_dest] = addLink(src, -1, link);
+}
+
+// From an endpoint node to a switch
+void
+AnalyticalNetwork::makeExtInLink(NodeID global_src, SwitchID dest,
+                                 BasicLink* link,
+                                 std::vector<NetDest>& routing_table_entry)
+{
+    NodeID local_src = getLocalNodeID(global_src);
+    assert(local_src < m_nodes);
+    fatal_if(m_in_link[local_src] != -1,
+             "%s: node %d has more than one link to the network\n",
+             name(), local_src);
+
+    m_in_link[local_src] = addLink(-1, dest, link);
+
+    const auto &in = m_toNetQueues[local_src];
+    for (int vnet = 0; vnet < in.size(); vnet++) {
+        if (in[vnet] != nullptr) {
+            in[vnet]->setConsumer(this);
+            in[vnet]->setIncomingLink(local_src);
+            in[vnet]->setVnet(vnet);
+        }
+    }
+}
+
+// From a switch to a switch
+void
+AnalyticalNetwork::makeInternalLink(SwitchID src, SwitchID dest,
+                                    BasicLink* link,
+                                    std::vector<NetDest>& routing_table_entry,
+                                    PortDirection src_outport,
+                                    PortDirection dst_inport)
+{
+    addLink(src, dest, link);
+}
+
+void
+AnalyticalNetwork::makeRoutes()
+{
+    const int num_routers = m_router_latency.size();
+
+    // Internal links out of each router
+    std::vector<std::vector<int>> out_links(num_routers);
+    for (int l = 0; l < m_links.size(); l++) {
+        if (m_links[l].src >= 0 && m_links[l].dst >= 0)
+            out_links[m_links[l].src].push_back(l);
+    }
+
+    // Shortest paths between all routers, by weight and then by latency
+    // like the routing tables of the detailed networks.
+    typedef std::pair<uint64_t, uint64_t> Cost;
+    const Cost unreachable(std::numeric_limits<uint64_t>::max(),
+                           std::numeric_limits<uint64_t>::max());
+    std::vector<std::vector<int>> prev(num_routers,
+                                       std::vector<int>(num_routers, -1));
+    std::vector<std::vector<bool>> reached(
+        num_routers, std::vector<bool>(num_routers, false));
+
+    for (int from = 0; from < num_routers; from++) {
+        std::vector<Cost> cost(num_routers, unreachable);
+        typedef std::pair<Cost, int> Item;
+        std::priority_queue<Item, std::vector<Item>,
+                            std::greater<Item>> queue;
+        cost[from] = Cost(0, 0);
+        queue.emplace(cost[from], from);
+        while (!queue.empty()) {
+            auto [c, router] = queue.top();
+            queue.pop();
+            if (c != cost[router])
+                continue;
+            reached[from][router] = true;
+            for (int l : out_links[router]) {
+                const Link &link = m_links[l];
+                Cost next(c.first + link.weight,
+                          c.second + link.latency +
+                          m_router_latency[link.dst]);
+                if (next < cost[link.dst]) {
+                    cost[link.dst] = next;
+                    prev[from][link.dst] = l;
+                    queue.emplace(next, link.dst);
+                }
+            }
+        }
+    }
+
+    m_routes.assign(m_nodes * m_nodes, Route());
+    std::vector<int> hops;
+    for (NodeID src = 0; src < m_nodes; src++) {
+        if (m_in_link[src] == -1)
+            continue;
+        const Link &in = m_links[m_in_link[src]];
+        for (NodeID dest = 0; dest < m_nodes; dest++) {
+            if (m_out_link[dest] == -1)
+                continue;
+            const Link &out = m_links[m_out_link[dest]];
+            if (!reached[in.dst][out.src])
+                continue;
+
+            hops.clear();
+            for (int router = out.src; router != in.dst;
+                 router = m_links[prev[in.dst][router]].src) {
+                hops.push_back(prev[in.dst][router]);
+            }
+
+            Route &route = m_routes[src * m_nodes + dest];
+            route.links.push_back(m_in_link[src]);
+            route.links.insert(route.links.end(), hops.rbegin(),
+                               hops.rend());
+            route.links.push_back(m_out_link[dest]);
+            route.hops = hops.size();
+
+            uint64_t latency = m_router_latency[in.dst];
+            for (int l : route.links) {
+                latency += m_links[l].latency;
+                if (m_links[l].src >= 0 && m_links[l].dst >= 0)
+                    latency += m_router_latency[m_links[l].dst];
+            }
+            route.latency = Cycles(latency);
+        }
+    }
+}
+
+Cycles
+AnalyticalNetwork::latency(const Route &route, int flits,
+                           double &contention)
+{
+    contention = 0;
+    for (int l : route.links) {
+        Link &link = m_links[l];
+        contention += link.wait;
+        link.flits += flits;
+        link.packets++;
+        networkStats.linkFlits[l] += flits;
+    }
+
+    // The head flit sees the path and the queues on it, the others follow
+    // one per cycle.
+    Cycles latency = route.latency + Cycles(flits - 1) +
+                     Cycles(std::lround(contention));
+    return std::max(latency, Cycles(1));
+}
+
+void
+AnalyticalNetwork::updateEpoch()
+{
+    const Cycles now = curCycle();
+    if (now < m_epoch_start + m_epoch)
+        return;
+
+    // Links carry one flit per cycle, so the utilization is the flits
+    // sent over the cycles of the epoch, smoothed with the previous ones.
+    const double cycles = now - m_epoch_start;
+    for (auto &link : m_links) {
+        link.utilization = (link.utilization + link.flits / cycles) / 2;
+        if (link.packets)
+            link.serviceTime = double(link.flits) / link.packets;
+
+        // Mean waiting time of an M/D/1 queue
+        const double rho = std::min(link.utilization, m_max_utilization);
+        link.wait = m_queueing_scale * rho * link.serviceTime /
+                    (2 * (1 - rho));
+
+        link.flits = 0;
+        link.packets = 0;
+    }
+    m_epoch_start = now;
+}
+
+bool
+AnalyticalNetwork::deliver(NodeID src, int vnet, MessageBuffer *buffer)
+{
+    const Tick current_time = clockEdge();
+    MsgPtr msg_ptr = buffer->peekMsgPtr();
+    Message *net_msg_ptr = msg_ptr.get();
+    std::vector<NodeID> dest_nodes =
+        net_msg_ptr->getDestination().getAllDest();
+
+    // A multicast leaves the source at once, so all of its destinations
+    // must have room for it.
+    for (NodeID dest : dest_nodes) {
+        NodeID local_dest = getLocalNodeID(dest);
+        MessageBuffer *out = vnet < m_fromNetQueues[local_dest].size() ?
+            m_fromNetQueues[local_dest][vnet] : nullptr;
+        panic_if(out == nullptr, "%s: node %d does not receive vnet %d\n",
+                 name(), local_dest, vnet);
+        if (!out->areNSlotsAvailable(1, current_time)) {
+            DPRINTF(RubyNetwork, "Node %d is blocked on vnet %d\n",
+                    local_dest, vnet);
+            return false;
+        }
+    }
+
+    const int flits = divCeil(
+        MessageSizeType_to_int(net_msg_ptr->getMessageSize()), m_flit_size);
+    const Tick queueing = current_time - net_msg_ptr->getLastEnqueueTime();
+
+    buffer->dequeue(current_time);
+
+    for (NodeID dest : dest_nodes) {
+        NodeID local_dest = getLocalNodeID(dest);
+        const Route &r = route(src, local_dest);
+        panic_if(r.links.empty(), "%s: no route from node %d to node %d\n",
+                 name(), src, local_dest);
+
+        MsgPtr out_msg_ptr = msg_ptr;
+        if (dest_nodes.size() > 1) {
+            out_msg_ptr = msg_ptr->clone();
+            out_msg_ptr->getDestination() = nodeDest(dest);
+        }
+
+        double contention;
+        Tick arrival = current_time + cyclesToTicks(
+            latency(r, flits, contention));
+
+        // Ordered buffers take their messages in order of arrival, so a
+        // message cannot overtake the ones delivered before it.
+        MessageBuffer *out = m_fromNetQueues[local_dest][vnet];
+        if (out->getOrdered()) {
+            Tick &last = m_last_arrival[local_dest * m_virtual_networks +
+                                        vnet];
+            arrival = std::max(arrival, last);
+            last = arrival;
+        }
+
+        DPRINTF(RubyNetwork, "Node %d to node %d on vnet %d: %d hops, "
+                "%d flits, arrives at %d\n", src, local_dest, vnet, r.hops,
+                flits, arrival);
+
+        out->enqueue(out_msg_ptr, current_time, arrival - current_time);
+
+        networkStats.packetsInjected[vnet]++;
+        networkStats.packetsReceived[vnet]++;
+        networkStats.packetNetworkLatency[vnet] += arrival - current_time;
+        networkStats.packetQueueingLatency[vnet] += queueing;
+        networkStats.packetContentionLatency[vnet] +=
+            contention * clockPeriod();
+        networkStats.totalHops += r.hops;
+    }
+
+    return true;
+}
+
+void
+AnalyticalNetwork::wakeup()
+{
+    updateEpoch();
+
+    const Tick current_time = clockEdge();
+    for (NodeID node = 0; node < m_nodes; node++) {
+        const auto &in = m_toNetQueues[node];
+        for (int vnet = 0; vnet < in.size(); vnet++) {
+            MessageBuffer *buffer = in[vnet];
+            if (buffer == nullptr)
+                continue;
+            while (buffer->isReady(current_time)) {
+                if (!deliver(node, vnet, buffer)) {
+                    scheduleEvent(Cycles(1));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void
+AnalyticalNetwork::print(std::ostream& out) const
+{
+    out << "[AnalyticalNetwork]";
+}
+
+AnalyticalNetwork::
+NetworkStats::NetworkStats(statistics::Group *parent)
+    : statistics::Group(parent),
+      packetsInjected(this, "packets_injected",
+          statistics::units::Count::get(), "Packets injected per vnet"),
+      packetsReceived(this, "packets_received",
+          statistics::units::Count::get(), "Packets received per vnet"),
+      packetNetworkLatency(this, "packet_network_latency",
+          statistics::units::Tick::get(),
+          "Ticks from injection to delivery per vnet"),
+      packetQueueingLatency(this, "packet_queueing_latency",
+          statistics::units::Tick::get(),
+          "Ticks waiting for injection per vnet"),
+      packetContentionLatency(this, "packet_contention_latency",
+          statistics::units::Tick::get(),
+          "Ticks of modeled link queueing per vnet"),
+      totalHops(this, "total_hops", statistics::units::Count::get(),
+          "Router to router hops of all packets"),
+      linkFlits(this, "link_flits", statistics::units::Count::get(),
+          "Flits sent over each link"),
+      avgPacketNetworkLatency(this, "average_packet_network_latency",
+          statistics::units::Rate<
+              statistics::units::Tick, statistics::units::Count>::get(),
+          "Average network latency of a packet"),
+      avgPacketQueueingLatency(this, "average_packet_queueing_latency",
+          statistics::units::Rate<
+              statistics::units::Tick, statistics::units::Count>::get(),
+          "Average queueing latency of a packet"),
+      avgPacketContentionLatency(this, "average_packet_contention_latency",
+          statistics::units::Rate<
+              statistics::units::Tick, statistics::units::Count>::get(),
+          "Average modeled link queueing of a packet"),
+      avgPacketLatency(this, "average_packet_latency",
+          statistics::units::Rate<
+              statistics::units::Tick, statistics::units::Count>::get(),
+          "Average latency of a packet"),
+      avgHops(this, "average_hops",
+          statistics::units::Rate<
+              statistics::units::Count, statistics::units::Count>::get(),
+          "Average hops of a packet")
+{
+}
+
+void
+AnalyticalNetwork::NetworkStats::init(int vnets, int links)
+{
+    packetsInjected.init(vnets);
+    packetsReceived.init(vnets);
+    packetNetworkLatency.init(vnets);
+    packetQueueingLatency.init(vnets);
+    packetContentionLatency.init(vnets);
+    for (int i = 0; i < vnets; i++) {
+        packetsInjected.subname(i, csprintf("vnet-%i", i));
+        packetsReceived.subname(i, csprintf("vnet-%i", i));
+        packetNetworkLatency.subname(i, csprintf("vnet-%i", i));
+        packetQueueingLatency.subname(i, csprintf("vnet-%i", i));
+        packetContentionLatency.subname(i, csprintf("vnet-%i", i));
+    }
+    linkFlits.init(links).flags(statistics::nozero);
+
+    avgPacketNetworkLatency =
+        sum(packetNetworkLatency) / sum(packetsReceived);
+    avgPacketQueueingLatency =
+        sum(packetQueueingLatency) / sum(packetsReceived);
+    avgPacketContentionLatency =
+        sum(packetContentionLatency) / sum(packetsReceived);
+    avgPacketLatency = avgPacketNetworkLatency + avgPacketQueueingLatency;
+    avgHops = totalHops / sum(packetsReceived);
+}
+
+} // namespace ruby
+} // namespace gem5
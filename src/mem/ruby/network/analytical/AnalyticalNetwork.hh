@@ -0,0 +1,150 @@
+#ifndef __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+#define __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+
+#include <iostream>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/Network.hh"
+#include "params/AnalyticalNetwork.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+class NetDest;
+class MessageBuffer;
+
+/**
+ * Network that does not move flits, but computes the latency of every
+ * message from the topology and hands it straight to its destination.
+ *
+ * It takes the same routers and links as Garnet. A message takes the
+ * shortest path by link weight, and its latency is the zero-load latency
+ * of the path (links, router pipelines and serialization of its flits)
+ * plus the waiting time of an M/D/1 queue on every link it crosses. The
+ * utilization of each link is measured over an epoch and used for the
+ * messages of the next one; queueing_scale calibrates the waiting time
+ * against a detailed run of the same topology, see
+ * util/noc_calibrate.py.
+ */
+class AnalyticalNetwork : public Network, public Consumer
+{
+  public:
+    PARAMS(AnalyticalNetwork);
+
+    AnalyticalNetwork(const Params &p);
+    ~AnalyticalNetwork() = default;
+
+    void init();
+    void regStats();
+
+    void wakeup();
+
+    void collateStats() {}
+
+    // Methods used by Topology to setup the network
+    void makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
+                     std::vector<NetDest>& routing_table_entry);
+    void makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
+                    std::vector<NetDest>& routing_table_entry);
+    void makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
+                          std::vector<NetDest>& routing_table_entry,
+                          PortDirection src_outport,
+                          PortDirection dst_inport);
+
+    void print(std::ostream& out) const;
+
+    // Messages are never held inside the network, they are in the
+    // buffers of the controllers from injection to delivery.
+    bool functionalRead(Packet *pkt) { return false; }
+    bool functionalRead(Packet *pkt, WriteMask &mask) { return false; }
+    uint32_t functionalWrite(Packet *pkt) { return 0; }
+
+  private:
+    struct Link
+    {
+        // Routers at the ends, -1 on the side of an endpoint node
+        int src;
+        int dst;
+        Cycles latency;
+        int weight;
+
+        // Traffic of the current epoch
+        uint64_t flits = 0;
+        uint64_t packets = 0;
+
+        // Model of the previous epochs
+        double utilization = 0;
+        double serviceTime = 1;
+        double wait = 0;
+    };
+
+    struct Route
+    {
+        std::vector<int> links;
+        Cycles latency;
+        int hops = 0;
+    };
+
+    int addLink(int src, int dst, BasicLink *link);
+    void makeRoutes();
+    const Route &route(NodeID src, NodeID dest) const
+    { return m_routes[src * m_nodes + dest]; }
+
+    bool deliver(NodeID src, int vnet, MessageBuffer *buffer);
+    Cycles latency(const Route &route, int flits, double &contention);
+    void updateEpoch();
+
+    const int m_flit_size;
+    const Cycles m_epoch;
+    const double m_queueing_scale;
+    const double m_max_utilization;
+
+    std::vector<Cycles> m_router_latency;
+    std::vector<Link> m_links;
+    std::vector<int> m_in_link;
+    std::vector<int> m_out_link;
+    std::vector<Route> m_routes;
+
+    Cycles m_epoch_start;
+    // Last arrival in each ordered destination buffer
+    std::vector<Tick> m_last_arrival;
+
+    struct NetworkStats : public statistics::Group
+    {
+        NetworkStats(statistics::Group *parent);
+
+        void init(int vnets, int links);
+
+        statistics::Vector packetsInjected;
+        statistics::Vector packetsReceived;
+        statistics::Vector packetNetworkLatency;
+        statistics::Vector packetQueueingLatency;
+        statistics::Vector packetContentionLatency;
+        statistics::Scalar totalHops;
+        statistics::Vector linkFlits;
+
+        statistics::Formula avgPacketNetworkLatency;
+        statistics::Formula avgPacketQueueingLatency;
+        statistics::Formula avgPacketContentionLatency;
+        statistics::Formula avgPacketLatency;
+        statistics::Formula avgHops;
+    } networkStats;
+};
+
+inline std::ostream&
+operator<<(std::ostream& out, const AnalyticalNetwork& obj)
+{
+    obj.print(out);
+    out << std::flush;
+    return out;
+}
+
+} // namespace ruby
+} // namespace gem5
+
+#endif //__MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
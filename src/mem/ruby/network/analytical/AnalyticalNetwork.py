@@ -0,0 +1,17 @@
+from m5.params import *
+from m5.proxy import *
+from m5.objects.Network import RubyNetwork
+
+class AnalyticalNetwork(RubyNetwork):
+    type = 'AnalyticalNetwork'
+    cxx_header = "mem/ruby/network/analytical/AnalyticalNetwork.hh"
+    cxx_class = 'gem5::ruby::AnalyticalNetwork'
+
+    ni_flit_size = Param.UInt32(16, "network interface flit size in bytes")
+    epoch = Param.Cycles(1000, "cycles over which the link utilization "
+                         "is measured before it is used for the latency")
+    queueing_scale = Param.Float(1.0, "scale of the modeled link queueing, "
+                                 "calibrated against garnet with "
+                                 "util/noc_calibrate.py")
+    max_utilization = Param.Float(0.95, "utilization the queueing model "
+                                  "saturates at")
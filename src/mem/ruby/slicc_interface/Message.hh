@@ -48,6 +48,7 @@
 #include "mem/packet.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/common/WriteMask.hh"
+#include "mem/ruby/slicc_interface/MessagePool.hh"
 #include "mem/ruby/protocol/MessageSizeType.hh"
 
 namespace gem5
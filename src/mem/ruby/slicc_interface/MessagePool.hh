@@ -0,0 +1,30 @@
+#ifndef __MEM_RUBY_SLICC_INTERFACE_MESSAGEPOOL_HH__
+#define __MEM_RUBY_SLICC_INTERFACE_MESSAGEPOOL_HH__
+
+#include <memory>
+#include <utility>
+
+#include "base/slab_pool.hh"
+
+namespace gem5
+{
+
+namespace ruby
+{
+
+/**
+ * Create a message, and its reference count, from the SlabPool. Every
+ * controller creates messages all the time and the network drops them as
+ * often.
+ */
+template <typename T, typename ...Args>
+std::shared_ptr<T>
+makeMessage(Args &&...args)
+{
+    return makeSlabShared<T>(std::forward<Args>(args)...);
+}
+
+} // namespace ruby
+} // namespace gem5
+
+#endif //__MEM_RUBY_SLICC_INTERFACE_MESSAGEPOOL_HH__
@@ -43,7 +43,6 @@
 #define __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "base/statistics.hh"
@@ -168,6 +167,13 @@ class CacheMemory : public SimObject
     int findTagInSet(int64_t line, Addr tag) const;
     int findTagInSetIgnorePermissions(int64_t cacheSet, Addr tag) const;
 
+    // Index of a way in the set-major arrays below
+    size_t
+    wayIndex(int64_t cacheSet, int way) const
+    {
+        return cacheSet * m_cache_assoc + way;
+    }
+
     // Private copy constructor and assignment operator
     CacheMemory(const CacheMemory& obj);
     CacheMemory& operator=(const CacheMemory& obj);
@@ -176,10 +182,13 @@ class CacheMemory : public SimObject
     // Data Members (m_prefix)
     bool m_is_instruction_only_cache;
 
-    // The first index is the # of cache lines.
-    // The second index is the the amount associativity.
-    std::unordered_map<Addr, int> m_tag_index;
-    std::vector<std::vector<AbstractCacheEntry*> > m_cache;
+    // The ways of the cache, set after set, indexed by wayIndex(). The
+    // tags of the allocated entries are kept apart so that a lookup scans
+    // the tags of a set straight from one array, without touching the
+    // entries. Unallocated ways have the tag InvalidTag.
+    static constexpr Addr InvalidTag = MaxAddr;
+    std::vector<Addr> m_tags;
+    std::vector<AbstractCacheEntry*> m_cache;
 
     /** We use the replacement policies from the Classic memory system. */
     replacement_policy::Base *m_replacementPolicy_ptr;
@@ -196,14 +205,14 @@ class CacheMemory : public SimObject
     int m_block_size;
 
     /**
-     * We store all the ReplacementData in a 2-dimensional array. By doing
-     * this, we can use all replacement policies from Classic system. Ruby
-     * cache will deallocate cache entry every time we evict the cache block
-     * so we cannot store the ReplacementData inside the cache entry.
+     * We store all the ReplacementData in an array indexed like m_cache. By
+     * doing this, we can use all replacement policies from Classic system.
+     * Ruby cache will deallocate cache entry every time we evict the cache
+     * block so we cannot store the ReplacementData inside the cache entry.
      * Instantiate ReplacementData for multiple times will break replacement
      * policy like TreePLRU.
      */
-    std::vector<std::vector<ReplData> > replacement_data;
+    std::vector<ReplData> replacement_data;
 
     /**
      * Set to true when using WeightedLRU replacement policy, otherwise, set to
@@ -41,9 +41,12 @@
 #ifndef __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 #define __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 
+#include <algorithm>
+#include <deque>
 #include <iostream>
-#include <unordered_map>
+#include <vector>
 
+#include "base/intmath.hh"
 #include "mem/ruby/common/Address.hh"
 
 namespace gem5
@@ -52,13 +55,23 @@ namespace gem5
 namespace ruby
 {
 
+/**
+ * TBEs are kept in a pool sized from the number of TBEs of the controller,
+ * so allocating one never goes to the heap and the pointers handed out stay
+ * valid until the TBE is deallocated. The pool grows if a protocol
+ * allocates more TBEs than configured. They are found through an
+ * open-addressed, linearly probed index kept at most half full.
+ */
 template<class ENTRY>
 class TBETable
 {
   public:
     TBETable(int number_of_TBEs)
-        : m_number_of_TBEs(number_of_TBEs)
+        : m_entries(number_of_TBEs), m_number_of_TBEs(number_of_TBEs)
     {
+        for (int i = number_of_TBEs - 1; i >= 0; i--)
+            m_free.push_back(i);
+        resizeIndex(number_of_TBEs);
     }
 
     bool isPresent(Addr address) const;
@@ -67,7 +80,7 @@ class TBETable
     bool
     areNSlotsAvailable(int n, Tick current_time) const
     {
-        return (m_number_of_TBEs - m_map.size()) >= n;
+        return (m_number_of_TBEs - m_size) >= n;
     }
 
     ENTRY *getNullEntry();
@@ -81,10 +94,42 @@ class TBETable
     TBETable(const TBETable& obj);
     TBETable& operator=(const TBETable& obj);
 
+    /** A slot of the index, entry is -1 if it is empty. */
+    struct Slot
+    {
+        Addr address;
+        int entry = -1;
+    };
+
+    /** Position of the slot holding address, or of the empty slot where
+     * it would go. */
+    size_t
+    findSlot(Addr address) const
+    {
+        size_t pos = hash(address);
+        while (m_index[pos].entry != -1 && m_index[pos].address != address)
+            pos = (pos + 1) & m_index_mask;
+        return pos;
+    }
+
+    size_t
+    hash(Addr address) const
+    {
+        return ((address >> 6) * 0x9e3779b97f4a7c15ULL) >> m_index_shift;
+    }
+
+    void resizeIndex(size_t capacity);
+
     // Data Members (m_prefix)
-    std::unordered_map<Addr, ENTRY> m_map;
+    std::vector<Slot> m_index;
+    // A deque keeps the entries in place when the pool grows
+    std::deque<ENTRY> m_entries;
+    std::vector<int> m_free;
+    int m_size = 0;
 
   private:
+    size_t m_index_mask = 0;
+    int m_index_shift = 0;
     int m_number_of_TBEs;
 };
 
@@ -97,13 +142,27 @@ operator<<(std::ostream& out, const TBETable<ENTRY>& obj)
     return out;
 }
 
+template<class ENTRY>
+inline void
+TBETable<ENTRY>::resizeIndex(size_t capacity)
+{
+    const size_t size = size_t(1) << std::max(3, ceilLog2(2 * capacity + 1));
+    std::vector<Slot> old(size);
+    old.swap(m_index);
+    m_index_mask = size - 1;
+    m_index_shift = 64 - floorLog2(size);
+    for (const auto &slot : old) {
+        if (slot.entry != -1)
+            m_index[findSlot(slot.address)] = slot;
+    }
+}
+
 template<class ENTRY>
 inline bool
 TBETable<ENTRY>::isPresent(Addr address) const
 {
     assert(address == makeLineAddress(address));
-    assert(m_map.size() <= m_number_of_TBEs);
-    return !!m_map.count(address);
+    return m_index[findSlot(address)].entry != -1;
 }
 
 template<class ENTRY>
@@ -111,8 +170,19 @@ inline void
 TBETable<ENTRY>::allocate(Addr address)
 {
     assert(!isPresent(address));
-    assert(m_map.size() < m_number_of_TBEs);
-    m_map[address] = ENTRY();
+    if (m_free.empty()) {
+        // Protocols which do not check for free TBEs may allocate more
+        // than configured: grow the pool rather than fail.
+        m_free.push_back(m_entries.size());
+        m_entries.emplace_back();
+        if (2 * m_entries.size() > m_index.size())
+            resizeIndex(m_entries.size());
+    }
+    const int entry = m_free.back();
+    m_free.pop_back();
+    m_entries[entry] = ENTRY();
+    m_index[findSlot(address)] = Slot{address, entry};
+    m_size++;
 }
 
 template<class ENTRY>
@@ -120,8 +190,23 @@ inline void
 TBETable<ENTRY>::deallocate(Addr address)
 {
     assert(isPresent(address));
-    assert(m_map.size() > 0);
-    m_map.erase(address);
+    assert(m_size > 0);
+    size_t pos = findSlot(address);
+    m_free.push_back(m_index[pos].entry);
+    m_index[pos].entry = -1;
+    m_size--;
+
+    // Shift back the slots that follow in the probe sequence, so that no
+    // lookup stops early at the hole left behind.
+    for (size_t next = (pos + 1) & m_index_mask; m_index[next].entry != -1;
+         next = (next + 1) & m_index_mask) {
+        const size_t home = hash(m_index[next].address);
+        if (((next - home) & m_index_mask) >= ((next - pos) & m_index_mask)) {
+            m_index[pos] = m_index[next];
+            m_index[next].entry = -1;
+            pos = next;
+        }
+    }
 }
 
 template<class ENTRY>
@@ -136,8 +221,9 @@ template<class ENTRY>
 inline ENTRY*
 TBETable<ENTRY>::lookup(Addr address)
 {
-  if (m_map.find(address) != m_map.end()) return &(m_map.find(address)->second);
-  return NULL;
+    const Slot &slot = m_index[findSlot(address)];
+    if (slot.entry != -1) return &m_entries[slot.entry];
+    return NULL;
 }
 
 
@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+#include "mem/ruby/structures/TBETable.hh"
+
+using namespace gem5;
+using namespace gem5::ruby;
+
+namespace gem5
+{
+namespace ruby
+{
+
+// The table only checks that its addresses are line addresses, so give it
+// 64 byte lines instead of asking a RubySystem.
+Addr
+makeLineAddress(Addr addr)
+{
+    return addr & ~Addr(63);
+}
+
+} // namespace ruby
+} // namespace gem5
+
+namespace
+{
+
+struct Entry
+{
+    Addr address = 0;
+};
+
+Addr
+line(uint64_t n)
+{
+    return n << 6;
+}
+
+} // anonymous namespace
+
+TEST(TBETableTest, AllocateLookupDeallocate)
+{
+    TBETable<Entry> table(4);
+    EXPECT_TRUE(table.areNSlotsAvailable(4, 0));
+    EXPECT_FALSE(table.areNSlotsAvailable(5, 0));
+
+    table.allocate(line(1));
+    table.allocate(line(2));
+    EXPECT_TRUE(table.isPresent(line(1)));
+    EXPECT_TRUE(table.isPresent(line(2)));
+    EXPECT_FALSE(table.isPresent(line(3)));
+    EXPECT_EQ(table.lookup(line(3)), nullptr);
+    EXPECT_TRUE(table.areNSlotsAvailable(2, 0));
+    EXPECT_FALSE(table.areNSlotsAvailable(3, 0));
+
+    Entry *entry = table.lookup(line(2));
+    ASSERT_NE(entry, nullptr);
+    entry->address = line(2);
+    table.deallocate(line(1));
+    EXPECT_FALSE(table.isPresent(line(1)));
+    EXPECT_EQ(table.lookup(line(2)), entry);
+    EXPECT_EQ(entry->address, line(2));
+
+    // A reallocated TBE starts out fresh.
+    table.deallocate(line(2));
+    table.allocate(line(2));
+    EXPECT_EQ(table.lookup(line(2))->address, 0);
+}
+
+/** More TBEs than configured grow the pool, and keep the others in place. */
+TEST(TBETableTest, Grow)
+{
+    TBETable<Entry> table(2);
+    std::vector<Entry *> entries;
+    for (uint64_t n = 0; n < 64; n++) {
+        table.allocate(line(n));
+        entries.push_back(table.lookup(line(n)));
+        ASSERT_NE(entries.back(), nullptr);
+        entries.back()->address = line(n);
+    }
+    EXPECT_FALSE(table.areNSlotsAvailable(1, 0));
+    for (uint64_t n = 0; n < 64; n++) {
+        EXPECT_EQ(table.lookup(line(n)), entries[n]);
+        EXPECT_EQ(entries[n]->address, line(n));
+    }
+
+    for (uint64_t n = 0; n < 64; n += 2)
+        table.deallocate(line(n));
+    for (uint64_t n = 0; n < 64; n++)
+        EXPECT_EQ(table.isPresent(line(n)), n % 2 == 1);
+    for (uint64_t n = 1; n < 64; n += 2)
+        table.deallocate(line(n));
+    EXPECT_TRUE(table.areNSlotsAvailable(2, 0));
+}
+
+/** Random allocations and deallocations, checked against a std::map. */
+TEST(TBETableTest, Random)
+{
+    std::mt19937_64 rng(0x7be);
+    TBETable<Entry> table(16);
+    std::map<Addr, Entry *> ref;
+    for (int round = 0; round < 100000; round++) {
+        // Few distinct lines, so that probe sequences collide.
+        const Addr addr = line(rng() % 48);
+        auto it = ref.find(addr);
+        ASSERT_EQ(table.isPresent(addr), it != ref.end());
+        if (it == ref.end()) {
+            table.allocate(addr);
+            Entry *entry = table.lookup(addr);
+            ASSERT_NE(entry, nullptr);
+            entry->address = addr;
+            ref[addr] = entry;
+        } else {
+            ASSERT_EQ(table.lookup(addr), it->second);
+            ASSERT_EQ(it->second->address, addr);
+            table.deallocate(addr);
+            ref.erase(it);
+        }
+    }
+    for (const auto &[addr, entry] : ref)
+        EXPECT_EQ(table.lookup(addr), entry);
+}
@@ -198,7 +198,7 @@ HTMSequencer::htmCallback(Addr address,
             rubyHtmCallback(pkt, htm_return_code);
             testDrainComplete();
             pkt = nullptr;
-            seq_req_list.pop_front();
+            popRequest(seq_req_list);
         }
         // free all outstanding requests corresponding to this address
         if (seq_req_list.empty()) {
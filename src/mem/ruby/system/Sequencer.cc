@@ -351,8 +351,15 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType primary_type,
     // Check if there is any outstanding request for the same cache line.
     auto &seq_req_list = m_RequestTable[line_addr];
     // Create a default entry
-    seq_req_list.emplace_back(pkt, primary_type,
-        secondary_type, curCycle());
+    if (m_freeRequests.empty()) {
+        seq_req_list.emplace_back(pkt, primary_type,
+            secondary_type, curCycle());
+    } else {
+        m_freeRequests.front() = SequencerRequest(pkt, primary_type,
+            secondary_type, curCycle());
+        seq_req_list.splice(seq_req_list.end(), m_freeRequests,
+                            m_freeRequests.begin());
+    }
     m_outstanding_count++;
 
     if (seq_req_list.size() > 1) {
@@ -536,7 +543,7 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
                         initialRequestTime, forwardRequestTime,
                         firstResponseTime, !ruby_request);
         }
-        seq_req_list.pop_front();
+        popRequest(seq_req_list);
     }
 
     // free all outstanding requests corresponding to this address
@@ -591,7 +598,7 @@ Sequencer::readCallback(Addr address, DataBlock& data,
                     initialRequestTime, forwardRequestTime,
                     firstResponseTime, !ruby_request);
         ruby_request = false;
-        seq_req_list.pop_front();
+        popRequest(seq_req_list);
     }
 
     // free all outstanding requests corresponding to this address
@@ -888,10 +895,10 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     // requests do not
     std::shared_ptr<RubyRequest> msg;
     if (pkt->req->isMemMgmt()) {
-        msg = std::make_shared<RubyRequest>(clockEdge(),
-                                            pc, secondary_type,
-                                            RubyAccessMode_Supervisor, pkt,
-                                            proc_id, core_id);
+        msg = makeMessage<RubyRequest>(clockEdge(),
+                                       pc, secondary_type,
+                                       RubyAccessMode_Supervisor, pkt,
+                                       proc_id, core_id);
 
         DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %s\n",
                 curTick(), m_version, "Seq", "Begin", "", "",
@@ -915,10 +922,10 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
                     msg->m_tlbiTransactionUid);
         }
     } else {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                                            pkt->getSize(), pc, secondary_type,
-                                            RubyAccessMode_Supervisor, pkt,
-                                            PrefetchBit_No, proc_id, core_id);
+        msg = makeMessage<RubyRequest>(clockEdge(), pkt->getAddr(),
+                                       pkt->getSize(), pc, secondary_type,
+                                       RubyAccessMode_Supervisor, pkt,
+                                       PrefetchBit_No, proc_id, core_id);
 
         DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %s\n",
                 curTick(), m_version, "Seq", "Begin", "", "",
@@ -942,9 +949,10 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, clockEdge(), latency);
 }
 
-template <class KEY, class VALUE>
+template <class KEY, class VALUE, class HASH, class EQUAL, class ALLOC>
 std::ostream &
-operator<<(std::ostream &out, const std::unordered_map<KEY, VALUE> &map)
+operator<<(std::ostream &out,
+           const std::unordered_map<KEY, VALUE, HASH, EQUAL, ALLOC> &map)
 {
     for (const auto &table_entry : map) {
         out << "[ " << table_entry.first << " =";
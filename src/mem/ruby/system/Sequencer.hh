@@ -45,6 +45,7 @@
 #include <list>
 #include <unordered_map>
 
+#include "base/slab_pool.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/protocol/MachineType.hh"
 #include "mem/ruby/protocol/RubyRequestType.hh"
@@ -220,8 +221,22 @@ class Sequencer : public RubyPort
     Sequencer& operator=(const Sequencer& obj);
 
   protected:
+    /**
+     * The nodes of the table come from the SlabPool, so that a line that
+     * gets its first outstanding request does not allocate either.
+     */
+    typedef std::unordered_map<Addr, std::list<SequencerRequest>,
+        std::hash<Addr>, std::equal_to<Addr>,
+        SlabAllocator<std::pair<const Addr, std::list<SequencerRequest>>>>
+        RequestTable;
+
     // RequestTable contains both read and write requests, handles aliasing
-    std::unordered_map<Addr, std::list<SequencerRequest>> m_RequestTable;
+    RequestTable m_RequestTable;
+    /**
+     * Nodes of completed requests, spliced back into m_RequestTable by
+     * insertRequest() so that issuing a request does not allocate.
+     */
+    std::list<SequencerRequest> m_freeRequests;
     // UnadressedRequestTable contains "unaddressed" requests,
     // guaranteed not to alias each other
     std::unordered_map<uint64_t, SequencerRequest> m_UnaddressedRequestTable;
@@ -232,6 +247,14 @@ class Sequencer : public RubyPort
                                         RubyRequestType primary_type,
                                         RubyRequestType secondary_type);
 
+    /** Remove the oldest request of a line, keeping its node. */
+    void
+    popRequest(std::list<SequencerRequest> &seq_req_list)
+    {
+        m_freeRequests.splice(m_freeRequests.begin(), seq_req_list,
+                              seq_req_list.begin());
+    }
+
   private:
     int m_max_outstanding_requests;
 
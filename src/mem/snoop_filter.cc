@@ -42,6 +42,10 @@
 
 #include "mem/snoop_filter.hh"
 
+#include <algorithm>
+#include <new>
+
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
@@ -52,17 +56,81 @@ namespace gem5
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
 
+SnoopFilter::SnoopFilterCache::SnoopFilterCache(size_t entries,
+                                                unsigned assoc,
+                                                unsigned line_size)
+    : assoc(std::max(assoc, 1U)),
+      numSets(std::max<size_t>(entries / this->assoc, 1)),
+      lineShift(floorLog2(line_size)),
+      tags(numSets * this->assoc, InvalidTag),
+      storage(new std::byte[tags.size() * sizeof(SnoopItem)]),
+      items(reinterpret_cast<SnoopItem *>(storage.get()))
+{
+    fatal_if(assoc == 0, "Snoop filter associativity must be at least 1.");
+}
+
+SnoopFilter::SnoopItem *
+SnoopFilter::SnoopFilterCache::insert(Addr line_addr, bool &conflict)
+{
+    conflict = false;
+    if (SnoopItem *item = find(line_addr))
+        return item;
+
+    count++;
+    const size_t base = setOf(line_addr) * assoc;
+    for (unsigned way = 0; way < assoc; way++) {
+        if (tags[base + way] == InvalidTag) {
+            tags[base + way] = line_addr;
+            return new (&items[base + way]) SnoopItem();
+        }
+    }
+    conflict = true;
+    return &overflow.emplace(line_addr, SnoopItem()).first->second;
+}
+
+void
+SnoopFilter::SnoopFilterCache::erase(Addr line_addr)
+{
+    assert(count > 0);
+    count--;
+    const size_t base = setOf(line_addr) * assoc;
+    for (unsigned way = 0; way < assoc; way++) {
+        if (tags[base + way] == line_addr) {
+            tags[base + way] = InvalidTag;
+            return;
+        }
+    }
+    [[maybe_unused]] size_t erased = overflow.erase(line_addr);
+    assert(erased == 1);
+}
+
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::eraseIfNullEntry(Addr line_addr, SnoopItem *sf_item)
 {
-    SnoopItem& sf_item = sf_it->second;
-    if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
+    if ((sf_item->requested | sf_item->holder).none()) {
+        cachedLocations.erase(line_addr);
         DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
                 __func__);
     }
 }
 
+SnoopFilter::SnoopItem *
+SnoopFilter::allocateLine(Addr line_addr)
+{
+    bool conflict;
+    SnoopItem *sf_item = cachedLocations.insert(line_addr, conflict);
+    if (conflict) {
+        // A directory of this geometry would evict a line of the set,
+        // and back-invalidate it in the caches above.
+        stats.setConflicts++;
+        DPRINTF(SnoopFilter, "%s:   Set of %#x full, line overflows.\n",
+                __func__, line_addr);
+    }
+    if (cachedLocations.size() > stats.peakEntries.value())
+        stats.peakEntries = cachedLocations.size();
+    return sf_item;
+}
+
 std::pair<SnoopFilter::SnoopList, Cycles>
 SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
                            cpu_side_port)
@@ -78,8 +146,9 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(cpu_side_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    reqLookupResult.item = cachedLocations.find(line_addr);
+    reqLookupResult.lineAddr = line_addr;
+    bool is_hit = (reqLookupResult.item != nullptr);
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -87,12 +156,11 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
     if (!is_hit && !allocate)
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
+    // If no hit in snoop filter create a new element and remember it
     if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
+        reqLookupResult.item = allocateLine(line_addr);
     }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    SnoopItem& sf_item = *reqLookupResult.item;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -159,26 +227,27 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const ResponsePort&
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.item) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.lineAddr == line_addr);
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            *reqLookupResult.item = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(line_addr, reqLookupResult.item);
+        reqLookupResult.item = nullptr;
     }
 }
 
@@ -193,8 +262,8 @@ SnoopFilter::lookupSnoop(Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopItem *sf_it = cachedLocations.find(line_addr);
+    bool is_hit = (sf_it != nullptr);
 
     panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
@@ -217,7 +286,7 @@ SnoopFilter::lookupSnoop(Packet* cpkt)
         return snoopDown(lookupLatency);
     }
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_it;
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -247,7 +316,7 @@ SnoopFilter::lookupSnoop(Packet* cpkt)
         sf_item.holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -277,7 +346,7 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem& sf_item = *allocateLine(line_addr);
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -324,8 +393,8 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopItem *sf_it = cachedLocations.find(line_addr);
+    bool is_hit = sf_it != nullptr;
 
     // Nothing to do if it is not a hit
     if (!is_hit)
@@ -335,7 +404,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem& sf_item = *sf_it;
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
@@ -343,7 +412,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     }
 }
 
@@ -366,12 +435,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopItem *sf_it = cachedLocations.find(line_addr);
+    if (sf_it == nullptr)
         return;
 
     SnoopMask response_mask = portToMask(cpu_side_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_it;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -390,7 +459,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const ResponsePort&
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~response_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_it);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -418,7 +487,15 @@ SnoopFilter::SnoopFilterStats::SnoopFilterStats(statistics::Group *parent)
                "holder of the requested data."),
       ADD_STAT(hitMultiSnoops, statistics::units::Count::get(),
                "Number of snoops hitting in the snoop filter with multiple "
-               "(>1) holders of the requested data.")
+               "(>1) holders of the requested data."),
+      ADD_STAT(setConflicts, statistics::units::Count::get(),
+               "Number of lines allocated in a full set, that a directory "
+               "of this geometry would have back-invalidated."),
+      ADD_STAT(peakEntries, statistics::units::Count::get(),
+               "Largest number of lines tracked at once."),
+      ADD_STAT(overflowLookups, statistics::units::Count::get(),
+               "Number of lookups that missed the table and searched the "
+               "overflow map of the lines of full sets.")
 {}
 
 void
@@ -44,8 +44,11 @@
 #define __MEM_SNOOP_FILTER_HH__
 
 #include <bitset>
+#include <cstddef>
+#include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "mem/packet.hh"
 #include "mem/port.hh"
@@ -96,11 +99,16 @@ class SnoopFilter : public SimObject
     typedef std::vector<QueuedResponsePort*> SnoopList;
 
     SnoopFilter (const SnoopFilterParams &p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
+        SimObject(p),
+        cachedLocations(p.max_capacity / p.system->cacheLineSize(), p.assoc,
+                        p.system->cacheLineSize()),
         linesize(p.system->cacheLineSize()), lookupLatency(p.lookup_latency),
         maxEntryCount(p.max_capacity / p.system->cacheLineSize()),
         stats(this)
     {
+        stats.overflowLookups.functor([this]() {
+            return cachedLocations.overflowLookups();
+        });
     }
 
     /**
@@ -220,10 +228,57 @@ class SnoopFilter : public SimObject
         SnoopMask requested;
         SnoopMask holder;
     };
+
     /**
-     * HashMap of SnoopItems indexed by line address
+     * Set associative table of SnoopItems indexed by line address. The
+     * tags of a set are next to each other, so that a lookup touches
+     * one or two host cache lines, and the items are only written when
+     * a line is allocated. A line that finds its set full goes to an
+     * overflow map: the filter cannot back-invalidate the caches above,
+     * so it never drops a line it tracks.
      */
-    typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
+    class SnoopFilterCache
+    {
+      public:
+        SnoopFilterCache(size_t entries, unsigned assoc, unsigned line_size);
+
+        /** The item of a line, or nullptr if the line is not tracked. */
+        SnoopItem *find(Addr line_addr);
+
+        /**
+         * The item of a line, a new empty one if the line is not
+         * tracked yet. Sets conflict if a new line found its set full.
+         */
+        SnoopItem *insert(Addr line_addr, bool &conflict);
+
+        /** Stop tracking a line. */
+        void erase(Addr line_addr);
+
+        /** Number of lines tracked. */
+        size_t size() const { return count; }
+
+        /**
+         * Number of lookups that missed the table and searched the
+         * overflow map, the host cost of the set conflicts.
+         */
+        uint64_t overflowLookups() const { return overflowSearches; }
+
+      private:
+        static constexpr Addr InvalidTag = MaxAddr;
+
+        size_t setOf(Addr line_addr) const;
+
+        const unsigned assoc;
+        const size_t numSets;
+        const unsigned lineShift;
+        std::vector<Addr> tags;
+        /** Storage of the items, not initialised until allocated. */
+        std::unique_ptr<std::byte[]> storage;
+        SnoopItem *items;
+        std::unordered_map<Addr, SnoopItem> overflow;
+        size_t count = 0;
+        uint64_t overflowSearches = 0;
+    };
 
     /**
      * Simple factory methods for standard return values.
@@ -261,9 +316,12 @@ class SnoopFilter : public SimObject
     /**
      * Removes snoop filter items which have no requestors and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(Addr line_addr, SnoopItem *sf_item);
+
+    /** Find or allocate the item of a line, and account for it. */
+    SnoopItem *allocateLine(Addr line_addr);
 
-    /** Simple hash set of cached addresses. */
+    /** Table of the cached lines. */
     SnoopFilterCache cachedLocations;
 
     /**
@@ -274,27 +332,18 @@ class SnoopFilter : public SimObject
      */
     struct ReqLookupResult
     {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /** Item found or allocated by lookupRequest, if any. */
+        SnoopItem *item = nullptr;
+
+        /** Line address of the item. */
+        Addr lineAddr = 0;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
          * in case finishRequest needs to undo changes made in lookupRequest
          * (because of crossbar retry)
          */
-        SnoopItem retryItem;
-
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
-        {
-        }
-        ReqLookupResult() = delete;
+        SnoopItem retryItem{0, 0};
     } reqLookupResult;
 
     /** List of all attached snooping CPU-side ports. */
@@ -329,9 +378,35 @@ class SnoopFilter : public SimObject
         statistics::Scalar totSnoops;
         statistics::Scalar hitSingleSnoops;
         statistics::Scalar hitMultiSnoops;
+
+        statistics::Scalar setConflicts;
+        statistics::Scalar peakEntries;
+        statistics::Value overflowLookups;
     } stats;
 };
 
+inline size_t
+SnoopFilter::SnoopFilterCache::setOf(Addr line_addr) const
+{
+    const Addr line = line_addr >> lineShift;
+    return (line ^ (line >> 20)) % numSets;
+}
+
+inline SnoopFilter::SnoopItem *
+SnoopFilter::SnoopFilterCache::find(Addr line_addr)
+{
+    const size_t base = setOf(line_addr) * assoc;
+    for (unsigned way = 0; way < assoc; way++) {
+        if (tags[base + way] == line_addr)
+            return &items[base + way];
+    }
+    if (overflow.empty())
+        return nullptr;
+    overflowSearches++;
+    auto it = overflow.find(line_addr);
+    return it == overflow.end() ? nullptr : &it->second;
+}
+
 inline SnoopFilter::SnoopMask
 SnoopFilter::portToMask(const ResponsePort& port) const
 {
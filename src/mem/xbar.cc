@@ -45,6 +45,8 @@
 
 #include "mem/xbar.hh"
 
+#include <iterator>
+
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
@@ -54,6 +56,102 @@
 namespace gem5
 {
 
+Request::XBarSlot *
+XBarRoutes::find(const RequestPtr &req) const
+{
+    for (auto &slot : req->xbarSlots) {
+        if (slot.owner == owner)
+            return &slot;
+    }
+    if (spilled.empty())
+        return nullptr;
+    auto it = spilled.find(req);
+    return it == spilled.end() ? nullptr : &it->second;
+}
+
+Request::XBarSlot &
+XBarRoutes::claim(const RequestPtr &req)
+{
+    if (auto slot = find(req))
+        return *slot;
+    for (auto &slot : req->xbarSlots) {
+        if (!slot.owner) {
+            slot.owner = owner;
+            return slot;
+        }
+    }
+    auto &slot = spilled[req];
+    slot.owner = owner;
+    return slot;
+}
+
+void
+XBarRoutes::release(const RequestPtr &req, Request::XBarSlot &slot)
+{
+    if (slot.route != InvalidPortID || slot.snoop)
+        return;
+    if (&slot >= std::begin(req->xbarSlots) &&
+        &slot < std::end(req->xbarSlots)) {
+        slot = Request::XBarSlot();
+    } else {
+        spilled.erase(req);
+    }
+}
+
+PortID
+XBarRoutes::route(const RequestPtr &req) const
+{
+    auto slot = find(req);
+    return slot ? slot->route : InvalidPortID;
+}
+
+void
+XBarRoutes::setRoute(const RequestPtr &req, PortID port)
+{
+    assert(port != InvalidPortID);
+    auto &slot = claim(req);
+    assert(slot.route == InvalidPortID);
+    slot.route = port;
+    _numRoutes++;
+}
+
+void
+XBarRoutes::clearRoute(const RequestPtr &req)
+{
+    auto slot = find(req);
+    assert(slot && slot->route != InvalidPortID);
+    slot->route = InvalidPortID;
+    _numRoutes--;
+    release(req, *slot);
+}
+
+bool
+XBarRoutes::snoop(const RequestPtr &req) const
+{
+    auto slot = find(req);
+    return slot && slot->snoop;
+}
+
+void
+XBarRoutes::setSnoop(const RequestPtr &req)
+{
+    auto &slot = claim(req);
+    assert(!slot.snoop);
+    slot.snoop = true;
+    _numSnoops++;
+}
+
+void
+XBarRoutes::clearSnoop(const RequestPtr &req)
+{
+    auto slot = find(req);
+    if (!slot || !slot->snoop)
+        return;
+    slot->snoop = false;
+    _numSnoops--;
+    release(req, *slot);
+}
+
 BaseXBar::BaseXBar(const BaseXBarParams &p)
     : ClockedObject(p),
       frontendLatency(p.frontend_latency),
@@ -61,6 +159,7 @@ BaseXBar::BaseXBar(const BaseXBarParams &p)
       responseLatency(p.response_latency),
       headerLatency(p.header_latency),
       width(p.width),
+      routeTo(this),
       gotAddrRanges(p.port_default_connection_count +
                           p.port_mem_side_ports_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
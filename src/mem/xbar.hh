@@ -52,6 +52,7 @@
 #include "base/addr_range_map.hh"
 #include "base/types.hh"
 #include "mem/qport.hh"
+#include "mem/request.hh"
 #include "params/BaseXBar.hh"
 #include "sim/clocked_object.hh"
 #include "sim/stats.hh"
@@ -59,6 +60,47 @@
 namespace gem5
 {
 
+/**
+ * The requests in flight through a crossbar that it has to route a
+ * response back for, and the ones it expects a snoop response it created
+ * for. The state of a request is kept in one of the crossbar slots of the
+ * request, tagged with the crossbar, so that tracking a request does not
+ * hash it. It goes to a table when the request is in flight through more
+ * crossbars than it has slots. This relies on the fact that the
+ * underlying Request pointer inside the Packet stays constant.
+ */
+class XBarRoutes
+{
+  public:
+    explicit XBarRoutes(const void *owner) : owner(owner) {}
+
+    /** Where to route the response, InvalidPortID if not known. */
+    PortID route(const RequestPtr &req) const;
+    void setRoute(const RequestPtr &req, PortID port);
+    void clearRoute(const RequestPtr &req);
+
+    /** Is a snoop response we created expected for the request? */
+    bool snoop(const RequestPtr &req) const;
+    void setSnoop(const RequestPtr &req);
+    void clearSnoop(const RequestPtr &req);
+
+    /** Number of requests with a route. */
+    size_t numRoutes() const { return _numRoutes; }
+    /** Number of requests expecting a snoop response. */
+    size_t numSnoops() const { return _numSnoops; }
+
+  private:
+    Request::XBarSlot *find(const RequestPtr &req) const;
+    Request::XBarSlot &claim(const RequestPtr &req);
+    /** Free the slot of a request if it holds nothing anymore. */
+    void release(const RequestPtr &req, Request::XBarSlot &slot);
+
+    const void *owner;
+    mutable std::unordered_map<RequestPtr, Request::XBarSlot> spilled;
+    size_t _numRoutes = 0;
+    size_t _numSnoops = 0;
+};
+
 /**
  * The base crossbar contains the common elements of the non-coherent
  * and coherent crossbar. It is an abstract class that does not have
@@ -320,11 +362,9 @@ class BaseXBar : public ClockedObject
 
     /**
      * Remember where request packets came from so that we can route
-     * responses to the appropriate port. This relies on the fact that
-     * the underlying Request pointer inside the Packet stays
-     * constant.
+     * responses to the appropriate port.
      */
-    std::unordered_map<RequestPtr, PortID> routeTo;
+    XBarRoutes routeTo;
 
     /** all contigous ranges seen by this crossbar */
     AddrRangeList xbarRanges;
@@ -112,6 +112,20 @@ def parse_options():
     group("Statistics Options")
     option("--stats-file", metavar="FILE", default="stats.txt",
         help="Sets the output file for statistics [Default: %default]")
+    option("--stats-filter", metavar="GLOB[,GLOB]", action='append',
+        split=',',
+        help="Only keep the stats matching GLOB (-GLOB drops them). GLOB "
+             "matches the names in stats.txt, the last match wins")
+    option("--stats-filter-file", metavar="FILE",
+        help="Read --stats-filter globs from FILE, one per line")
+    option("--stats-sample", metavar="GLOB=N[,GLOB=N]", action='append',
+        split=',',
+        help="Only record every Nth sample of the distributions matching "
+             "GLOB")
+    option("--host-profile", metavar="FILE", default=None,
+        help="Charge the host time of events to SimObjects, in the "
+             "hostProfile stats and as folded stacks for flamegraph.pl in "
+             "FILE (needs USE_HOST_PROFILING)")
     option("--stats-help",
            action="callback", callback=_stats_help,
            help="Display documentation for available stat visitors")
@@ -146,6 +160,14 @@ def parse_options():
               " to be compressed automatically [Default: %default]")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
+    option("--debug-ring", metavar="SIZE", default=None,
+        help="Keep the debug output unformatted in a ring of SIZE (e.g. "
+             "64MiB) per flag and thread, only written to the debug file "
+             "on abort, difftest mismatch or --debug-ring-dump/-pc")
+    option("--debug-ring-dump", metavar="TICK[,TICK]", action='append',
+        split=',', help="Write out the debug ring at TICK(s)")
+    option("--debug-ring-pc", metavar="PC", default=None,
+        help="Write out the debug ring when the instruction at PC commits")
     option("--remote-gdb-port", type='int', default=7000,
         help="Remote gdb base port (set to 0 to disable listening)")
 
@@ -342,6 +364,25 @@ def main():
 
     # set stats options
     stats.addStatVisitor(options.stats_file)
+    for glob in options.stats_filter:
+        stats.addStatFilter(glob)
+    if options.stats_filter_file:
+        with open(options.stats_filter_file) as f:
+            for line in f:
+                glob = line.split('#', 1)[0].strip()
+                if glob:
+                    stats.addStatFilter(glob)
+    for sample in options.stats_sample:
+        glob, _, period = sample.rpartition('=')
+        if not glob or not period.isdigit() or int(period) == 0:
+            options.usage(2)
+        stats.addStatSampling(glob, int(period))
+
+    if options.host_profile:
+        if not _m5.core.USE_HOST_PROFILING:
+            fatal("Host profiling is not enabled.  Compile with "
+                  "USE_HOST_PROFILING")
+        _m5.core.enableHostProfile(options.host_profile)
 
     # Disable listeners unless running interactively or explicitly
     # enabled
@@ -402,6 +443,21 @@ def main():
         _check_tracing()
         trace.ignore(ignore)
 
+    if options.debug_ring:
+        _check_tracing()
+        from .util import convert
+        trace.enableRecorder(int(convert.toMemorySize(options.debug_ring)))
+        for when in options.debug_ring_dump:
+            e = event.create(lambda: trace.dumpRecorder("tick"),
+                             event.Event.Debug_Enable_Pri)
+            event.mainq.schedule(e, int(when))
+        if options.debug_ring_pc:
+            trace.setRecorderPC(int(options.debug_ring_pc, 0))
+    elif options.debug_ring_dump or options.debug_ring_pc:
+        print("--debug-ring-dump and --debug-ring-pc need --debug-ring",
+              file=sys.stderr)
+        sys.exit(1)
+
     sys.argv = arguments
     sys.path = [ os.path.dirname(sys.argv[0]) ] + sys.path
 
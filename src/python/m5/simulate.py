@@ -378,9 +378,6 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
         raise e
 
     if pid == 0:
-        # In child, notify objects of the fork
-        root = objects.Root.getInstance()
-        notifyFork(root)
         # Setup a new output directory
         parent = options.outdir
         options.outdir = simout % {
@@ -389,11 +386,79 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
                 "pid" : os.getpid(),
                 }
         _m5.core.setOutputDir(options.outdir)
+        # In child, notify objects of the fork, once they can put their
+        # files in the new output directory
+        root = objects.Root.getInstance()
+        notifyFork(root)
     else:
         fork_count += 1
 
     return pid
 
+def forkVariants(variants, run, simout="%(parent)s.f%(fork_seq)i",
+                 max_children=None):
+    """Run variants of a simulation window from the current state.
+
+    Every variant runs in a forked child, which starts from the state of
+    the parent, e.g. right after warmup, without restoring and warming
+    up again. The memory of the parent is shared copy-on-write.
+
+    The child calls run(variant), which changes what can be swapped at
+    this point (e.g. switches to one of several switched out CPUs with
+    different parameters), simulates the window and returns a picklable
+    result. The result is sent back to the parent over a pipe, and the
+    child then exits, writing its stats to its own output directory.
+
+    Keyword Arguments:
+      simout -- Output directory of the children, see fork().
+      max_children -- Number of children to run at once, all if None.
+
+    Return Value:
+      The results of the variants, in order.
+    """
+    import pickle
+
+    results = [None] * len(variants)
+    children = {}
+
+    def collect(pid):
+        index, rfd = children.pop(pid)
+        with os.fdopen(rfd, "rb") as f:
+            data = f.read()
+        os.waitpid(pid, 0)
+        if not data:
+            raise RuntimeError("Variant %d exited without a result" % index)
+        ok, value = pickle.loads(data)
+        if not ok:
+            raise RuntimeError("Variant %d failed: %s" % (index, value))
+        results[index] = value
+
+    for index, variant in enumerate(variants):
+        if max_children and len(children) >= max_children:
+            collect(next(iter(children)))
+
+        rfd, wfd = os.pipe()
+        pid = fork(simout)
+        if pid == 0:
+            os.close(rfd)
+            status = 0
+            try:
+                data = pickle.dumps((True, run(variant)))
+            except Exception as e:
+                data = pickle.dumps((False, repr(e)))
+                status = 1
+            with os.fdopen(wfd, "wb") as f:
+                f.write(data)
+            # Exit through the exit handlers, which dump the stats
+            sys.exit(status)
+
+        os.close(wfd)
+        children[pid] = (index, rfd)
+
+    while children:
+        collect(next(iter(children)))
+    return results
+
 from _m5.core import disableAllListeners, listenersDisabled
 from _m5.core import listenersLoopbackOnly
 from _m5.core import curTick
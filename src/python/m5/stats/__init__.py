@@ -43,7 +43,7 @@ import _m5.stats
 from m5.objects import Root
 from m5.params import isNullPointer
 from .gem5stats import JsonOutputVistor
-from m5.util import attrdict, fatal
+from m5.util import attrdict, fatal, inform
 
 # Stat exports
 from _m5.stats import schedStatEvent as schedEvent
@@ -147,6 +147,29 @@ def _textFactory(fn, desc=True, spaces=True):
 
     return _m5.stats.initText(fn, desc, spaces)
 
+@_url_factory([ "binary", ])
+def _binaryFactory(fn, delta=True, zstd=False):
+    """Output stats in a compact binary format.
+
+    The names, descriptions and shapes of the stats are written once,
+    every dump then only adds a block of values. This keeps the output
+    of runs with frequent periodic dumps small and fast to write. The
+    file can be read and converted back to stats.txt with
+    util/stats_binary.py.
+
+    Parameters:
+      * delta (bool): Only write the values that changed since the
+                      previous dump (default: True)
+      * zstd (bool): Compress the records, if gem5 was built with
+                     zstd (default: False)
+
+    Example:
+      binary://stats.bin?zstd=True
+
+    """
+
+    return _m5.stats.initBinary(fn, delta, zstd)
+
 @_url_factory([ "h5", ], enable=hasattr(_m5.stats, "initHDF5"))
 def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
     """Output stats in HDF5 format.
@@ -259,6 +282,76 @@ def _visit_stats(visitor, root=None):
             visitor(g, stat)
     _visit_groups(for_each_stat, root=root)
 
+# Stat filters, applied in order when the stats are enabled: tuples of
+# (glob, keep).
+stat_filters = []
+
+# Distributions to sample: tuples of (glob, period).
+stat_sampling = []
+
+def addStatFilter(glob):
+    '''Keep only the stats whose name matches a glob, or drop them if the
+    glob starts with '-'. Names are those in stats.txt, e.g.
+    "system.cpu*.ipc". The last matching filter decides. If the first
+    filter keeps stats, the stats that match no filter are dropped.
+
+    Dropped stats are not updated, prepared, reset or dumped anymore, and
+    vector stats release their storage. Formulas that are kept should not
+    depend on dropped vectors and distributions.'''
+
+    keep = not glob.startswith('-')
+    if glob[:1] in ('+', '-'):
+        glob = glob[1:]
+    stat_filters.append((glob, keep))
+
+def addStatSampling(glob, period):
+    '''Only record every period-th sample of the distributions whose name
+    matches a glob, with a weight of period.'''
+
+    stat_sampling.append((glob, period))
+
+def _visit_named_stats(visitor, root=None):
+    '''Call visitor(name, stat) with the stats.txt name of every stat.'''
+
+    def visit_group(group, prefix):
+        for stat in group.getStats():
+            visitor(prefix + stat.name, stat)
+        for name, child in group.getStatGroups().items():
+            visit_group(child, prefix + name + ".")
+
+    visit_group(Root.getInstance() if root is None else root, "")
+
+def _apply_filters():
+    from fnmatch import fnmatchcase
+
+    if not stat_filters and not stat_sampling:
+        return
+
+    default = not stat_filters or not stat_filters[0][1]
+    counts = { 'dropped' : 0, 'sampled' : 0, 'total' : 0 }
+
+    def apply(name, stat):
+        counts['total'] += 1
+        keep = default
+        for glob, keep_glob in stat_filters:
+            if fnmatchcase(name, glob):
+                keep = keep_glob
+        if not keep:
+            stat.disable()
+            counts['dropped'] += 1
+            return
+
+        if isinstance(stat, _m5.stats.DistInfo):
+            for glob, period in stat_sampling:
+                if fnmatchcase(name, glob):
+                    stat.samplePeriod(period)
+                    counts['sampled'] += 1
+                    break
+
+    _visit_named_stats(apply)
+    inform("Stats filter dropped %d of %d stats, sampling %d",
+           counts['dropped'], counts['total'], counts['sampled'])
+
 def _bindStatHierarchy(root):
     def _bind_obj(name, obj):
         if isNullPointer(obj):
@@ -321,6 +414,7 @@ def enable():
     # New stats
     _visit_stats(check_stat)
     _visit_stats(lambda g, s: s.enable())
+    _apply_filters()
 
     _m5.stats.enable();
 
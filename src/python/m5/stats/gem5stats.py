@@ -104,6 +104,8 @@ def get_stats_group(group: _m5.stats.Group) -> Group:
     stats_dict = {}
 
     for stat in group.getStats():
+        if stat.disabled:
+            continue
         statistic = __get_statistic(stat)
         if statistic is not None:
             stats_dict[stat.name] = statistic
@@ -26,3 +26,5 @@
 
 # Export native methods to Python
 from _m5.trace import output, ignore, disable, enable
+from _m5.trace import enableRecorder, disableRecorder, dumpRecorder
+from _m5.trace import setRecorderPC
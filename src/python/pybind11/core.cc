@@ -56,6 +56,7 @@
 #include "sim/core.hh"
 #include "sim/cur_tick.hh"
 #include "sim/drain.hh"
+#include "sim/host_profile.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_object.hh"
 
@@ -286,6 +287,10 @@ pybind_init_core(py::module_ &m_native)
     m_core.attr("gem5Version") = py::cast(gem5Version);
 
     m_core.attr("TRACING_ON") = py::cast(TRACING_ON);
+    m_core.attr("USE_HOST_PROFILING") = py::cast(USE_HOST_PROFILING);
+#if USE_HOST_PROFILING
+    m_core.def("enableHostProfile", &host_profile::enable);
+#endif
 
     m_core.attr("MaxTick") = py::cast(MaxTick);
 
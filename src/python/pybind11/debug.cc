@@ -125,6 +125,12 @@ pybind_init_debug(py::module_ &m_native)
         .def("ignore", &ignore)
         .def("enable", &Trace::enable)
         .def("disable", &Trace::disable)
+        .def("enableRecorder", &Trace::FlightRecorder::enable)
+        .def("disableRecorder", &Trace::FlightRecorder::disable)
+        .def("dumpRecorder", [](const std::string &reason) {
+                Trace::FlightRecorder::dump(reason);
+            })
+        .def("setRecorderPC", &Trace::FlightRecorder::setTriggerPC)
         ;
 }
 
@@ -42,6 +42,7 @@
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/binary.hh"
 #include "base/stats/text.hh"
 #include "config/have_hdf5.hh"
 
@@ -112,6 +113,7 @@ pybind_init_stats(py::module_ &m_native)
         .def("initSimStats", &statistics::initSimStats)
         .def("initText", &statistics::initText,
             py::return_value_policy::reference)
+        .def("initBinary", &statistics::initBinary)
 #if HAVE_HDF5
         .def("initHDF5", &statistics::initHDF5)
 #endif
@@ -149,6 +151,8 @@ pybind_init_stats(py::module_ &m_native)
         .def("check", &statistics::Info::check)
         .def("baseCheck", &statistics::Info::baseCheck)
         .def("enable", &statistics::Info::enable)
+        .def("disable", &statistics::Info::disable)
+        .def_property_readonly("disabled", &statistics::Info::disabled)
         .def("prepare", &statistics::Info::prepare)
         .def("reset", &statistics::Info::reset)
         .def("zero", &statistics::Info::zero)
@@ -215,6 +219,7 @@ pybind_init_stats(py::module_ &m_native)
             [](const statistics::DistInfo &info) { return info.data.logs; })
         .def_property_readonly("squares",
             [](const statistics::DistInfo &info) { return info.data.squares; })
+        .def("samplePeriod", &statistics::DistInfo::samplePeriod)
         ;
 
     py::class_<statistics::Group,
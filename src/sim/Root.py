@@ -30,6 +30,10 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.util import fatal
 
+# How the main event queues keep their events, see sim/event_wheel.hh.
+# Both give the same event order.
+class EventQueueBackend(Enum): vals = ['bin_list', 'timing_wheel']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -66,6 +70,12 @@ class Root(SimObject):
     # Simulation Quantum for multiple main event queue simulation.
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
+    # Run the event queues one after the other within each quantum. Much
+    # slower than a parallel run, but reproducible for debugging.
+    deterministic_eventq = Param.Bool(False,
+            "serialize the main event queues within each quantum")
+    eventq_backend = Param.EventQueueBackend('bin_list',
+            "data structure of the main event queues")
 
     full_system = Param.Bool("if this is a full system simulation")
 
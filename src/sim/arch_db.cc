@@ -1,6 +1,7 @@
 
 #include "sim/arch_db.hh"
 
+#include "base/output.hh"
 #include "params/ArchDBer.hh"
 
 namespace gem5{
@@ -17,8 +18,11 @@ ArchDBer::ArchDBer(const Params &p)
     dumpBopTrainTrace(p.dump_bop_train_trace),
     dumpSMSTrainTrace(p.dump_sms_train_trace),
     dumpL1WayPreTrace(p.dump_l1d_way_pre_trace),
-    mem_db(nullptr), zErrMsg(nullptr),rc(0),
-    db_path(p.arch_db_file)
+    mem_db(nullptr),
+    merger([this](std::vector<TraceMerger::Record> &batch) { writeBatch(batch); }),
+    zErrMsg(nullptr),rc(0),
+    db_path(p.arch_db_file),
+    stats(this)
 {
   int rc = sqlite3_open(":memory:", &mem_db);
   if (rc) {
@@ -32,6 +36,7 @@ ArchDBer::ArchDBer(const Params &p)
   for (const auto &s : p.table_cmds) {
     create_table(s);
   }
+  merger.start();
   registerExitCallback([this](){ save_db(); });
 }
 
@@ -46,11 +51,79 @@ void ArchDBer::create_table(const std::string &sql) {
   inform("Table created: %s\n", sql.c_str());
 }
 
+void
+ArchDBer::startup()
+{
+  // Records of different event queues are at most a quantum apart
+  merger.setLookahead(simQuantum);
+}
+
+DrainState
+ArchDBer::drain()
+{
+  // write what is queued, a fork only keeps the calling thread
+  merger.stop();
+  return DrainState::Drained;
+}
+
+void
+ArchDBer::drainResume()
+{
+  // also called after a checkpoint restore, without a drain before
+  if (!merger.isRunning())
+    merger.start();
+}
+
+void
+ArchDBer::notifyFork()
+{
+  const auto slash = db_path.find_last_of('/');
+  db_path = simout.resolve(slash == std::string::npos ?
+                           db_path : db_path.substr(slash + 1));
+}
+
+void
+ArchDBer::queueSQL(const char *sql)
+{
+  EventQueue *eq = curEventQueue();
+  merger.push(curTick(), eq ? mainEventQueueIndex(eq) : 0, sql);
+  stats.recordsQueued++;
+}
+
+void
+ArchDBer::writeBatch(std::vector<TraceMerger::Record> &batch)
+{
+  char *err_msg = nullptr;
+  if (sqlite3_exec(mem_db, "BEGIN TRANSACTION;", callback, 0, &err_msg) != SQLITE_OK) {
+    fatal("SQL error: %s\n", err_msg);
+  }
+  for (const auto &rec : batch) {
+    if (sqlite3_exec(mem_db, rec.text.c_str(), callback, 0, &err_msg) != SQLITE_OK) {
+      fatal("SQL error: %s\n", err_msg);
+    }
+  }
+  if (sqlite3_exec(mem_db, "COMMIT;", callback, 0, &err_msg) != SQLITE_OK) {
+    fatal("SQL error: %s\n", err_msg);
+  }
+}
+
+ArchDBer::ArchDBStats::ArchDBStats(ArchDBer *arch_db)
+    : statistics::Group(arch_db),
+      ADD_STAT(recordsQueued, statistics::units::Count::get(),
+               "Number of trace records queued by all threads"),
+      ADD_STAT(writerStalls, statistics::units::Count::get(),
+               "Number of times a thread waited for the trace writer")
+{
+  writerStalls.functor([arch_db]() { return arch_db->merger.stalls(); });
+}
+
 void ArchDBer::start_recording() {
   dumpGlobal = true;
 }
 
 void ArchDBer::save_db() {
+  // write the records still queued by the simulation threads
+  merger.stop();
   warn("saving memdb to %s ...\n", db_path.c_str());
   sqlite3 *disk_db;
   sqlite3_backup *pBackup;
@@ -69,7 +142,7 @@ void ArchDBer::save_db() {
 DBTraceManager *
 ArchDBer::addAndGetTrace(const char *name, std::vector<std::pair<std::string, DataType>> fields)
 {
-  _traces[name] = DBTraceManager(name, fields, mem_db);
+  _traces[name] = DBTraceManager(name, fields, mem_db, this);
   return &_traces[name];
 }
 
@@ -80,15 +153,13 @@ ArchDBer::memTraceWrite(Tick tick, bool is_load, Addr pc, Addr vaddr, Addr paddr
   bool dump_me = dumpGlobal && dumpMemTrace;
   if (!dump_me) return;
 
+  char sql[1024];
   sprintf(
-      memTraceSQLBuf,
+      sql,
       "INSERT INTO MemTrace(Tick,IsLoad,PC,VADDR,PADDR,Issued,Translated,Completed,Committed,Writenback,PFSrc,SITE) "
       "VALUES(%ld,%d,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%ld,%d,'%s');",
       tick, is_load, pc, vaddr, paddr, issued, translated, completed, committed, writenback, pf_src, "CommitMemTrace");
-  rc = sqlite3_exec(mem_db, memTraceSQLBuf, callback, 0, &zErrMsg);
-  if (rc != SQLITE_OK) {
-    fatal("SQL error: %s\n", zErrMsg);
-  };
+  queueSQL(sql);
 }
 
 void
@@ -97,14 +168,12 @@ ArchDBer::l1PFTraceWrite(Tick tick, Addr trigger_pc, Addr trigger_vaddr, Addr pf
   bool dump_me = dumpGlobal && dumpL1PfTrace;
   if (!dump_me) return;
 
-  sprintf(memTraceSQLBuf,
+  char sql[1024];
+  sprintf(sql,
           "INSERT INTO L1PFTrace(Tick,TriggerPC,TriggerVAddr,PFVAddr,PFSrc,SITE) "
           "VALUES(%ld,%ld,%ld,%ld,%d,'%s');",
           tick, trigger_pc, trigger_vaddr, pf_vaddr, pf_src, "L1PFTrace");
-  rc = sqlite3_exec(mem_db, memTraceSQLBuf, callback, 0, &zErrMsg);
-  if (rc != SQLITE_OK) {
-    fatal("SQL error: %s\n", zErrMsg);
-  };
+  queueSQL(sql);
 }
 
 void
@@ -113,14 +182,12 @@ ArchDBer::bopTrainTraceWrite(Tick tick, Addr old_addr, Addr cur_addr, Addr offse
   bool dump_me = dumpGlobal && dumpBopTrainTrace;
   if (!dump_me) return;
 
-  sprintf(memTraceSQLBuf,
+  char sql[1024];
+  sprintf(sql,
           "INSERT INTO BOPTrainTrace(Tick,OldAddr,CurAddr,Offset,Score,Miss,SITE) "
           "VALUES(%ld,%ld,%ld,%ld,%d,%d,'%s');",
           tick, old_addr, cur_addr, offset, score, miss, "BOPTrain");
-  rc = sqlite3_exec(mem_db, memTraceSQLBuf, callback, 0, &zErrMsg);
-  if (rc != SQLITE_OK) {
-    fatal("SQL error: %s\n", zErrMsg);
-  };
+  queueSQL(sql);
 }
 
 void
@@ -129,14 +196,12 @@ ArchDBer::smsTrainTraceWrite(Tick tick, Addr old_addr, Addr cur_addr, Addr trigg
   bool dump_me = dumpGlobal && dumpSMSTrainTrace;
   if (!dump_me) return;
 
-  sprintf(memTraceSQLBuf,
+  char sql[1024];
+  sprintf(sql,
           "INSERT INTO SMSTrainTrace(Tick,OldAddr,CurAddr,TriggerOffset,Conf,Miss,SITE) "
           "VALUES(%ld,%ld,%ld,%ld,%d,%d,'%s');",
           tick, old_addr, cur_addr, trigger_offset, conf, miss, "SMSTrain");
-  rc = sqlite3_exec(mem_db, memTraceSQLBuf, callback, 0, &zErrMsg);
-  if (rc != SQLITE_OK) {
-    fatal("SQL error: %s\n", zErrMsg);
-  };
+  queueSQL(sql);
 }
 
 void ArchDBer::L1MissTrace_write(
@@ -155,10 +220,7 @@ void ArchDBer::L1MissTrace_write(
     "VALUES(%ld, %ld, %ld, %ld, %ld, '%s');",
     pc,source,paddr,vaddr, stamp, site
   );
-  rc = sqlite3_exec(mem_db, sql, callback, 0, &zErrMsg);
-  if (rc != SQLITE_OK) {
-    fatal("SQL error: %s\n", zErrMsg);
-  };
+  queueSQL(sql);
 }
 
 void
@@ -172,10 +234,7 @@ ArchDBer::dcacheWayPreTrace(Tick tick, uint64_t pc, uint64_t vaddr, int way, int
             "INSERT INTO dcacheWayPreTrace(PC,VADDR, WAY, Tick, IsWrite,SITE)"
             "VALUES(%ld,%ld,%ld,%ld,%ld,'%s');",
             pc, vaddr, (uint64_t)way, tick, (uint64_t)is_write, "dacheWayPre");
-    rc = sqlite3_exec(mem_db, sql, callback, 0, &zErrMsg);
-    if (rc != SQLITE_OK) {
-        fatal("SQL error: %s\n", zErrMsg);
-    };
+    queueSQL(sql);
 }
 
 void
@@ -190,10 +249,7 @@ ArchDBer::evictTraceWrite(int cache_level, Tick tick, uint64_t paddr, uint64_t s
     "VALUES(%ld, %ld, %ld, %ld, '%s');",
     tick, paddr, stamp, (int64_t) cache_level, site
   );
-  rc = sqlite3_exec(mem_db, sql, callback, 0, &zErrMsg);
-  if (rc != SQLITE_OK) {
-    fatal("SQL error: %s\n", zErrMsg);
-  };
+  queueSQL(sql);
 }
 
 void
@@ -269,11 +325,7 @@ DBTraceManager::write_record(const Record &record)
   }
   pos += sprintf(sql+pos, ");");
   assert(pos < 1024);
-  char *zErrMsg;
-  int rc = sqlite3_exec(_db, sql, callback, 0, &zErrMsg);
-  if (rc != SQLITE_OK) {
-    fatal("SQL error: %s\n", zErrMsg);
-  };
+  _archDBer->queueSQL(sql);
 }
 
 } // namespace gem5
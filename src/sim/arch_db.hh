@@ -11,15 +11,18 @@
 #include <cstring>
 
 #include "base/logging.hh"
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/pred/general_arch_db.hh"
 #include "params/ArchDBer.hh"
 #include "sim/sim_exit.hh"
 #include "sim/sim_object.hh"
 #include "sim/system.hh"
+#include "sim/trace_merger.hh"
 
 namespace gem5{
 
+class ArchDBer;
 class BaseCache;
 
 class DBTraceManager
@@ -27,15 +30,18 @@ class DBTraceManager
   std::string _name;
   std::map<std::string, DataType> _fields;
   sqlite3 *_db;
+  ArchDBer *_archDBer;
 public:
-  DBTraceManager(const char *name, std::vector<std::pair<std::string, DataType>> fields, sqlite3 *db) {
+  DBTraceManager(const char *name, std::vector<std::pair<std::string, DataType>> fields, sqlite3 *db,
+                 ArchDBer *arch_db) {
     _name = name;
     for (auto it = fields.begin(); it != fields.end(); it++) {
       _fields[it->first] = it->second;
     }
     _db = db;
+    _archDBer = arch_db;
   }
-  DBTraceManager() {}
+  DBTraceManager() : _db(nullptr), _archDBer(nullptr) {}
   void init_table();
   void write_record(const Record &record);
 };
@@ -46,6 +52,18 @@ class ArchDBer : public SimObject
     PARAMS(ArchDBer);
     ArchDBer(const Params &p);
 
+    void startup() override;
+
+    /**
+     * The writer thread is stopped while the simulator is drained, so
+     * that it does not get lost in a fork.
+     */
+    DrainState drain() override;
+    void drainResume() override;
+
+    /** A forked child writes its own database, in its output directory. */
+    void notifyFork() override;
+
     //let db start recording
     void start_recording();
 
@@ -64,6 +82,11 @@ class ArchDBer : public SimObject
     bool dumpL1WayPreTrace;
 
     sqlite3 *mem_db;
+    /**
+     * Hands the statements of all simulation threads to one writer
+     * thread, which inserts them in (tick, event queue) order.
+     */
+    TraceMerger merger;
     char * zErrMsg;
     int rc;
     //path to save
@@ -73,8 +96,26 @@ class ArchDBer : public SimObject
 
     void create_table(const std::string &sql);
 
+    /** Write a batch of merged statements in one transaction. */
+    void writeBatch(std::vector<TraceMerger::Record> &batch);
+
+    struct ArchDBStats : public statistics::Group
+    {
+        ArchDBStats(ArchDBer *arch_db);
+
+        /** Updated by every simulation thread. */
+        statistics::ThreadScalar recordsQueued;
+        statistics::Value writerStalls;
+    } stats;
+
     void save_db();
   public:
+    /**
+     * Queue an insert statement. Safe to call from any simulation
+     * thread, the statement is executed later by the writer thread.
+     */
+    void queueSQL(const char *sql);
+
     DBTraceManager *addAndGetTrace(const char *name, std::vector<std::pair<std::string, DataType>> fields);
 
     bool get_dump_rolling() { return dumpRolling; }
@@ -98,7 +139,6 @@ class ArchDBer : public SimObject
     void bopTrainTraceWrite(Tick tick, Addr old_addr, Addr cur_addr, Addr offset, int score, bool miss);
     void smsTrainTraceWrite(Tick tick, Addr old_addr, Addr cur_addr, Addr trigger_offset, int conf, bool miss);
     void dcacheWayPreTrace(Tick tick, uint64_t pc, uint64_t vaddr, int way, int is_write);
-    char memTraceSQLBuf[1024];
 };
 
 
@@ -0,0 +1,80 @@
+#include "sim/event_pool.hh"
+
+#include <atomic>
+#include <mutex>
+
+namespace gem5
+{
+
+namespace
+{
+
+/**
+ * Counters of one thread. They are only written by their thread, so
+ * counting takes no atomic read-modify-write even with parallel event
+ * queues.
+ */
+struct Counts
+{
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> heapAllocations{0};
+};
+
+std::mutex countsMutex;
+/** Counters of all threads, kept after the threads exit. */
+std::vector<std::shared_ptr<Counts>> allCounts;
+
+Counts &
+threadCounts()
+{
+    thread_local std::shared_ptr<Counts> counts = []() {
+        auto c = std::make_shared<Counts>();
+        std::lock_guard<std::mutex> lock(countsMutex);
+        allCounts.push_back(c);
+        return c;
+    }();
+    return *counts;
+}
+
+void
+increment(std::atomic<uint64_t> &counter)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+}
+
+} // anonymous namespace
+
+void
+EventPoolStats::countAllocation()
+{
+    increment(threadCounts().allocations);
+}
+
+void
+EventPoolStats::countHeapAllocation()
+{
+    increment(threadCounts().heapAllocations);
+}
+
+uint64_t
+EventPoolStats::allocations()
+{
+    std::lock_guard<std::mutex> lock(countsMutex);
+    uint64_t total = 0;
+    for (const auto &counts : allCounts)
+        total += counts->allocations.load(std::memory_order_relaxed);
+    return total;
+}
+
+uint64_t
+EventPoolStats::heapAllocations()
+{
+    std::lock_guard<std::mutex> lock(countsMutex);
+    uint64_t total = 0;
+    for (const auto &counts : allCounts)
+        total += counts->heapAllocations.load(std::memory_order_relaxed);
+    return total;
+}
+
+} // namespace gem5
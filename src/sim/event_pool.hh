@@ -0,0 +1,132 @@
+#ifndef __SIM_EVENT_POOL_HH__
+#define __SIM_EVENT_POOL_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+template <class T>
+class EventPool;
+
+/**
+ * Counts the events handed out by all event pools, for the global
+ * simEventAllocs stats. Every pooled event used to be a heap allocation
+ * of its own, while a pool only goes to the heap once per chunk.
+ */
+struct EventPoolStats
+{
+    static void countAllocation();
+    static void countHeapAllocation();
+
+    /** Events handed out by the pools since the start. */
+    static uint64_t allocations();
+    /** Heap allocations of the pools since the start. */
+    static uint64_t heapAllocations();
+};
+
+/**
+ * Base of events that live in an EventPool. Like other AutoDelete events
+ * a pooled event goes away once it has been processed or descheduled,
+ * but it returns to the free list of its pool instead of the heap.
+ *
+ * @tparam Derived The event class itself.
+ */
+template <class Derived>
+class PooledEvent : public Event
+{
+  public:
+    PooledEvent(Priority p = Default_Pri) : Event(p, AutoDelete) {}
+
+  protected:
+    void
+    releaseImpl() override
+    {
+        if (!scheduled())
+            pool->free(static_cast<Derived *>(this));
+    }
+
+  private:
+    friend class EventPool<Derived>;
+
+    EventPool<Derived> *pool = nullptr;
+};
+
+/**
+ * Free list of events of one type, owned by the object that schedules
+ * them. Events are constructed in place in slots that are allocated in
+ * chunks and recycled when the events are released, so the hot paths
+ * that create an event per packet or per access do not allocate.
+ *
+ * A pool is used from the thread of its owner only.
+ */
+template <class T>
+class EventPool
+{
+  public:
+    /** @param chunk_size Events allocated at once when the pool is empty. */
+    EventPool(size_t chunk_size = 32) : chunkSize(chunk_size) {}
+
+    EventPool(const EventPool &) = delete;
+    EventPool &operator=(const EventPool &) = delete;
+
+    /** Construct an event in a free slot. */
+    template <typename... Args>
+    T *
+    allocate(Args&&... args)
+    {
+        if (!freeList)
+            grow();
+        Slot *slot = freeList;
+        freeList = slot->next;
+        EventPoolStats::countAllocation();
+
+        T *event = new (slot->storage) T(std::forward<Args>(args)...);
+        event->pool = this;
+        return event;
+    }
+
+    /** Destroy an event and put its slot back on the free list. */
+    void
+    free(T *event)
+    {
+        event->~T();
+        Slot *slot = reinterpret_cast<Slot *>(event);
+        slot->next = freeList;
+        freeList = slot;
+    }
+
+  private:
+    union Slot
+    {
+        Slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void
+    grow()
+    {
+        chunks.emplace_back(new Slot[chunkSize]);
+        EventPoolStats::countHeapAllocation();
+        Slot *chunk = chunks.back().get();
+        for (size_t i = 0; i < chunkSize; i++) {
+            chunk[i].next = freeList;
+            freeList = &chunk[i];
+        }
+    }
+
+    const size_t chunkSize;
+    Slot *freeList = nullptr;
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+};
+
+} // namespace gem5
+
+#endif // __SIM_EVENT_POOL_HH__
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+#include "sim/event_pool.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+class CountingEvent : public PooledEvent<CountingEvent>
+{
+  public:
+    CountingEvent(std::vector<int> &_log, int _id, int &_live)
+        : log(_log), id(_id), live(_live)
+    {
+        live++;
+    }
+
+    ~CountingEvent() { live--; }
+
+    void process() override { log.push_back(id); }
+
+  private:
+    std::vector<int> &log;
+    const int id;
+    int &live;
+};
+
+} // anonymous namespace
+
+/** Processed and descheduled events are destroyed and their slots reused. */
+TEST(EventPoolTest, Recycle)
+{
+    std::vector<int> log;
+    int live = 0;
+    EventQueue eq("test");
+    EventPool<CountingEvent> pool(4);
+
+    const uint64_t heap_before = EventPoolStats::heapAllocations();
+    const uint64_t allocs_before = EventPoolStats::allocations();
+
+    std::set<CountingEvent *> slots;
+    for (int round = 0; round < 10; round++) {
+        CountingEvent *kept = pool.allocate(log, 2 * round, live);
+        CountingEvent *dropped = pool.allocate(log, 2 * round + 1, live);
+        slots.insert(kept);
+        slots.insert(dropped);
+        eq.schedule(kept, eq.getCurTick() + 10);
+        eq.schedule(dropped, eq.getCurTick() + 20);
+        EXPECT_EQ(live, 2);
+
+        eq.deschedule(dropped);
+        while (!eq.empty())
+            eq.serviceOne();
+        EXPECT_EQ(live, 0);
+    }
+
+    std::vector<int> expected;
+    for (int round = 0; round < 10; round++)
+        expected.push_back(2 * round);
+    EXPECT_EQ(log, expected);
+
+    // Two events in flight at a time fit in the first chunk
+    EXPECT_EQ(slots.size(), 2);
+    EXPECT_EQ(EventPoolStats::heapAllocations() - heap_before, 1);
+    EXPECT_EQ(EventPoolStats::allocations() - allocs_before, 20);
+}
+
+/** The pool grows by chunks when more events are in flight. */
+TEST(EventPoolTest, Grow)
+{
+    std::vector<int> log;
+    int live = 0;
+    EventQueue eq("test");
+    EventPool<CountingEvent> pool(4);
+
+    const uint64_t heap_before = EventPoolStats::heapAllocations();
+    for (int i = 0; i < 10; i++)
+        eq.schedule(pool.allocate(log, i, live), 100 - i);
+    EXPECT_EQ(live, 10);
+    EXPECT_EQ(EventPoolStats::heapAllocations() - heap_before, 3);
+
+    while (!eq.empty())
+        eq.serviceOne();
+    EXPECT_EQ(live, 0);
+    EXPECT_EQ(log, std::vector<int>({9, 8, 7, 6, 5, 4, 3, 2, 1, 0}));
+}
@@ -0,0 +1,200 @@
+#include "sim/event_wheel.hh"
+
+#include <algorithm>
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+EventWheel::EventWheel(unsigned slot_bits, unsigned num_slot_bits)
+    : slotBits(slot_bits), numSlots(size_t(1) << num_slot_bits),
+      span(Tick(numSlots) << slotBits), slots(numSlots, nullptr),
+      occupied(numSlots / 64, 0)
+{
+    panic_if(num_slot_bits < 6, "An event wheel needs at least 64 slots\n");
+}
+
+void
+EventWheel::insert(Event *event)
+{
+    const Tick when = event->when();
+    if (when < base)
+        rebase(when);
+
+    if (inWheel(when)) {
+        const size_t slot = slotOf(when);
+        Event::insertInList(slots[slot], event);
+        markSlot(slot);
+    } else {
+        Event *&top = far[Key(when, event->priority())];
+        top = Event::insertBefore(event, top);
+    }
+
+    // An event of the head bin becomes the new top of the bin
+    if (!_head || *event <= *_head)
+        _head = event;
+}
+
+void
+EventWheel::remove(Event *event)
+{
+    const Tick when = event->when();
+    if (inWheel(when)) {
+        const size_t slot = slotOf(when);
+        Event::removeFromList(slots[slot], event);
+        if (!slots[slot])
+            clearSlot(slot);
+    } else {
+        auto it = far.find(Key(when, event->priority()));
+        if (it == far.end())
+            panic("event not found!");
+        Event *top = Event::removeItem(event, it->second);
+        if (top)
+            it->second = top;
+        else
+            far.erase(it);
+    }
+
+    if (*event == *_head)
+        _head = findHead();
+}
+
+Event *
+EventWheel::pop()
+{
+    Event *event = _head;
+    remove(event);
+
+    // Nothing can be scheduled before the tick of the event anymore, so
+    // the wheel can start at its slot.
+    const Tick new_base = event->when() & ~mask(slotBits);
+    if (new_base > base) {
+        base = new_base;
+        fill();
+    }
+    return event;
+}
+
+Event *
+EventWheel::extract()
+{
+    std::vector<Event *> tops = bins();
+    Event *list = nullptr;
+    for (auto it = tops.rbegin(); it != tops.rend(); ++it) {
+        (*it)->nextBin = list;
+        list = *it;
+    }
+
+    std::fill(slots.begin(), slots.end(), nullptr);
+    std::fill(occupied.begin(), occupied.end(), 0);
+    far.clear();
+    _head = nullptr;
+    return list;
+}
+
+void
+EventWheel::import(Event *list)
+{
+    while (list) {
+        Event *next = list->nextBin;
+        insertBin(list);
+        list = next;
+    }
+}
+
+std::vector<Event *>
+EventWheel::bins() const
+{
+    std::vector<Event *> tops;
+    const size_t first = slotOf(base);
+    for (size_t i = 0; i < numSlots; i++) {
+        Event *bin = slots[(first + i) & (numSlots - 1)];
+        for (; bin; bin = bin->nextBin)
+            tops.push_back(bin);
+    }
+    for (const auto &bin : far)
+        tops.push_back(bin.second);
+    return tops;
+}
+
+void
+EventWheel::insertBin(Event *top)
+{
+    const Tick when = top->when();
+    if (when < base)
+        rebase(when);
+
+    if (inWheel(when)) {
+        const size_t slot = slotOf(when);
+        Event *prev = nullptr;
+        Event *curr = slots[slot];
+        while (curr && *curr < *top) {
+            prev = curr;
+            curr = curr->nextBin;
+        }
+        top->nextBin = curr;
+        if (prev)
+            prev->nextBin = top;
+        else
+            slots[slot] = top;
+        markSlot(slot);
+    } else {
+        top->nextBin = nullptr;
+        far[Key(when, top->priority())] = top;
+    }
+
+    if (!_head || *top < *_head)
+        _head = top;
+}
+
+void
+EventWheel::fill()
+{
+    while (!far.empty() && inWheel(far.begin()->first.first)) {
+        Event *top = far.begin()->second;
+        far.erase(far.begin());
+        insertBin(top);
+    }
+}
+
+void
+EventWheel::rebase(Tick when)
+{
+    // Only happens when time goes backwards (e.g. replaceHead()), the
+    // whole wheel is moved to the map and refilled from the new base.
+    for (size_t slot = 0; slot < numSlots; slot++) {
+        Event *bin = slots[slot];
+        while (bin) {
+            Event *next = bin->nextBin;
+            bin->nextBin = nullptr;
+            far[Key(bin->when(), bin->priority())] = bin;
+            bin = next;
+        }
+        slots[slot] = nullptr;
+    }
+    std::fill(occupied.begin(), occupied.end(), 0);
+
+    base = when & ~mask(slotBits);
+    fill();
+}
+
+Event *
+EventWheel::findHead() const
+{
+    // The wheel starts at the slot of base and wraps around, the last
+    // word is visited twice to cover the slots before base in it.
+    const size_t first = slotOf(base);
+    size_t word = first / 64;
+    uint64_t bits = occupied[word] & (~0ULL << first % 64);
+    for (size_t i = 0; i <= occupied.size(); i++) {
+        if (bits)
+            return slots[word * 64 + ctz64(bits)];
+        word = (word + 1) % occupied.size();
+        bits = occupied[word];
+    }
+    return far.empty() ? nullptr : far.begin()->second;
+}
+
+} // namespace gem5
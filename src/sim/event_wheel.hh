@@ -0,0 +1,101 @@
+#ifndef __SIM_EVENT_WHEEL_HH__
+#define __SIM_EVENT_WHEEL_HH__
+
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+#include "sim/eventq.hh"
+
+namespace gem5
+{
+
+/**
+ * Timing wheel holding the events of an EventQueue.
+ *
+ * The events are kept in the same bins as in the plain event queue: a
+ * bin is a stack of the events with the same when and priority, ordered
+ * LIFO through nextInBin. Instead of one list of all bins, the bins of
+ * the near future are spread over the slots of a wheel, each slot
+ * holding the (short) sorted list of the bins of a small range of ticks.
+ * Bins beyond the wheel are kept in an ordered map and moved to the
+ * wheel as it turns. Inserting an event thus costs a walk over the bins
+ * of one slot rather than over all pending bins, and the order in which
+ * the events are serviced is exactly that of the bin list.
+ */
+class EventWheel
+{
+  public:
+    /**
+     * @param slot_bits Log2 of the ticks covered by a slot.
+     * @param num_slot_bits Log2 of the number of slots.
+     */
+    EventWheel(unsigned slot_bits = 6, unsigned num_slot_bits = 12);
+
+    void insert(Event *event);
+    void remove(Event *event);
+
+    /** Remove the head and turn the wheel to its tick. */
+    Event *pop();
+
+    /** Top of the first bin, nullptr if the wheel is empty. */
+    Event *head() const { return _head; }
+
+    /** Remove all events, returned as a bin list linked by nextBin. */
+    Event *extract();
+
+    /** Insert the bins of a bin list into an empty wheel. */
+    void import(Event *list);
+
+    /** Tops of all bins in order. */
+    std::vector<Event *> bins() const;
+
+  private:
+    using Key = std::pair<Tick, Event::Priority>;
+
+    size_t slotOf(Tick when) const
+    {
+        return (when >> slotBits) & (numSlots - 1);
+    }
+
+    bool inWheel(Tick when) const { return when - base < span; }
+
+    void markSlot(size_t slot) { occupied[slot / 64] |= 1ULL << slot % 64; }
+    void clearSlot(size_t slot) { occupied[slot / 64] &= ~(1ULL << slot % 64); }
+
+    /** Insert a bin known not to be pending yet. */
+    void insertBin(Event *top);
+
+    /** Move the bins of the map that now fall into the wheel. */
+    void fill();
+
+    /** Restart the wheel at an earlier tick. */
+    void rebase(Tick when);
+
+    /** First bin after a change to the first slot in use. */
+    Event *findHead() const;
+
+    const unsigned slotBits;
+    const size_t numSlots;
+    /** Ticks covered by the wheel. */
+    const Tick span;
+
+    /** First tick of the wheel, a multiple of the slot size. */
+    Tick base = 0;
+
+    /** Sorted bin lists of the ticks [base, base + span). */
+    std::vector<Event *> slots;
+    /** Bitmap of the non-empty slots. */
+    std::vector<uint64_t> occupied;
+
+    /** Bins from base + span on, with nextBin unused. */
+    std::map<Key, Event *> far;
+
+    Event *_head = nullptr;
+};
+
+} // namespace gem5
+
+#endif // __SIM_EVENT_WHEEL_HH__
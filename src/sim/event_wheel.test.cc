@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+class TestEvent : public Event
+{
+  public:
+    TestEvent(int _id, Priority p, std::vector<int> &_log)
+        : Event(p), id(_id), log(_log)
+    {}
+
+    void process() override { log.push_back(id); }
+
+  private:
+    const int id;
+    std::vector<int> &log;
+};
+
+/**
+ * Random mix of schedule, deschedule, reschedule and service on a queue,
+ * the same for a given seed whatever the queue keeps its events in.
+ * Delays mimic gem5: many events a few clock edges ahead, some far
+ * away, and lots of events sharing a tick.
+ *
+ * @param switch_every Toggle the backend every this many operations.
+ * @return The ids of the events in service order.
+ */
+std::vector<int>
+runQueue(bool wheel, unsigned seed, int num_ops, int switch_every = 0)
+{
+    std::vector<int> log;
+    EventQueue eq("test");
+    eq.setWheel(wheel);
+
+    std::mt19937 rng(seed);
+    const Event::Priority prios[] = {
+        Event::Default_Pri, Event::CPU_Tick_Pri, Event::Sim_Exit_Pri,
+        Event::Minimum_Pri, Event::Maximum_Pri };
+    std::vector<std::unique_ptr<TestEvent>> events;
+    for (int i = 0; i < 512; i++)
+        events.emplace_back(new TestEvent(i, prios[rng() % 5], log));
+
+    auto delay = [&rng]() -> Tick {
+        switch (rng() % 4) {
+          case 0: return rng() % 4 * 333;
+          case 1: return rng() % 64;
+          case 2: return rng() % 20000;
+          default: return rng() % 50000000;
+        }
+    };
+
+    for (int op = 0; op < num_ops; op++) {
+        if (switch_every && op % switch_every == 0)
+            eq.setWheel(wheel != (op / switch_every % 2 == 0));
+
+        TestEvent *event = events[rng() % events.size()].get();
+        switch (rng() % 4) {
+          case 0:
+            if (!event->scheduled())
+                eq.schedule(event, eq.getCurTick() + delay());
+            break;
+          case 1:
+            if (event->scheduled())
+                eq.deschedule(event);
+            break;
+          case 2:
+            eq.reschedule(event, eq.getCurTick() + delay(), true);
+            break;
+          default:
+            if (!eq.empty())
+                eq.serviceOne();
+            break;
+        }
+    }
+    EXPECT_TRUE(eq.debugVerify());
+    while (!eq.empty())
+        eq.serviceOne();
+    return log;
+}
+
+} // anonymous namespace
+
+/** The wheel services the events in the same order as the bin list. */
+TEST(EventWheelTest, SameOrder)
+{
+    for (unsigned seed = 0; seed < 8; seed++) {
+        std::vector<int> list = runQueue(false, seed, 50000);
+        std::vector<int> wheel = runQueue(true, seed, 50000);
+        ASSERT_GT(list.size(), 1000);
+        ASSERT_EQ(list, wheel) << "seed " << seed;
+    }
+}
+
+/** Events survive moving between the backends. */
+TEST(EventWheelTest, SwitchBackend)
+{
+    std::vector<int> list = runQueue(false, 42, 50000);
+    std::vector<int> mixed = runQueue(false, 42, 50000, 997);
+    ASSERT_EQ(list, mixed);
+}
+
+/** Events of the same tick and priority are serviced LIFO. */
+TEST(EventWheelTest, SameBin)
+{
+    std::vector<int> log;
+    EventQueue eq("test");
+    eq.setWheel(true);
+    TestEvent a(0, Event::Default_Pri, log);
+    TestEvent b(1, Event::Default_Pri, log);
+    TestEvent c(2, Event::CPU_Tick_Pri, log);
+    TestEvent far(3, Event::Default_Pri, log);
+    TestEvent far2(4, Event::Default_Pri, log);
+    eq.schedule(&a, 100);
+    eq.schedule(&b, 100);
+    eq.schedule(&c, 100);
+    eq.schedule(&far, MaxTick - 1);
+    eq.schedule(&far2, MaxTick - 1);
+    while (!eq.empty())
+        eq.serviceOne();
+    EXPECT_EQ(log, std::vector<int>({1, 0, 2, 4, 3}));
+}
+
+/** Going back in time (as done by replaceHead() users) is handled. */
+TEST(EventWheelTest, TimeGoesBack)
+{
+    std::vector<int> log;
+    EventQueue eq("test");
+    eq.setWheel(true);
+    TestEvent late(0, Event::Default_Pri, log);
+    TestEvent early(1, Event::Default_Pri, log);
+    TestEvent first(2, Event::Default_Pri, log);
+    eq.schedule(&first, 1000000);
+    eq.schedule(&late, 2000000);
+    eq.serviceOne();
+    eq.setCurTick(0);
+    eq.schedule(&early, 10);
+    ASSERT_TRUE(eq.debugVerify());
+    while (!eq.empty())
+        eq.serviceOne();
+    EXPECT_EQ(log, std::vector<int>({2, 1, 0}));
+}
+
+/**
+ * Schedule/service throughput of both backends with a few thousand
+ * distinct pending ticks, run with --gtest_also_run_disabled_tests.
+ */
+TEST(EventWheelTest, DISABLED_StressBenchmark)
+{
+    for (bool wheel : {false, true}) {
+        std::vector<int> log;
+        EventQueue eq("bench");
+        eq.setWheel(wheel);
+        std::vector<std::unique_ptr<TestEvent>> events;
+        for (int i = 0; i < 4096; i++) {
+            events.emplace_back(
+                new TestEvent(i, Event::Default_Pri, log));
+        }
+
+        std::mt19937 rng(1);
+        for (auto &event : events)
+            eq.schedule(event.get(), rng() % 2000000);
+
+        const int num_ops = 200000;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_ops; i++) {
+            Event *event = eq.getHead();
+            eq.serviceOne();
+            eq.schedule(event, eq.getCurTick() + 1 + rng() % 2000000);
+            if (log.size() > 1024)
+                log.clear();
+        }
+        std::chrono::duration<double> secs =
+            std::chrono::steady_clock::now() - start;
+        std::cout << (wheel ? "timing wheel: " : "bin list:     ")
+                  << secs.count() * 1e9 / num_ops << " ns/event\n";
+
+        while (!eq.empty())
+            eq.deschedule(eq.getHead());
+    }
+}
@@ -30,7 +30,9 @@
 
 #include "sim/eventq.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <iostream>
 #include <mutex>
 #include <string>
@@ -41,6 +43,8 @@
 #include "base/trace.hh"
 #include "cpu/smt.hh"
 #include "debug/Checkpoint.hh"
+#include "sim/event_wheel.hh"
+#include "sim/host_profile.hh"
 
 namespace gem5
 {
@@ -57,6 +61,59 @@ uint32_t numMainEventQueues = 0;
 std::vector<EventQueue *> mainEventQueue;
 __thread EventQueue *_curEventQueue = NULL;
 bool inParallelMode = false;
+bool deterministicParallelMode = false;
+bool eventQueueWheel = false;
+
+uint32_t
+mainEventQueueIndex(EventQueue *eq)
+{
+    auto it = std::find(mainEventQueue.begin(), mainEventQueue.end(), eq);
+    panic_if(it == mainEventQueue.end(),
+             "%s is not a main event queue\n", eq->name());
+    return it - mainEventQueue.begin();
+}
+
+namespace
+{
+
+std::mutex turnMutex;
+std::condition_variable turnCond;
+uint32_t turnIndex = 0;
+
+} // anonymous namespace
+
+void
+resetEventQueueTurn()
+{
+    if (!deterministicParallelMode || !inParallelMode)
+        return;
+    std::lock_guard<std::mutex> lock(turnMutex);
+    turnIndex = 0;
+    turnCond.notify_all();
+}
+
+void
+waitEventQueueTurn(EventQueue *eq)
+{
+    if (!deterministicParallelMode || !inParallelMode)
+        return;
+    const uint32_t index = mainEventQueueIndex(eq);
+    std::unique_lock<std::mutex> lock(turnMutex);
+    turnCond.wait(lock, [index]{ return turnIndex == index; });
+}
+
+void
+passEventQueueTurn(EventQueue *eq)
+{
+    if (!deterministicParallelMode || !inParallelMode)
+        return;
+    const uint32_t index = mainEventQueueIndex(eq);
+    std::lock_guard<std::mutex> lock(turnMutex);
+    if (turnIndex == index) {
+        turnIndex++;
+        turnCond.notify_all();
+    }
+}
 
 EventQueue *
 getEventQueue(uint32_t index)
@@ -65,6 +122,7 @@ getEventQueue(uint32_t index)
         numMainEventQueues++;
         mainEventQueue.push_back(
             new EventQueue(csprintf("MainEventQueue-%d", index)));
+        mainEventQueue.back()->setWheel(eventQueueWheel);
     }
 
     return mainEventQueue[index];
@@ -109,7 +167,7 @@ Event::insertBefore(Event *event, Event *curr)
 }
 
 void
-EventQueue::insert(Event *event)
+Event::insertInList(Event *&head, Event *event)
 {
     // Deal with the head case
     if (!head || *event <= *head) {
@@ -131,6 +189,17 @@ EventQueue::insert(Event *event)
     prev->nextBin = Event::insertBefore(event, curr);
 }
 
+void
+EventQueue::insert(Event *event)
+{
+    if (wheel) {
+        wheel->insert(event);
+        head = wheel->head();
+    } else {
+        Event::insertInList(head, event);
+    }
+}
+
 Event *
 Event::removeItem(Event *event, Event *top)
 {
@@ -163,13 +232,11 @@ Event::removeItem(Event *event, Event *top)
 }
 
 void
-EventQueue::remove(Event *event)
+Event::removeFromList(Event *&head, Event *event)
 {
     if (head == NULL)
         panic("event not found!");
 
-    assert(event->queue == this);
-
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -194,6 +261,19 @@ EventQueue::remove(Event *event)
     prev->nextBin = Event::removeItem(event, curr);
 }
 
+void
+EventQueue::remove(Event *event)
+{
+    assert(event->queue == this);
+
+    if (wheel) {
+        wheel->remove(event);
+        head = wheel->head();
+    } else {
+        Event::removeFromList(head, event);
+    }
+}
+
 Event *
 EventQueue::serviceOne()
 {
@@ -202,7 +282,10 @@ EventQueue::serviceOne()
     Event *next = head->nextInBin;
     event->flags.clear(Event::Scheduled);
 
-    if (next) {
+    if (wheel) {
+        wheel->pop();
+        head = wheel->head();
+    } else if (next) {
         // update the next bin pointer since it could be stale
         next->nextBin = head->nextBin;
 
@@ -220,7 +303,14 @@ EventQueue::serviceOne()
         setCurTick(event->when());
         if (debug::Event)
             event->trace("executed");
+#if USE_HOST_PROFILING
+        {
+            host_profile::Scope profile(event);
+            event->process();
+        }
+#else
         event->process();
+#endif
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -295,15 +385,12 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
+        for (Event *nextBin : bins()) {
             Event *nextInBin = nextBin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -318,8 +405,7 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
+    for (Event *nextBin : bins()) {
         Event *nextInBin = nextBin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
@@ -345,21 +431,54 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
 }
 
+std::vector<Event *>
+EventQueue::bins() const
+{
+    if (wheel)
+        return wheel->bins();
+
+    std::vector<Event *> tops;
+    for (Event *bin = head; bin; bin = bin->nextBin)
+        tops.push_back(bin);
+    return tops;
+}
+
 Event*
 EventQueue::replaceHead(Event* s)
 {
+    if (wheel) {
+        Event *t = wheel->extract();
+        wheel->import(s);
+        head = wheel->head();
+        return t;
+    }
+
     Event* t = head;
     head = s;
     return t;
 }
 
+void
+EventQueue::setWheel(bool enable)
+{
+    if (enable == (wheel != nullptr))
+        return;
+
+    Event *events = replaceHead(nullptr);
+    if (enable) {
+        wheel = new EventWheel();
+    } else {
+        delete wheel;
+        wheel = nullptr;
+    }
+    replaceHead(events);
+}
+
 void
 dumpMainQueue()
 {
@@ -416,8 +535,15 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const std::string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), wheel(nullptr)
+{
+}
+
+EventQueue::~EventQueue()
 {
+    while (!empty())
+        deschedule(getHead());
+    delete wheel;
 }
 
 void
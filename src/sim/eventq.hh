@@ -48,6 +48,7 @@
 #include "base/flags.hh"
 #include "base/types.hh"
 #include "base/uncontended_mutex.hh"
+#include "config/use_host_profiling.hh"
 #include "debug/Event.hh"
 #include "sim/cur_tick.hh"
 #include "sim/serialize.hh"
@@ -56,8 +57,15 @@ namespace gem5
 {
 
 class EventQueue;       // forward declaration
+class EventWheel;
+class EventManager;
 class BaseGlobalEvent;
 
+namespace host_profile
+{
+struct Slot;
+} // namespace host_profile
+
 //! Simulation Quantum for multiple eventq simulation.
 //! The quantum value is the period length after which the queues
 //! synchronize themselves with each other. This means that any
@@ -79,12 +87,39 @@ extern __thread EventQueue *_curEventQueue;
 //! Current mode of execution: parallel / serial
 extern bool inParallelMode;
 
+//! Deterministic parallel mode: within each simulation quantum the
+//! main event queues run one after the other in index order instead of
+//! concurrently, so that multi-eventq runs are reproducible. Meant for
+//! debugging parallel configurations, set from Root.deterministic_eventq.
+extern bool deterministicParallelMode;
+
+//! Give the turn back to the first main event queue (deterministic
+//! parallel mode only). Called when all queues are at a barrier.
+void resetEventQueueTurn();
+
+//! Block until it is the turn of the given main event queue to run
+//! (deterministic parallel mode only).
+void waitEventQueueTurn(EventQueue *eq);
+
+//! Hand the turn over to the next main event queue if the given queue
+//! currently holds it (deterministic parallel mode only).
+void passEventQueueTurn(EventQueue *eq);
+
+//! Keep the events of the main event queues in a timing wheel (see
+//! EventWheel) instead of the sorted bin list, set from
+//! Root.eventq_backend. Both give the same event order.
+extern bool eventQueueWheel;
+
 //! Function for returning eventq queue for the provided
 //! index. The function allocates a new queue in case one
 //! does not exist for the index, provided that the index
 //! is with in bounds.
 EventQueue *getEventQueue(uint32_t index);
 
+//! Index of a main event queue in mainEventQueue, panics for other
+//! queues.
+uint32_t mainEventQueueIndex(EventQueue *eq);
+
 inline EventQueue *curEventQueue() { return _curEventQueue; }
 inline void curEventQueue(EventQueue *q);
 
@@ -251,6 +286,7 @@ class EventBase
 class Event : public EventBase, public Serializable
 {
     friend class EventQueue;
+    friend class EventWheel;
 
   private:
     // The event queue is now a linked list of linked lists.  The
@@ -268,6 +304,10 @@ class Event : public EventBase, public Serializable
     static Event *insertBefore(Event *event, Event *curr);
     static Event *removeItem(Event *event, Event *last);
 
+    //! Insert / remove an event in the bin list starting at head.
+    static void insertInList(Event *&head, Event *event);
+    static void removeFromList(Event *&head, Event *event);
+
     Tick _when;         //!< timestamp when event should be processed
     Priority _priority; //!< event priority
     Flags flags;
@@ -442,6 +482,13 @@ class Event : public EventBase, public Serializable
     void dump() const;
     /** @}*/ //end of api group
 
+#if USE_HOST_PROFILING
+    /** Object the host time of the event is charged to, see host_profile. */
+    EventManager *profileOwner = nullptr;
+    /** Counters the event was last charged to. */
+    host_profile::Slot *profileSlot = nullptr;
+#endif
+
   public:
     /*
      * This member function is invoked when the event is processed
@@ -628,6 +675,10 @@ class EventQueue
     Event *head;
     Tick _curTick;
 
+    //! Holds the events instead of the bin list starting at head if
+    //! set, head is then a copy of the head of the wheel.
+    EventWheel *wheel;
+
     //! Mutex to protect async queue.
     UncontendedMutex async_queue_mutex;
 
@@ -666,6 +717,9 @@ class EventQueue
     //! owning thread, should call this function instead of insert().
     void asyncInsert(Event *event);
 
+    //! Tops of all bins in order, for debugging.
+    std::vector<Event *> bins() const;
+
     EventQueue(const EventQueue &);
 
   public:
@@ -939,6 +993,14 @@ class EventQueue
      */
     Event* replaceHead(Event* s);
 
+    /**
+     * Move the events to a timing wheel (see EventWheel) or back to the
+     * bin list. The wheel makes inserting events far from the head cheap
+     * when many distinct ticks are pending, the order of the events is
+     * the same either way.
+     */
+    void setWheel(bool enable);
+
     /**@{*/
     /**
      * Provide an interface for locking/unlocking the event queue.
@@ -968,11 +1030,7 @@ class EventQueue
      */
     void checkpointReschedule(Event *event);
 
-    virtual ~EventQueue()
-    {
-        while (!empty())
-            deschedule(getHead());
-    }
+    virtual ~EventQueue();
 };
 
 inline void
@@ -1018,6 +1076,7 @@ class EventManager
     void
     schedule(Event &event, Tick when)
     {
+        setProfileOwner(&event);
         eventq->schedule(&event, when);
     }
 
@@ -1036,6 +1095,7 @@ class EventManager
     void
     reschedule(Event &event, Tick when, bool always = false)
     {
+        setProfileOwner(&event);
         eventq->reschedule(&event, when, always);
     }
 
@@ -1045,6 +1105,7 @@ class EventManager
     void
     schedule(Event *event, Tick when)
     {
+        setProfileOwner(event);
         eventq->schedule(event, when);
     }
 
@@ -1063,6 +1124,7 @@ class EventManager
     void
     reschedule(Event *event, Tick when, bool always = false)
     {
+        setProfileOwner(event);
         eventq->reschedule(event, when, always);
     }
 
@@ -1078,6 +1140,15 @@ class EventManager
     }
 
     void setCurTick(Tick newVal) { eventq->setCurTick(newVal); }
+
+  private:
+    void
+    setProfileOwner(Event *event)
+    {
+#if USE_HOST_PROFILING
+        event->profileOwner = this;
+#endif
+    }
 };
 
 template <class T, void (T::* F)()>
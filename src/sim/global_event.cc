@@ -136,7 +136,7 @@ GlobalEvent::BarrierEvent::process()
 
     // second barrier to force all queues to wait for event processing
     // to finish before continuing
-    globalBarrier();
+    waitTurn(globalBarrier());
 }
 
 
@@ -150,8 +150,9 @@ GlobalSyncEvent::BarrierEvent::process()
 
     // second barrier to force all queues to wait for event processing
     // to finish before continuing
-    globalBarrier();
+    const bool last_arrived = globalBarrier();
     curEventQueue()->handleAsyncInsertions();
+    waitTurn(last_arrived);
 }
 
 void
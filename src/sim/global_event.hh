@@ -101,9 +101,26 @@ class BaseGlobalEvent : public EventBase
             // while waiting on the barrier to prevent deadlocks if
             // another thread wants to lock the event queue.
             EventQueue::ScopedRelease release(curEventQueue());
+            passEventQueueTurn(curEventQueue());
             return _globalEvent->barrier.wait();
         }
 
+        /**
+         * Called after the second barrier. In deterministic parallel
+         * mode, wait until the queues with a lower index have run up to
+         * the next global event. Exit events return to the simulate()
+         * loop instead, which waits for the turn when restarting.
+         */
+        void waitTurn(bool last_arrived)
+        {
+            if (last_arrived)
+                resetEventQueueTurn();
+            if (!isExitEvent()) {
+                EventQueue::ScopedRelease release(curEventQueue());
+                waitEventQueueTurn(curEventQueue());
+            }
+        }
+
       public:
         virtual BaseGlobalEvent *globalEvent() { return _globalEvent; }
     };
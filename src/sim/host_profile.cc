@@ -0,0 +1,346 @@
+#include "sim/host_profile.hh"
+
+#if USE_HOST_PROFILING
+
+#include <cxxabi.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <tuple>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/statistics.hh"
+#include "base/str.hh"
+#include "sim/core.hh"
+#include "sim/eventq.hh"
+#include "sim/root.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+namespace host_profile
+{
+
+bool enabled = false;
+thread_local uint64_t allocations = 0;
+
+struct ThreadSlots;
+
+struct Slot
+{
+    const ThreadSlots *thread;
+    const EventManager *owner;
+    const std::type_info *type;
+    std::string label;
+
+    uint64_t cycles = 0;
+    uint64_t events = 0;
+    uint64_t allocs = 0;
+};
+
+/** Counters of the events processed by one thread. */
+struct ThreadSlots
+{
+    std::deque<Slot> slots;
+    std::map<std::tuple<const EventManager *, std::type_index, std::string>,
+             Slot *> byKey;
+    /** Slots of the events deleted after use, which are not named. */
+    std::map<std::pair<const EventManager *, std::type_index>, Slot *>
+        byType;
+};
+
+namespace
+{
+
+thread_local ThreadSlots *threadSlots = nullptr;
+
+std::mutex threadsMutex;
+std::vector<std::unique_ptr<ThreadSlots>> threads;
+
+std::string foldedFile;
+double nsPerCycle = 1.0;
+
+/** Index of the SimObjects in the stats, the last one is for the rest. */
+std::unordered_map<const EventManager *, size_t> objectIndex;
+
+std::string
+demangle(const std::type_info &type)
+{
+    int status;
+    char *name = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+    std::string demangled = status == 0 ? name : type.name();
+    std::free(name);
+    if (startswith(demangled, "gem5::"))
+        demangled = demangled.substr(6);
+    return demangled;
+}
+
+/**
+ * The SimObjects, found by their EventManager. Filled in by
+ * Stats::regStats() before the first event is processed, and only read by
+ * the event queue threads afterwards.
+ */
+std::unordered_map<const EventManager *, const SimObject *> objects;
+
+std::string
+ownerName(const EventManager *owner)
+{
+    // EventManager is not polymorphic, so look the owner up among the
+    // SimObjects rather than casting it.
+    auto it = objects.find(owner);
+    return it == objects.end() ? "unattributed" : it->second->name();
+}
+
+/** Name the counters of an event after the event, or its type. */
+std::string
+label(Event *event, const std::string &owner)
+{
+    std::string name = event->name();
+    for (const char *suffix : {".wrapped_function_event", ".wrapped_event"}) {
+        const size_t len = std::strlen(suffix);
+        if (name.size() > len &&
+            name.compare(name.size() - len, len, suffix) == 0) {
+            name.resize(name.size() - len);
+        }
+    }
+    if (startswith(name, owner + "."))
+        name = name.substr(owner.size() + 1);
+    if (name.empty() || name == owner || startswith(name, "Event_"))
+        return demangle(typeid(*event));
+    return name;
+}
+
+void
+calibrate()
+{
+    // Time the time stamp counter against the steady clock.
+    auto wall_start = std::chrono::steady_clock::now();
+    uint64_t start = now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t cycles = now() - start;
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - wall_start).count();
+    nsPerCycle = cycles ? double(ns) / cycles : 1.0;
+}
+
+void
+writeFolded()
+{
+    std::map<std::string, uint64_t> stacks;
+    {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (const auto &thread : threads) {
+            for (const auto &slot : thread->slots) {
+                std::string stack = ownerName(slot.owner);
+                for (auto &c : stack) {
+                    if (c == '.')
+                        c = ';';
+                }
+                std::string label = slot.label;
+                for (auto &c : label) {
+                    if (c == ';' || c == ' ')
+                        c = '_';
+                }
+                stacks[stack + ";" + label] += slot.cycles * nsPerCycle;
+            }
+        }
+    }
+
+    OutputStream *os = simout.create(foldedFile);
+    for (const auto &stack : stacks) {
+        if (stack.second)
+            *os->stream() << stack.first << " " << stack.second << "\n";
+    }
+    simout.close(os);
+}
+
+class Stats : public statistics::Group
+{
+  public:
+    Stats(Root *root)
+        : statistics::Group(root, "hostProfile"),
+          ADD_STAT(hostSeconds, statistics::units::Second::get(),
+                   "Host time spent in the events of each object"),
+          ADD_STAT(events, statistics::units::Count::get(),
+                   "Events processed for each object"),
+          ADD_STAT(allocations, statistics::units::Count::get(),
+                   "Host memory allocations in the events of each object")
+    {}
+
+    void
+    regStats() override
+    {
+        statistics::Group::regStats();
+
+        const auto &list = SimObject::getSimObjectList();
+        const size_t size = list.size() + 1;
+        for (size_t i = 0; i < list.size(); i++) {
+            objectIndex[list[i]] = i;
+            objects[list[i]] = list[i];
+        }
+
+        for (auto *vec : {&hostSeconds, &events, &allocations}) {
+            vec->init(size).flags(statistics::nozero);
+            for (size_t i = 0; i < list.size(); i++)
+                vec->subname(i, list[i]->name());
+            vec->subname(list.size(), "unattributed");
+        }
+        base.resize(size);
+    }
+
+    void
+    resetStats() override
+    {
+        statistics::Group::resetStats();
+        base = totals();
+    }
+
+    void
+    preDumpStats() override
+    {
+        statistics::Group::preDumpStats();
+        const auto now = totals();
+        for (size_t i = 0; i < now.size(); i++) {
+            hostSeconds[i] = (now[i].cycles - base[i].cycles) *
+                nsPerCycle * 1e-9;
+            events[i] = now[i].events - base[i].events;
+            allocations[i] = now[i].allocs - base[i].allocs;
+        }
+    }
+
+  private:
+    struct Totals
+    {
+        uint64_t cycles = 0;
+        uint64_t events = 0;
+        uint64_t allocs = 0;
+    };
+
+    std::vector<Totals>
+    totals() const
+    {
+        std::vector<Totals> sums(base.size());
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        for (const auto &thread : threads) {
+            for (const auto &slot : thread->slots) {
+                auto it = objectIndex.find(slot.owner);
+                auto &sum = sums[it == objectIndex.end() ?
+                                 sums.size() - 1 : it->second];
+                sum.cycles += slot.cycles;
+                sum.events += slot.events;
+                sum.allocs += slot.allocs;
+            }
+        }
+        return sums;
+    }
+
+    statistics::Vector hostSeconds;
+    statistics::Vector events;
+    statistics::Vector allocations;
+
+    std::vector<Totals> base;
+};
+
+Stats *stats = nullptr;
+
+} // anonymous namespace
+
+void
+enable(const std::string &folded_file)
+{
+    foldedFile = folded_file;
+    calibrate();
+    enabled = true;
+    registerExitCallback(writeFolded);
+}
+
+void
+addStats(Root *root)
+{
+    if (enabled)
+        stats = new Stats(root);
+}
+
+Slot *
+lookup(Event *event)
+{
+    if (GEM5_UNLIKELY(!threadSlots)) {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        threads.emplace_back(new ThreadSlots);
+        threadSlots = threads.back().get();
+    }
+
+    const EventManager *owner = event->profileOwner;
+    const std::type_info &type = typeid(*event);
+
+    Slot *slot = event->profileSlot;
+    if (slot && slot->thread == threadSlots && slot->owner == owner &&
+        *slot->type == type) {
+        return slot;
+    }
+
+    Slot **found;
+    std::string name;
+    if (event->isAutoDelete()) {
+        // Events deleted after use are created all the time, and naming
+        // them each time would cost more than the events themselves.
+        found = &threadSlots->byType[{owner, std::type_index(type)}];
+        if (!*found)
+            name = demangle(type);
+    } else {
+        name = label(event, ownerName(owner));
+        found = &threadSlots->byKey[{owner, std::type_index(type), name}];
+    }
+
+    if (!*found) {
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        threadSlots->slots.push_back({threadSlots, owner, &type, name});
+        *found = &threadSlots->slots.back();
+    }
+    event->profileSlot = *found;
+    return *found;
+}
+
+void
+charge(Slot *slot, uint64_t cycles, uint64_t allocs)
+{
+    slot->cycles += cycles;
+    slot->events++;
+    slot->allocs += allocs;
+}
+
+} // namespace host_profile
+} // namespace gem5
+
+// Count the allocations of each thread, freeing is left to the default
+// operator delete, which calls free().
+void *
+operator new(std::size_t size)
+{
+    gem5::host_profile::allocations++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *
+operator new[](std::size_t size)
+{
+    gem5::host_profile::allocations++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+#endif // USE_HOST_PROFILING
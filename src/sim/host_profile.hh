@@ -0,0 +1,101 @@
+#ifndef __SIM_HOST_PROFILE_HH__
+#define __SIM_HOST_PROFILE_HH__
+
+#include "config/use_host_profiling.hh"
+
+#if USE_HOST_PROFILING
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace gem5
+{
+
+class Event;
+class Root;
+
+/**
+ * Host time profile of the simulation, built with USE_HOST_PROFILING=1 and
+ * turned on with enable().
+ *
+ * EventQueue::serviceOne() measures the host time and the number of
+ * allocations of every event it processes. They are charged to the object
+ * that last scheduled the event through its EventManager interface, which
+ * is the owning SimObject for nearly all events, and to the event itself.
+ * Totals per SimObject are in the hostProfile stats of the root, totals per
+ * SimObject and event go to a folded stack file, the input of
+ * flamegraph.pl, at exit.
+ */
+namespace host_profile
+{
+
+extern bool enabled;
+
+/** Calls of operator new by this thread. */
+extern thread_local uint64_t allocations;
+
+/** Host time stamp, in cycles of the time stamp counter if there is one. */
+inline uint64_t
+now()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * Start profiling, writing the folded stacks to folded_file in the output
+ * directory at exit.
+ */
+void enable(const std::string &folded_file);
+
+/** Add the hostProfile stats to the root, if profiling is on. */
+void addStats(Root *root);
+
+/** Counters of one SimObject and event, see host_profile.cc. */
+struct Slot;
+
+/** Find the counters an event is charged to. */
+Slot *lookup(Event *event);
+
+void charge(Slot *slot, uint64_t cycles, uint64_t allocs);
+
+/** Charges the processing of an event for as long as it lives. */
+class Scope
+{
+  public:
+    Scope(Event *event)
+        : slot(enabled ? lookup(event) : nullptr)
+    {
+        if (slot) {
+            allocs = allocations;
+            start = now();
+        }
+    }
+
+    ~Scope()
+    {
+        if (slot)
+            charge(slot, now() - start, allocations - allocs);
+    }
+
+  private:
+    Slot *slot;
+    uint64_t start = 0;
+    uint64_t allocs = 0;
+};
+
+} // namespace host_profile
+} // namespace gem5
+
+#endif // USE_HOST_PROFILING
+
+#endif // __SIM_HOST_PROFILE_HH__
@@ -55,6 +55,7 @@
 
 #include "base/atomicio.hh"
 #include "base/cprintf.hh"
+#include "base/flight_recorder.hh"
 #include "base/logging.hh"
 #include "sim/async.hh"
 #include "sim/backtrace.hh"
@@ -154,6 +155,10 @@ abortHandler(int sigtype)
     }
 
     print_backtrace();
+
+    if (Trace::FlightRecorder::enabled())
+        Trace::FlightRecorder::dump("abort");
+
     raiseFatalSignal(sigtype);
 }
 
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base/barrier.hh"
+#include "sim/eventq.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+constexpr uint32_t NumQueues = 4;
+
+/**
+ * The turns of the main event queues in deterministic parallel mode. The
+ * turn is global state, so every test starts from the first queue.
+ */
+class ParallelEventQueueTest : public testing::Test
+{
+  protected:
+    std::vector<EventQueue *> queues;
+
+    void
+    SetUp() override
+    {
+        for (uint32_t i = 0; i < NumQueues; i++)
+            queues.push_back(getEventQueue(i));
+        inParallelMode = true;
+        deterministicParallelMode = true;
+        resetEventQueueTurn();
+    }
+
+    void
+    TearDown() override
+    {
+        inParallelMode = false;
+        deterministicParallelMode = false;
+    }
+};
+
+} // anonymous namespace
+
+/** The turn goes from one queue to the next, and back to the first. */
+TEST_F(ParallelEventQueueTest, PassTurn)
+{
+    for (uint32_t i = 0; i < NumQueues; i++) {
+        // Only the queue holding the turn can pass it on.
+        passEventQueueTurn(queues[(i + 1) % NumQueues]);
+        waitEventQueueTurn(queues[i]);
+        passEventQueueTurn(queues[i]);
+    }
+    resetEventQueueTurn();
+    waitEventQueueTurn(queues[0]);
+}
+
+/**
+ * Threads started in reverse order run their quanta in queue order, with
+ * the last one at the barrier giving the turn back like the global
+ * events do.
+ */
+TEST_F(ParallelEventQueueTest, QuantaInQueueOrder)
+{
+    constexpr int Quanta = 50;
+    Barrier barrier(NumQueues);
+    std::vector<uint32_t> log;
+
+    auto run = [&](uint32_t index) {
+        EventQueue *eq = queues[index];
+        for (int quantum = 0; quantum < Quanta; quantum++) {
+            waitEventQueueTurn(eq);
+            log.push_back(index);
+            passEventQueueTurn(eq);
+            if (barrier.wait())
+                resetEventQueueTurn();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = NumQueues; i-- > 0;)
+        threads.emplace_back(run, i);
+    for (auto &thread : threads)
+        thread.join();
+
+    ASSERT_EQ(log.size(), NumQueues * Quanta);
+    for (size_t i = 0; i < log.size(); i++)
+        EXPECT_EQ(log[i], i % NumQueues) << "at " << i;
+}
+
+/** Without deterministic mode the queues never wait for each other. */
+TEST_F(ParallelEventQueueTest, NotDeterministic)
+{
+    deterministicParallelMode = false;
+    waitEventQueueTurn(queues[NumQueues - 1]);
+
+    deterministicParallelMode = true;
+    inParallelMode = false;
+    waitEventQueueTurn(queues[NumQueues - 1]);
+}
+
+/** Only the main event queues take turns. */
+TEST_F(ParallelEventQueueTest, NotMainQueue)
+{
+    EventQueue eq("other");
+    ASSERT_ANY_THROW(waitEventQueueTurn(&eq));
+}
@@ -47,6 +47,7 @@
 #include "sim/cur_tick.hh"
 #include "sim/eventq.hh"
 #include "sim/full_system.hh"
+#include "sim/host_profile.hh"
 #include "sim/root.hh"
 
 namespace gem5
@@ -187,12 +188,22 @@ Root::Root(const RootParams &p, int)
     lastTime.setTimer();
 
     simQuantum = p.sim_quantum;
+    deterministicParallelMode = p.deterministic_eventq;
+
+    // Queues created from now on pick the backend up in getEventQueue()
+    eventQueueWheel = p.eventq_backend == enums::timing_wheel;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setWheel(eventQueueWheel);
 
     // Some of the statistics are global and need to be accessed by
     // stat formulas. The most convenient way to implement that is by
     // having a single global stat group for global stats. Merge that
     // group into the root object here.
     mergeStatGroup(&Root::RootStats::instance);
+
+#if USE_HOST_PROFILING
+    host_profile::addStats(this);
+#endif
 }
 
 void
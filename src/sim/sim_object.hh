@@ -344,6 +344,13 @@ class SimObject : public EventManager, public Serializable, public Drainable,
      */
     static SimObject *find(const char *name);
 
+    /** All the instantiated SimObjects. */
+    static const std::vector<SimObject *> &
+    getSimObjectList()
+    {
+        return simObjectList;
+    }
+
     /**
      * There is a single object name resolver, and it is only set when
      * simulation is restoring from checkpoints.
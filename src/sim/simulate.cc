@@ -212,6 +212,7 @@ simulate(Tick num_cycles)
                                 EventBase::Progress_Event_Pri, 0));
 
         inParallelMode = true;
+        resetEventQueueTurn();
     }
 
     simulatorThreads->runUntilLocalExit();
@@ -271,6 +272,7 @@ doSimLoop(EventQueue *eventq)
     // set the per thread current eventq pointer
     curEventQueue(eventq);
     eventq->handleAsyncInsertions();
+    waitEventQueueTurn(eventq);
 
     while (1) {
         // there should always be at least one event (the SimLoopExitEvent
@@ -0,0 +1,176 @@
+#include "sim/trace_merger.hh"
+
+#include <algorithm>
+#include <chrono>
+
+#include "base/logging.hh"
+
+namespace gem5
+{
+
+namespace
+{
+
+std::atomic<uint64_t> nextMergerId(0);
+
+} // anonymous namespace
+
+TraceMerger::TraceMerger(Sink _sink, size_t ring_size)
+    : sink(std::move(_sink)), ringSize(ring_size), id(nextMergerId++)
+{
+    panic_if(ringSize == 0 || (ringSize & (ringSize - 1)),
+             "Trace merger ring size %d is not a power of 2\n", ringSize);
+}
+
+TraceMerger::~TraceMerger()
+{
+    if (running)
+        stop();
+    Ring *ring = rings.load();
+    while (ring) {
+        Ring *next = ring->next;
+        delete ring;
+        ring = next;
+    }
+}
+
+void
+TraceMerger::start()
+{
+    panic_if(running, "Trace merger started twice\n");
+    running = true;
+    writer = std::thread([this]() { writerMain(); });
+}
+
+void
+TraceMerger::stop()
+{
+    if (running) {
+        running = false;
+        writer.join();
+    }
+    merge(true);
+}
+
+TraceMerger::Ring &
+TraceMerger::threadRing()
+{
+    thread_local std::unordered_map<uint64_t, Ring *> thread_rings;
+    auto it = thread_rings.find(id);
+    if (it != thread_rings.end())
+        return *it->second;
+
+    Ring *ring = new Ring(ringSize);
+    ring->next = rings.load();
+    while (!rings.compare_exchange_weak(ring->next, ring)) {}
+    thread_rings[id] = ring;
+    return *ring;
+}
+
+std::atomic<uint64_t> &
+TraceMerger::queueSeq(Ring &ring, uint32_t queue)
+{
+    auto it = ring.queueSeqs.find(queue);
+    if (it != ring.queueSeqs.end())
+        return *it->second;
+
+    std::lock_guard<std::mutex> lock(queueSeqMutex);
+    auto &seq = queueSeqs.try_emplace(queue, 0).first->second;
+    ring.queueSeqs[queue] = &seq;
+    return seq;
+}
+
+void
+TraceMerger::push(Tick tick, uint32_t queue, std::string text)
+{
+    Ring &ring = threadRing();
+    const size_t tail = ring.tail.load(std::memory_order_relaxed);
+    if (tail - ring.head.load(std::memory_order_acquire) >= ringSize) {
+        _stalls++;
+        while (tail - ring.head.load(std::memory_order_acquire) >=
+                ringSize) {
+            if (!running) {
+                // Nobody to hand off to (not started or stopped), the
+                // producer is the only thread left and writes itself.
+                merge(true);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    Record &rec = ring.slots[tail & (ringSize - 1)];
+    rec.tick = tick;
+    rec.queue = queue;
+    rec.seq = queueSeq(ring, queue).fetch_add(1,
+                                              std::memory_order_relaxed);
+    rec.text = std::move(text);
+    ring.tail.store(tail + 1, std::memory_order_release);
+
+    // Migrated threads may push records of a queue that is behind
+    if (tick > ring.newest.load(std::memory_order_relaxed))
+        ring.newest.store(tick, std::memory_order_release);
+}
+
+bool
+TraceMerger::merge(bool everything)
+{
+    std::lock_guard<std::mutex> lock(mergeMutex);
+
+    // Read the newest ticks before draining: any record older than the
+    // watermark was pushed before the producer that is furthest ahead
+    // passed the last quantum barrier, so it is visible now.
+    Tick newest = 0;
+    for (Ring *ring = rings.load(); ring; ring = ring->next)
+        newest = std::max(newest,
+                          ring->newest.load(std::memory_order_acquire));
+    const Tick lookahead = _lookahead;
+    const Tick watermark = newest > lookahead ? newest - lookahead : 0;
+
+    auto by_tick = [](const Record &a, const Record &b) {
+        if (a.tick != b.tick)
+            return a.tick < b.tick;
+        if (a.queue != b.queue)
+            return a.queue < b.queue;
+        return a.seq < b.seq;
+    };
+
+    // Pending is kept sorted, only the newly drained records are sorted
+    // and merged into it.
+    const size_t num_sorted = pending.size();
+    for (Ring *ring = rings.load(); ring; ring = ring->next) {
+        size_t head = ring->head.load(std::memory_order_relaxed);
+        const size_t tail = ring->tail.load(std::memory_order_acquire);
+        for (; head != tail; head++) {
+            pending.push_back(
+                std::move(ring->slots[head & (ringSize - 1)]));
+        }
+        ring->head.store(head, std::memory_order_release);
+    }
+    std::sort(pending.begin() + num_sorted, pending.end(), by_tick);
+    std::inplace_merge(pending.begin(), pending.begin() + num_sorted,
+                       pending.end(), by_tick);
+
+    auto end = everything ? pending.end() :
+        std::lower_bound(pending.begin(), pending.end(), watermark,
+            [](const Record &rec, Tick tick) { return rec.tick < tick; });
+    if (end == pending.begin())
+        return false;
+
+    std::vector<Record> batch(std::make_move_iterator(pending.begin()),
+                              std::make_move_iterator(end));
+    pending.erase(pending.begin(), end);
+    sink(batch);
+    return true;
+}
+
+void
+TraceMerger::writerMain()
+{
+    while (running) {
+        if (!merge(false))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace gem5
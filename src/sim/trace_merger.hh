@@ -0,0 +1,141 @@
+#ifndef __SIM_TRACE_MERGER_HH__
+#define __SIM_TRACE_MERGER_HH__
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * Collects trace records (e.g. SQL statements) produced by several
+ * simulation threads and hands them to a single writer in a deterministic
+ * order.
+ *
+ * Every producer thread owns a single-producer/single-consumer ring, so
+ * push() takes no lock. A writer thread drains the rings, sorts the
+ * records by (tick, queue, sequence number) and passes every record whose
+ * tick is final to the sink. A tick is final when it is more than the
+ * lookahead behind the newest tick any producer has pushed: with parallel
+ * event queues the queues never drift apart by more than the simulation
+ * quantum, so no record older than that can still arrive.
+ *
+ * The sequence number counts the records of a queue, not of a thread: a
+ * thread that migrates to another queue pushes records of that queue to
+ * its own ring, and they must still come out in the order the queue
+ * produced them.
+ */
+class TraceMerger
+{
+  public:
+    struct Record
+    {
+        Tick tick;
+        uint32_t queue;
+        /** Position of the record amongst those of its queue. */
+        uint64_t seq;
+        std::string text;
+    };
+
+    /** Receives records in merged order, always from one thread. */
+    using Sink = std::function<void(std::vector<Record> &)>;
+
+    /** @param ring_size Records buffered per producer, a power of 2. */
+    TraceMerger(Sink sink, size_t ring_size = 4096);
+    ~TraceMerger();
+
+    /** Start the writer thread. */
+    void start();
+
+    /** Stop the writer thread and write all remaining records. */
+    void stop();
+
+    bool isRunning() const { return running; }
+
+    /** Maximum distance between the ticks of concurrent producers. */
+    void setLookahead(Tick lookahead) { _lookahead = lookahead; }
+
+    /**
+     * Queue a record from the calling thread. Blocks only if the ring of
+     * the thread is full and the writer has not caught up yet.
+     */
+    void push(Tick tick, uint32_t queue, std::string text);
+
+    /** Number of times a producer waited for the writer. */
+    uint64_t stalls() const { return _stalls; }
+
+  private:
+    struct Ring
+    {
+        Ring(size_t size) : slots(size) {}
+
+        std::vector<Record> slots;
+        /** Next slot to read, written by the writer only. */
+        std::atomic<size_t> head{0};
+        /** Next slot to fill, written by the producer only. */
+        std::atomic<size_t> tail{0};
+        /** Newest tick pushed to this ring. */
+        std::atomic<Tick> newest{0};
+        /** Sequence counters of the queues pushed to, producer only. */
+        std::unordered_map<uint32_t, std::atomic<uint64_t> *> queueSeqs;
+        Ring *next = nullptr;
+    };
+
+    /** Ring of the calling thread, registered on first use. */
+    Ring &threadRing();
+
+    /**
+     * Sequence counter of a queue, created on first use. Only one thread
+     * runs a queue at a time, and a migration to it synchronizes with
+     * the thread that ran it before, so a queue's records are counted in
+     * the order they are produced.
+     */
+    std::atomic<uint64_t> &queueSeq(Ring &ring, uint32_t queue);
+
+    /**
+     * Move the records of all rings to pending and pass the final ones
+     * to the sink; all records if everything is set. Called by the
+     * writer, by stop(), and by producers that find the ring full while
+     * the writer is not running, serialized by mergeMutex.
+     * @return Whether any record was written.
+     */
+    bool merge(bool everything);
+
+    void writerMain();
+
+    Sink sink;
+    const size_t ringSize;
+    /** Distinguishes mergers in the per-thread ring lookup. */
+    const uint64_t id;
+
+    /** Registered rings, a list that only grows. */
+    std::atomic<Ring *> rings{nullptr};
+
+    std::atomic<Tick> _lookahead{0};
+    std::atomic<uint64_t> _stalls{0};
+
+    /** Sequence counters of all queues, nodes are never moved. */
+    std::unordered_map<uint32_t, std::atomic<uint64_t>> queueSeqs;
+    std::mutex queueSeqMutex;
+
+    /** Serializes merge(), and so the sink and the ring heads. */
+    std::mutex mergeMutex;
+
+    /** Drained but not yet final records, under mergeMutex. */
+    std::vector<Record> pending;
+
+    std::thread writer;
+    std::atomic<bool> running{false};
+};
+
+} // namespace gem5
+
+#endif // __SIM_TRACE_MERGER_HH__
@@ -0,0 +1,202 @@
+#include <gtest/gtest.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "sim/trace_merger.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+struct Collector
+{
+    std::mutex mutex;
+    std::vector<TraceMerger::Record> records;
+
+    TraceMerger::Sink
+    sink()
+    {
+        return [this](std::vector<TraceMerger::Record> &batch) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (auto &rec : batch)
+                records.push_back(std::move(rec));
+        };
+    }
+};
+
+bool
+ordered(const TraceMerger::Record &a, const TraceMerger::Record &b)
+{
+    if (a.tick != b.tick)
+        return a.tick < b.tick;
+    if (a.queue != b.queue)
+        return a.queue < b.queue;
+    return a.seq < b.seq;
+}
+
+} // anonymous namespace
+
+/** Records of one producer come out sorted by tick, then push order. */
+TEST(TraceMergerTest, SingleProducer)
+{
+    Collector out;
+    TraceMerger merger(out.sink(), 8);
+    merger.start();
+    merger.push(20, 0, "c");
+    merger.push(10, 0, "a");
+    merger.push(20, 0, "d");
+    merger.push(10, 0, "b");
+    merger.stop();
+
+    ASSERT_EQ(out.records.size(), 4);
+    EXPECT_EQ(out.records[0].text, "a");
+    EXPECT_EQ(out.records[1].text, "b");
+    EXPECT_EQ(out.records[2].text, "c");
+    EXPECT_EQ(out.records[3].text, "d");
+}
+
+/** Records with the same tick are ordered by queue id. */
+TEST(TraceMergerTest, QueueOrder)
+{
+    Collector out;
+    TraceMerger merger(out.sink());
+    merger.push(5, 2, "q2");
+    merger.push(5, 0, "q0");
+    merger.push(5, 1, "q1");
+    merger.stop();
+
+    ASSERT_EQ(out.records.size(), 3);
+    EXPECT_EQ(out.records[0].text, "q0");
+    EXPECT_EQ(out.records[1].text, "q1");
+    EXPECT_EQ(out.records[2].text, "q2");
+}
+
+/** Records newer than the watermark are held back until stop(). */
+TEST(TraceMergerTest, Watermark)
+{
+    Collector out;
+    TraceMerger merger(out.sink());
+    merger.setLookahead(100);
+    merger.start();
+    merger.push(10, 0, "old");
+    merger.push(150, 0, "new");
+    while (true) {
+        std::lock_guard<std::mutex> lock(out.mutex);
+        if (!out.records.empty())
+            break;
+    }
+    {
+        std::lock_guard<std::mutex> lock(out.mutex);
+        ASSERT_EQ(out.records.size(), 1);
+        EXPECT_EQ(out.records[0].text, "old");
+    }
+    merger.stop();
+    ASSERT_EQ(out.records.size(), 2);
+    EXPECT_EQ(out.records[1].text, "new");
+}
+
+/**
+ * Several producers overflowing their rings: nothing is lost and the
+ * output is in (tick, queue, seq) order.
+ */
+TEST(TraceMergerTest, MultipleProducers)
+{
+    const int num_threads = 4;
+    const int num_records = 5000;
+
+    Collector out;
+    TraceMerger merger(out.sink(), 16);
+    // Free running threads drift apart arbitrarily, a lookahead covering
+    // the whole run makes the order independent of the scheduling.
+    merger.setLookahead(MaxTick);
+    merger.start();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&merger, t, num_records]() {
+            for (int i = 0; i < num_records; i++)
+                merger.push(i / 3, t, std::to_string(t));
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+    merger.stop();
+
+    ASSERT_EQ(out.records.size(), num_threads * num_records);
+    for (size_t i = 1; i < out.records.size(); i++)
+        ASSERT_TRUE(ordered(out.records[i - 1], out.records[i]));
+    for (const auto &rec : out.records)
+        ASSERT_EQ(rec.text, std::to_string(rec.queue));
+}
+
+/**
+ * Records of one queue and tick pushed by several threads, one after the
+ * other as with a thread migrating to the queue, keep the push order.
+ */
+TEST(TraceMergerTest, MigratedProducers)
+{
+    Collector out;
+    TraceMerger merger(out.sink());
+    merger.push(5, 0, "a");
+
+    // Other threads take over queue 0 in turn, each with its own ring
+    std::thread([&merger]() {
+        merger.push(5, 0, "b");
+        merger.push(5, 1, "q1");
+    }).join();
+    merger.push(5, 0, "c");
+    std::thread([&merger]() { merger.push(5, 0, "d"); }).join();
+    merger.stop();
+
+    ASSERT_EQ(out.records.size(), 5);
+    EXPECT_EQ(out.records[0].text, "a");
+    EXPECT_EQ(out.records[1].text, "b");
+    EXPECT_EQ(out.records[2].text, "c");
+    EXPECT_EQ(out.records[3].text, "d");
+    EXPECT_EQ(out.records[4].text, "q1");
+}
+
+/** The writer can be stopped and started again, e.g. around a fork. */
+TEST(TraceMergerTest, Restart)
+{
+    Collector out;
+    TraceMerger merger(out.sink(), 8);
+    merger.start();
+    merger.push(10, 0, "a");
+    merger.stop();
+    EXPECT_FALSE(merger.isRunning());
+    ASSERT_EQ(out.records.size(), 1);
+
+    merger.start();
+    EXPECT_TRUE(merger.isRunning());
+    merger.push(20, 0, "b");
+    merger.push(30, 0, "c");
+    merger.stop();
+
+    ASSERT_EQ(out.records.size(), 3);
+    EXPECT_EQ(out.records[1].text, "b");
+    EXPECT_EQ(out.records[2].text, "c");
+}
+
+/** Producers of a stopped merger write their records themselves. */
+TEST(TraceMergerTest, StoppedProducers)
+{
+    Collector out;
+    TraceMerger merger(out.sink(), 4);
+    std::vector<std::thread> producers;
+    for (uint32_t q = 0; q < 4; q++) {
+        producers.emplace_back([&merger, q]() {
+            for (Tick t = 0; t < 1000; t++)
+                merger.push(t, q, "x");
+        });
+    }
+    for (auto &t : producers)
+        t.join();
+    merger.stop();
+
+    ASSERT_EQ(out.records.size(), 4000);
+}
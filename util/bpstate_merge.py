@@ -0,0 +1,228 @@
+#!/usr/bin/env python3
+
+# Merge branch predictor state files written by DecoupledBPUWithFTB
+# (bpStateDumpFile or checkpoints) from neighbouring SimPoint intervals into
+# one state file that can be restored with bpStateRestoreFile.
+#
+# The first input is the primary one: its histories, RAS stacks and other
+# opaque sections are kept as they are. Counter tables are averaged with the
+# given weights, and table entries are taken from the primary input if they
+# are valid there, or from the first other input in which they are valid.
+# Set associative tables (the uFTB and FTB, which also store a "ways"
+# section) are merged set by set, so that a tag is never valid in two ways
+# of a set.
+#
+# Usage:
+#   bpstate_merge.py -o merged.bpstate slice12.bpstate slice11.bpstate
+#   bpstate_merge.py -o merged.bpstate -w 3 1 a.bpstate b.bpstate
+#   bpstate_merge.py --list a.bpstate
+
+import argparse
+import gzip
+import struct
+import sys
+
+MAGIC = b"XSBPSTAT"
+VERSION = 1
+
+RAW, COUNTERS, ENTRIES, HISTORY = range(4)
+KIND_NAMES = ["raw", "counters", "entries", "history"]
+INT_FORMATS = {1: "b", 2: "h", 4: "i", 8: "q"}
+
+# DefaultFTB::saveState entries start with valid, slot count and tid bytes,
+# followed by the tag the entry is looked up by.
+FTB_TAG = struct.Struct("<Q")
+FTB_TAG_OFFSET = 3
+
+
+class Section:
+    def __init__(self, kind, elem_size, num_elems, data):
+        self.kind = kind
+        self.elem_size = elem_size
+        self.num_elems = num_elems
+        self.data = data
+
+    def geometry(self):
+        return (self.kind, self.elem_size, self.num_elems)
+
+
+def read_state(path):
+    with gzip.open(path, "rb") as f:
+        buf = f.read()
+    if buf[:8] != MAGIC:
+        sys.exit(f"{path}: not a predictor state file")
+    version, num_sections = struct.unpack_from("<II", buf, 8)
+    if version != VERSION:
+        sys.exit(f"{path}: version {version}, expected {VERSION}")
+    pos = 16
+    sections = {}
+    for _ in range(num_sections):
+        (name_len,) = struct.unpack_from("<H", buf, pos)
+        pos += 2
+        name = buf[pos : pos + name_len].decode()
+        pos += name_len
+        kind, elem_size, num_elems = struct.unpack_from("<BIQ", buf, pos)
+        pos += 13
+        size = (num_elems + 7) // 8 if kind == HISTORY else elem_size * num_elems
+        sections[name] = Section(
+            kind, elem_size, num_elems, bytearray(buf[pos : pos + size])
+        )
+        pos += size
+    return sections
+
+
+def write_state(path, sections):
+    with gzip.open(path, "wb") as f:
+        f.write(MAGIC)
+        f.write(struct.pack("<II", VERSION, len(sections)))
+        for name, sec in sections.items():
+            f.write(struct.pack("<H", len(name)))
+            f.write(name.encode())
+            f.write(struct.pack("<BIQ", sec.kind, sec.elem_size, sec.num_elems))
+            f.write(sec.data)
+
+
+def merge_counters(secs, weights):
+    fmt = "<%d%s" % (secs[0].num_elems, INT_FORMATS[secs[0].elem_size])
+    values = [struct.unpack(fmt, s.data) for s in secs]
+    total = sum(weights)
+    merged = [
+        int(round(sum(w * v[i] for w, v in zip(weights, values)) / total))
+        for i in range(secs[0].num_elems)
+    ]
+    return bytearray(struct.pack(fmt, *merged))
+
+
+def merge_entries(secs):
+    size = secs[0].elem_size
+    merged = bytearray(secs[0].data)
+    for i in range(secs[0].num_elems):
+        off = i * size
+        if merged[off]:
+            continue
+        for s in secs[1:]:
+            if s.data[off]:
+                merged[off : off + size] = s.data[off : off + size]
+                break
+    return merged
+
+
+def merge_set_entries(secs, ways):
+    size = secs[0].elem_size
+    merged = bytearray(secs[0].data)
+
+    def valid(data, i):
+        return data[i * size]
+
+    def tag(data, i):
+        return FTB_TAG.unpack_from(data, i * size + FTB_TAG_OFFSET)[0]
+
+    for first in range(0, secs[0].num_elems, ways):
+        set_ways = range(first, first + ways)
+        tags = {tag(merged, i) for i in set_ways if valid(merged, i)}
+        free = [i for i in set_ways if not valid(merged, i)]
+        for s in secs[1:]:
+            for i in set_ways:
+                if not free:
+                    break
+                if valid(s.data, i) and tag(s.data, i) not in tags:
+                    dst = free.pop(0)
+                    merged[dst * size : (dst + 1) * size] = s.data[
+                        i * size : (i + 1) * size
+                    ]
+                    tags.add(tag(s.data, i))
+    return merged
+
+
+def table_ways(states, name):
+    """Ways of a set associative table section, None if it has no sets."""
+    ways_name = name.rsplit(".", 1)[0] + ".ways"
+    values = {
+        struct.unpack("<I", s[ways_name].data)[0]
+        for s in states
+        if name in s and ways_name in s
+    }
+    if len(values) > 1:
+        sys.exit(f"section {ways_name}: inputs differ, {sorted(values)}")
+    return values.pop() if values else None
+
+
+def merge(states, weights):
+    merged = {}
+    names = []
+    for state in states:
+        names += [n for n in state if n not in names]
+    for name in names:
+        present = [(s[name], w) for s, w in zip(states, weights) if name in s]
+        secs = [p[0] for p in present]
+        ws = [p[1] for p in present]
+        first = secs[0]
+        for s in secs[1:]:
+            if s.geometry() != first.geometry():
+                sys.exit(
+                    f"section {name}: geometry {s.geometry()} differs "
+                    f"from {first.geometry()}, predictor configs differ"
+                )
+        if first.kind == COUNTERS:
+            data = merge_counters(secs, ws)
+        elif first.kind == ENTRIES:
+            ways = table_ways(states, name)
+            if ways:
+                data = merge_set_entries(secs, ways)
+            else:
+                data = merge_entries(secs)
+        else:
+            data = bytearray(first.data)
+        merged[name] = Section(first.kind, first.elem_size, first.num_elems, data)
+    return merged
+
+
+def list_state(path):
+    for name, sec in read_state(path).items():
+        desc = f"{sec.num_elems} x {sec.elem_size}B"
+        if sec.kind == ENTRIES:
+            valid = sum(
+                1
+                for i in range(sec.num_elems)
+                if sec.data[i * sec.elem_size]
+            )
+            desc += f", {valid} valid"
+        print(f"{name:24s} {KIND_NAMES[sec.kind]:9s} {desc}")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Merge or inspect branch predictor state files"
+    )
+    parser.add_argument("inputs", nargs="+", help="state files, primary first")
+    parser.add_argument("-o", "--output", help="merged state file")
+    parser.add_argument(
+        "-w",
+        "--weights",
+        type=float,
+        nargs="+",
+        help="counter averaging weight of each input (default: equal)",
+    )
+    parser.add_argument(
+        "--list", action="store_true", help="print the sections of the inputs"
+    )
+    args = parser.parse_args()
+
+    if args.list:
+        for path in args.inputs:
+            print(f"{path}:")
+            list_state(path)
+        return
+
+    if not args.output:
+        parser.error("an output file is required to merge")
+    weights = args.weights or [1.0] * len(args.inputs)
+    if len(weights) != len(args.inputs):
+        parser.error("one weight is required per input")
+
+    states = [read_state(p) for p in args.inputs]
+    write_state(args.output, merge(states, weights))
+
+
+if __name__ == "__main__":
+    main()
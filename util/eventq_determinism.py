@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+
+# Check that the event queue backends (Root.eventq_backend) simulate the
+# same thing: run a gem5 command once per backend and diff the resulting
+# stats.txt files, ignoring the host_* stats that depend on the machine.
+#
+# The config script must accept --eventq-backend, as
+# configs/example/xiangshan.py does.
+#
+# Usage:
+#   eventq_determinism.py [-d outdir] -- build/RISCV/gem5.opt \
+#       configs/example/xiangshan.py --generic-rv-cpt=... -I 1000000
+
+import argparse
+import difflib
+import os
+import subprocess
+import sys
+
+BACKENDS = ["bin_list", "timing_wheel"]
+
+
+def read_stats(path):
+    lines = []
+    with open(path) as f:
+        for line in f:
+            name = line.split(maxsplit=1)[0] if line.strip() else ""
+            if name.startswith("host_") or ".host_" in name:
+                continue
+            lines.append(line)
+    return lines
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Diff stats.txt between the event queue backends")
+    parser.add_argument("-d", "--outdir", default="eventq_determinism",
+                        help="directory for the output of the runs")
+    parser.add_argument("cmd", nargs=argparse.REMAINDER,
+                        help="gem5 binary, config script and its options")
+    args = parser.parse_args()
+    cmd = args.cmd[1:] if args.cmd[:1] == ["--"] else args.cmd
+    if len(cmd) < 2:
+        parser.error("expected a gem5 binary and a config script")
+
+    stats = []
+    for backend in BACKENDS:
+        outdir = os.path.join(args.outdir, backend)
+        run = [cmd[0], "-d", outdir] + cmd[1:] + \
+            ["--eventq-backend=" + backend]
+        print("Running", " ".join(run))
+        os.makedirs(outdir, exist_ok=True)
+        with open(os.path.join(args.outdir, backend + ".log"), "w") as log:
+            subprocess.run(run, stdout=log, stderr=subprocess.STDOUT,
+                           check=True)
+        stats.append(read_stats(os.path.join(outdir, "stats.txt")))
+
+    diff = list(difflib.unified_diff(stats[0], stats[1],
+                                     BACKENDS[0], BACKENDS[1]))
+    if diff:
+        sys.stdout.writelines(diff)
+        print("FAIL: the stats of the backends differ")
+        return 1
+    print("OK: %d stats lines identical" % len(stats[0]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+
+# Compare a run of the analytical network (--network=analytical) with a
+# garnet run of the same workload and topology: print the error of the
+# analytical latency stats, and the queueing_scale that would make its
+# average network latency match garnet's.
+#
+# The queueing_scale of the analytical run is read from the config.ini
+# next to its stats.txt.
+#
+# Usage:
+#   noc_calibrate.py garnet/stats.txt analytical/stats.txt
+
+import argparse
+import os
+import sys
+
+STATS = [
+    "average_packet_latency",
+    "average_packet_network_latency",
+    "average_packet_queueing_latency",
+    "average_hops",
+    "packets_received::total",
+]
+
+
+def read_stats(path):
+    """Network stats of the last dump in a stats.txt, by name without the
+    network object."""
+    stats = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) < 2:
+                continue
+            name = fields[0]
+            for stat in STATS + ["average_packet_contention_latency"]:
+                if name.endswith(".network." + stat) or name == stat:
+                    try:
+                        stats[stat] = float(fields[1])
+                    except ValueError:
+                        pass
+            if name == "simTicks":
+                stats[name] = float(fields[1])
+    return stats
+
+
+def read_scale(stats_path):
+    config = os.path.join(os.path.dirname(stats_path), "config.ini")
+    if not os.path.exists(config):
+        return 1.0
+    with open(config) as f:
+        for line in f:
+            if line.startswith("queueing_scale="):
+                return float(line.split("=", 1)[1])
+    return 1.0
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Calibrate the analytical network against garnet")
+    parser.add_argument("garnet", help="stats.txt of the garnet run")
+    parser.add_argument("analytical", help="stats.txt of the analytical run")
+    args = parser.parse_args()
+
+    garnet = read_stats(args.garnet)
+    analytical = read_stats(args.analytical)
+    if "average_packet_latency" not in garnet:
+        sys.exit("%s has no garnet network stats" % args.garnet)
+    if "average_packet_contention_latency" not in analytical:
+        sys.exit("%s has no analytical network stats" % args.analytical)
+
+    print("%-36s %14s %14s %9s" % ("stat", "garnet", "analytical", "error"))
+    for stat in STATS + ["simTicks"]:
+        if stat not in garnet or stat not in analytical:
+            continue
+        g = garnet[stat]
+        a = analytical[stat]
+        error = "%8.2f%%" % ((a - g) / g * 100) if g else "-"
+        print("%-36s %14.2f %14.2f %9s" % (stat, g, a, error))
+
+    # The contention is proportional to queueing_scale, the rest of the
+    # network latency does not depend on it.
+    scale = read_scale(args.analytical)
+    contention = analytical["average_packet_contention_latency"]
+    zero_load = analytical["average_packet_network_latency"] - contention
+    target = garnet["average_packet_network_latency"] - zero_load
+    print()
+    if contention <= 0:
+        print("The analytical run saw no link contention, "
+              "queueing_scale cannot be fitted")
+    elif target <= 0:
+        print("Garnet is below the zero-load latency of the model "
+              "(%.2f), check the router and link latencies" % zero_load)
+    else:
+        print("queueing_scale: %g -> %g" %
+              (scale, scale * target / contention))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+
+# Read the binary pipeline trace of the O3 cpu (see src/cpu/o3/pipe_trace.hh)
+# and convert it to the O3PipeView text read by util/o3-pipeview.py or to the
+# Konata pipeline viewer format.
+#
+# Usage:
+#   o3-pipetrace.py m5out/cpu0.pipe.gz --pipeview trace.out
+#   o3-pipeview.py trace.out -o pipeview.out
+#   o3-pipetrace.py m5out/cpu0.pipe.gz --konata trace.kanata
+#   o3-pipetrace.py m5out/cpu0.pipe.gz --summary
+
+import argparse
+import collections
+import gzip
+import struct
+import sys
+
+MAGIC = b"GEM5O3PT"
+VERSION = 1
+
+RECORD = struct.Struct("<QQQiiiiiiiIHBBBBbb")
+DISASM = struct.Struct("<QBH")
+
+COMMITTED = 0x1
+SQUASHED = 0x2
+LOAD = 0x4
+STORE = 0x8
+CONTROL = 0x10
+MISPREDICTED = 0x20
+
+SQUASH_REASONS = ["none", "branch", "memorder", "trap", "tc",
+                  "squashafter", "decode", "other"]
+
+STAGES = [("fetch", "F"), ("decode", "Dc"), ("rename", "Rn"),
+          ("dispatch", "Ds"), ("issue", "Is"), ("complete", "Cm"),
+          ("retire", "Rt")]
+
+Inst = collections.namedtuple("Inst", [
+    "sn", "pc", "fetch", "decode", "rename", "dispatch", "issue",
+    "complete", "retire", "store", "mem_latency", "op_class", "upc", "tid",
+    "flags", "squash_reason", "iq", "port", "disasm"])
+
+
+def _open(path):
+    with open(path, "rb") as f:
+        gzipped = f.read(2) == b"\x1f\x8b"
+    return gzip.open(path, "rb") if gzipped else open(path, "rb")
+
+
+def read_trace(path):
+    """Yield the instructions of a trace in the order they were written."""
+    disasms = {}
+    with _open(path) as f:
+        if f.read(len(MAGIC)) != MAGIC:
+            sys.exit("%s is not an O3 pipeline trace" % path)
+        version, = struct.unpack("<I", f.read(4))
+        if version != VERSION:
+            sys.exit("%s: unsupported version %d" % (path, version))
+
+        while True:
+            kind = f.read(1)
+            if not kind:
+                break
+            if kind == b"D":
+                pc, upc, size = DISASM.unpack(f.read(DISASM.size))
+                disasms[(pc, upc)] = f.read(size).decode(errors="replace")
+            elif kind == b"I":
+                fields = list(RECORD.unpack(f.read(RECORD.size)))
+                fetch = fields[2]
+                # Stage ticks are stored relative to fetch.
+                for i in range(3, 10):
+                    fields[i] = -1 if fields[i] == -1 else fetch + fields[i]
+                disasm = disasms.get((fields[1], fields[12]), "")
+                yield Inst(*fields, disasm)
+            else:
+                sys.exit("%s: corrupt record" % path)
+
+
+def write_pipeview(insts, out):
+    def tick(t):
+        return 0 if t == -1 else t
+
+    for inst in insts:
+        out.write("O3PipeView:fetch:%d:0x%08x:%d:%d:%s\n" %
+                  (inst.fetch, inst.pc, inst.upc, inst.sn, inst.disasm))
+        for stage in ("decode", "rename", "dispatch", "issue", "complete"):
+            out.write("O3PipeView:%s:%d\n" %
+                      (stage, tick(getattr(inst, stage))))
+        out.write("O3PipeView:retire:%d:store:%d\n" %
+                  (tick(inst.retire), tick(inst.store)))
+
+
+def write_konata(insts, out, cycle_time):
+    events = []
+    for kid, inst in enumerate(insts):
+        stages = [(getattr(inst, name), label) for name, label in STAGES
+                  if getattr(inst, name) != -1]
+        end = max(t for t, _ in stages)
+        if inst.store != -1:
+            end = max(end, inst.store)
+
+        label = "%x: %s" % (inst.pc, inst.disasm)
+        detail = "sn:%d op:%d" % (inst.sn, inst.op_class)
+        if inst.iq != -1:
+            detail += " iq:%d port:%d" % (inst.iq, inst.port)
+        if inst.mem_latency:
+            detail += " mem:%d" % inst.mem_latency
+        if inst.flags & MISPREDICTED:
+            detail += " mispredicted"
+        if inst.flags & SQUASHED:
+            detail += " squash:%s" % SQUASH_REASONS[inst.squash_reason]
+
+        start = stages[0][0]
+        events.append((start, 0, kid, "I\t%d\t%d\t%d" % (kid, inst.sn,
+                                                        inst.tid)))
+        events.append((start, 1, kid, "L\t%d\t0\t%s" % (kid, label)))
+        events.append((start, 1, kid, "L\t%d\t1\t%s" % (kid, detail)))
+        for i, (t, name) in enumerate(stages):
+            if i:
+                events.append((t, 2, kid, "E\t%d\t0\t%s" %
+                               (kid, stages[i - 1][1])))
+            events.append((t, 3, kid, "S\t%d\t0\t%s" % (kid, name)))
+        events.append((end + cycle_time, 2, kid, "E\t%d\t0\t%s" %
+                       (kid, stages[-1][1])))
+        retired = 0 if inst.flags & COMMITTED else 1
+        events.append((end + cycle_time, 4, kid, "R\t%d\t%d\t%d" %
+                       (kid, kid, retired)))
+
+    events.sort()
+    out.write("Kanata\t0004\n")
+    cycle = None
+    for t, _, _, line in events:
+        now = t // cycle_time
+        if cycle is None:
+            out.write("C=\t%d\n" % now)
+        elif now != cycle:
+            out.write("C\t%d\n" % (now - cycle))
+        cycle = now
+        out.write(line + "\n")
+
+
+def write_summary(insts, out):
+    total = committed = mispredicted = 0
+    squashes = collections.Counter()
+    for inst in insts:
+        total += 1
+        if inst.flags & COMMITTED:
+            committed += 1
+        if inst.flags & MISPREDICTED:
+            mispredicted += 1
+        if inst.flags & SQUASHED:
+            squashes[SQUASH_REASONS[inst.squash_reason]] += 1
+    out.write("instructions %d\ncommitted %d\nmispredicted %d\n" %
+              (total, committed, mispredicted))
+    for reason, count in sorted(squashes.items()):
+        out.write("squashed.%s %d\n" % (reason, count))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert a binary O3 pipeline trace")
+    parser.add_argument("trace", help="trace written by the O3 cpu")
+    parser.add_argument("--pipeview", metavar="FILE",
+                        help="write O3PipeView text for o3-pipeview.py")
+    parser.add_argument("--konata", metavar="FILE",
+                        help="write a Konata log")
+    parser.add_argument("--cycle-time", type=int, default=333,
+                        help="cpu cycle in ticks for Konata (default: 333)")
+    parser.add_argument("--committed-only", action="store_true",
+                        help="leave squashed instructions out")
+    parser.add_argument("--summary", action="store_true",
+                        help="print instruction and squash counts")
+    args = parser.parse_args()
+
+    if not (args.pipeview or args.konata or args.summary):
+        parser.error("nothing to do, pick --pipeview, --konata or --summary")
+
+    insts = [inst for inst in read_trace(args.trace)
+             if not args.committed_only or inst.flags & COMMITTED]
+
+    if args.pipeview:
+        with open(args.pipeview, "w") as out:
+            write_pipeview(insts, out)
+    if args.konata:
+        with open(args.konata, "w") as out:
+            write_konata(insts, out, args.cycle_time)
+    if args.summary:
+        write_summary(insts, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
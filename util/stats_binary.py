@@ -0,0 +1,526 @@
+#!/usr/bin/env python3
+
+# Read the binary stats written by the binary:// stats output (see
+# src/base/stats/binary.hh) and convert them to the stats.txt format or
+# to a CSV time series of some stats.
+#
+# Usage:
+#   stats_binary.py m5out/stats.bin --text stats.txt [--no-desc]
+#   stats_binary.py m5out/stats.bin --csv ipc.csv \
+#       --stat 'system.cpu*.ipc' --stat simInsts
+#
+# The reader can also be used as a module:
+#   for dump in StatsReader("m5out/stats.bin"):
+#       print(dump.tick, dump.lines())
+
+import argparse
+import fnmatch
+import math
+import struct
+import sys
+
+MAGIC = b"GEM5STB1"
+VERSION = 1
+
+# Stat kinds, as in Binary::Kind
+SCALAR, VECTOR, DIST, VECTOR_DIST, VECTOR_2D, FORMULA, SPARSE_HIST = range(7)
+
+# Flags, as in base/stats/types.hh
+TOTAL = 0x0010
+PDF = 0x0020
+CDF = 0x0040
+NOZERO = 0x0100
+NONAN = 0x0200
+ONELINE = 0x0400
+
+# DistType
+DEVIATION, DISTRIBUTION, HISTOGRAM = range(3)
+
+# Doubles written before the buckets of a distribution
+DIST_FIELDS = 11
+
+NAN = float("nan")
+
+
+class Stat:
+    """Description of a stat from a schema record."""
+
+    def __init__(self, kind, name, desc, unit, separator, flags, precision,
+                 num_values):
+        self.kind = kind
+        self.name = name
+        self.desc = desc
+        self.unit = unit
+        self.separator = separator
+        self.flags = flags
+        self.precision = precision
+        self.num_values = num_values
+        self.subnames = []
+        self.subdescs = []
+        self.y_subnames = []
+        self.x = self.y = 0
+        self.dist_types = []
+        self.buckets = []
+
+
+class _Payload:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def take(self, fmt):
+        values = struct.unpack_from("<" + fmt, self.data, self.pos)
+        self.pos += struct.calcsize("<" + fmt)
+        return values
+
+    def u8(self):
+        return self.take("B")[0]
+
+    def u32(self):
+        return self.take("I")[0]
+
+    def u64(self):
+        return self.take("Q")[0]
+
+    def string(self):
+        size = self.u32()
+        value = self.data[self.pos:self.pos + size].decode()
+        self.pos += size
+        return value
+
+    def strings(self):
+        return [self.string() for _ in range(self.u32())]
+
+    def bytes(self, size):
+        value = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return value
+
+
+def _parse_schema(payload):
+    stats = []
+    for _ in range(payload.u32()):
+        kind = payload.u8()
+        name = payload.string()
+        desc = payload.string()
+        unit = payload.string()
+        separator = payload.string()
+        flags = payload.u32()
+        precision = payload.take("i")[0]
+        stat = Stat(kind, name, desc, unit, separator, flags, precision,
+                    payload.u64())
+        if kind in (VECTOR, FORMULA):
+            stat.subnames = payload.strings()
+            stat.subdescs = payload.strings()
+        elif kind == DIST:
+            stat.dist_types = [payload.u8()]
+            stat.buckets = [stat.num_values - DIST_FIELDS]
+        elif kind == VECTOR_DIST:
+            stat.subnames = payload.strings()
+            stat.subdescs = payload.strings()
+            for _ in range(payload.u32()):
+                stat.dist_types.append(payload.u8())
+                stat.buckets.append(payload.u64())
+        elif kind == VECTOR_2D:
+            stat.x = payload.u64()
+            stat.y = payload.u64()
+            stat.subnames = payload.strings()
+            stat.subdescs = payload.strings()
+            stat.y_subnames = payload.strings()
+        stats.append(stat)
+    return stats
+
+
+class Dump:
+    """Values of all stats at one stats dump."""
+
+    def __init__(self, tick, stats, visible, values, sparse):
+        self.tick = tick
+        self.stats = stats
+        self.visible = visible
+        self.values = values
+        self.sparse = sparse
+
+    def text(self, desc=True, spaces=True):
+        """This dump as it would have been written to stats.txt."""
+        printer = _TextPrinter(desc, spaces)
+        printer.out.append(
+            "\n---------- Begin Simulation Statistics ----------\n")
+        pos = 0
+        for i, stat in enumerate(self.stats):
+            values = self.values[pos:pos + stat.num_values]
+            pos += stat.num_values
+            if self.visible[i]:
+                printer.stat(stat, values, self.sparse.get(i))
+        printer.out.append(
+            "\n---------- End Simulation Statistics   ----------\n")
+        return "".join(printer.out)
+
+    def lines(self):
+        """(name, value) of every line this dump has in stats.txt."""
+        result = []
+        for line in self.text(desc=False, spaces=False).splitlines():
+            fields = line.split()
+            if len(fields) >= 2 and not line.startswith("-"):
+                result.append((fields[0], fields[1]))
+        return result
+
+
+class StatsReader:
+    """Iterate over the dumps of a binary stats file."""
+
+    def __init__(self, path):
+        self.path = path
+
+    def _records(self, f):
+        header = struct.Struct("<BBQQ")
+        while True:
+            raw = f.read(header.size)
+            if len(raw) < header.size:
+                return
+            kind, compressed, size, stored = header.unpack(raw)
+            data = f.read(stored)
+            if len(data) < stored:
+                # Truncated by a run that was killed during a dump
+                return
+            if compressed:
+                try:
+                    import zstandard
+                except ImportError:
+                    sys.exit("The stats are compressed, install the "
+                             "zstandard Python package to read them")
+                data = zstandard.ZstdDecompressor().decompress(
+                    data, max_output_size=size)
+            yield chr(kind), _Payload(data)
+
+    def __iter__(self):
+        with open(self.path, "rb") as f:
+            if f.read(len(MAGIC)) != MAGIC:
+                sys.exit("%s is not a binary stats file" % self.path)
+            version = struct.unpack("<I", f.read(4))[0]
+            if version != VERSION:
+                sys.exit("Unsupported binary stats version %d" % version)
+
+            stats = []
+            values = []
+            for kind, payload in self._records(f):
+                if kind == "S":
+                    stats = _parse_schema(payload)
+                    values = []
+                    continue
+
+                tick = payload.u64()
+                bitmap = payload.bytes((len(stats) + 7) // 8)
+                visible = [bool(bitmap[i // 8] >> (i % 8) & 1)
+                           for i in range(len(stats))]
+                num_values = sum(stat.num_values for stat in stats)
+                if payload.u8():
+                    changed = payload.bytes((num_values + 7) // 8)
+                    values = list(values)
+                    for i in range(num_values):
+                        if changed[i // 8] >> (i % 8) & 1:
+                            values[i] = payload.take("d")[0]
+                else:
+                    values = list(payload.take("%dd" % num_values))
+
+                sparse = {}
+                for i, stat in enumerate(stats):
+                    if stat.kind == SPARSE_HIST:
+                        samples = payload.take("d")[0]
+                        count = payload.u64()
+                        pairs = payload.take("%dd" % (2 * count))
+                        sparse[i] = (samples,
+                                     list(zip(pairs[0::2], pairs[1::2])))
+                yield Dump(tick, stats, visible, values, sparse)
+
+
+def _div(a, b):
+    """IEEE division, as done by the C++ text output."""
+    if b:
+        return a / b
+    if a == 0 or math.isnan(a):
+        return NAN
+    return math.copysign(math.inf, a) * math.copysign(1, b)
+
+
+def _value_str(value, precision):
+    if math.isnan(value):
+        return "nan"
+    if precision == -1:
+        precision = 0 if math.isinf(value) or value == round(value) else 6
+    return "%.*f" % (precision, value)
+
+
+def _number_str(value):
+    """A double written to a C++ stream with the default format."""
+    return "%g" % value
+
+
+class _TextPrinter:
+    """Port of the printers of src/base/stats/text.cc."""
+
+    def __init__(self, desc, spaces):
+        self.descriptions = desc
+        self.units = desc
+        self.spaces = spaces
+        self.name_spaces = 40 if spaces else 0
+        self.out = []
+
+    def _trailer(self, desc, unit):
+        if self.descriptions and desc:
+            self.out.append(" # %s" % desc)
+        if self.units and unit:
+            self.out.append(" (%s)" % unit)
+        self.out.append("\n")
+
+    def scalar(self, name, value, flags, precision, desc, unit,
+               pdf=NAN, cdf=NAN, oneline=False):
+        if ((flags & NOZERO and not oneline and value == 0.0) or
+                (flags & NONAN and math.isnan(value))):
+            return
+
+        pdfstr = "" if math.isnan(pdf) else "%.2f%%" % (pdf * 100.0)
+        cdfstr = "" if math.isnan(cdf) else "%.2f%%" % (cdf * 100.0)
+        value_spaces = 12 if self.spaces else 0
+        pdf_spaces = 10 if self.spaces else 0
+
+        if oneline:
+            self.out.append(" |")
+        else:
+            self.out.append("%-*s " % (self.name_spaces, name))
+        self.out.append("%*s" % (value_spaces,
+                                 _value_str(value, precision)))
+        if self.spaces or pdfstr:
+            self.out.append(" %*s" % (pdf_spaces, pdfstr))
+        if self.spaces or cdfstr:
+            self.out.append(" %*s" % (pdf_spaces, cdfstr))
+        if not oneline:
+            self._trailer(desc, unit)
+
+    def vector(self, name, stat, flags, desc, vec, total, subnames=(),
+               subdescs=(), force_subnames=False):
+        size = len(vec)
+        vec_total = sum(vec) if flags & (PDF | CDF) else 0.0
+        base = name + stat.separator
+        pdf = cdf = 0.0 if vec_total else NAN
+        havesub = bool(subnames)
+
+        if size == 1:
+            if force_subnames:
+                name = base + (subnames[0] if havesub else "0")
+            self.scalar(name, vec[0], flags, stat.precision, desc,
+                        stat.unit, pdf, cdf)
+            return
+
+        oneline = bool(flags & ONELINE)
+        if not flags & NOZERO or total != 0:
+            if oneline:
+                self.out.append("%-*s" % (self.name_spaces, name))
+                flags &= ~NOZERO
+
+            for i in range(size):
+                if havesub and (i >= len(subnames) or not subnames[i]):
+                    continue
+                if vec_total:
+                    pdf = vec[i] / vec_total
+                    cdf += pdf
+                self.scalar(base + (subnames[i] if havesub else str(i)),
+                            vec[i], flags, stat.precision,
+                            subdescs[i] if subdescs else desc, stat.unit,
+                            pdf, cdf, oneline)
+
+            if oneline:
+                self._trailer(desc, stat.unit)
+
+        if flags & TOTAL:
+            self.scalar(base + "total", total, flags, stat.precision, desc,
+                        stat.unit)
+
+    def dist(self, name, stat, desc, dist_type, values):
+        (low_bucket, high_bucket, bucket_size, samples, total_sum, squares,
+         logs, underflow, overflow, min_val, max_val) = values[:DIST_FIELDS]
+        cvec = values[DIST_FIELDS:]
+        flags = stat.flags
+        if flags & NOZERO and samples == 0:
+            return
+        base = name + stat.separator
+        oneline = bool(flags & ONELINE)
+
+        def put(suffix, value, pdf=NAN, cdf=NAN):
+            self.scalar(base + suffix, value, flags, stat.precision, desc,
+                        stat.unit, pdf, cdf)
+
+        if oneline:
+            put("bucket_size", bucket_size)
+            put("min_bucket", low_bucket)
+            put("max_bucket", high_bucket)
+
+        put("samples", samples)
+        put("mean", total_sum / samples if samples else NAN)
+        if dist_type == HISTOGRAM:
+            gmean = NAN
+            if samples:
+                try:
+                    gmean = math.exp(logs / samples)
+                except OverflowError:
+                    gmean = math.inf
+            put("gmean", gmean)
+
+        stdev = NAN
+        if samples:
+            var = _div(samples * squares - total_sum * total_sum,
+                       samples * (samples - 1.0))
+            stdev = math.sqrt(var) if var >= 0 else NAN
+        put("stdev", stdev)
+
+        if dist_type == DEVIATION:
+            return
+
+        total = sum(cvec)
+        if dist_type == DISTRIBUTION:
+            total += underflow + overflow
+        pdf = cdf = 0.0 if total else NAN
+
+        def update(value):
+            nonlocal pdf, cdf
+            if total:
+                pdf = value / total
+                cdf += pdf
+            return pdf, cdf
+
+        if dist_type == DISTRIBUTION:
+            put("underflows", underflow, *update(underflow))
+
+        if oneline:
+            self.out.append("%-*s" % (self.name_spaces, name))
+
+        for i, count in enumerate(cvec):
+            low = i * bucket_size + low_bucket
+            high = min(low + bucket_size - 1.0, high_bucket)
+            bucket = _number_str(low)
+            if low < high:
+                bucket += "-" + _number_str(high)
+            self.scalar(base + bucket, count, flags, stat.precision, desc,
+                        stat.unit, *update(count), oneline)
+
+        if oneline:
+            self._trailer(desc, stat.unit)
+
+        if dist_type == DISTRIBUTION:
+            put("overflows", overflow, *update(overflow))
+            put("min_value", min_val)
+            put("max_value", max_val)
+        put("total", total)
+
+    def stat(self, stat, values, sparse):
+        if stat.kind == SCALAR:
+            self.scalar(stat.name, values[0], stat.flags, stat.precision,
+                        stat.desc, stat.unit)
+
+        elif stat.kind in (VECTOR, FORMULA):
+            size = len(values) - 1
+            subnames = []
+            subdescs = []
+            if any(stat.subnames[:size]):
+                subnames = (stat.subnames + [""] * size)[:size]
+                if any(n and d for n, d in
+                       zip(stat.subnames[:size], stat.subdescs)):
+                    subdescs = (stat.subdescs + [""] * size)[:size]
+            self.vector(stat.name, stat, stat.flags, stat.desc, values[:-1],
+                        values[-1], subnames, subdescs)
+
+        elif stat.kind == VECTOR_2D:
+            x, y = stat.x, stat.y
+            y_subnames = (stat.y_subnames
+                          if any(stat.y_subnames[:y]) else [])
+            havesub = any(stat.subnames[:x])
+            for i in range(x):
+                if havesub and (i >= len(stat.subnames) or
+                                not stat.subnames[i]):
+                    continue
+                row = values[i * y:(i + 1) * y]
+                name = "%s_%s" % (stat.name,
+                                  stat.subnames[i] if havesub else i)
+                self.vector(name, stat, stat.flags, stat.desc, row,
+                            sum(row), y_subnames, force_subnames=True)
+            if stat.flags & TOTAL and x > 1:
+                self.vector(stat.name, stat, stat.flags & ~TOTAL,
+                            stat.desc, [values[-1]], values[-1], ["total"],
+                            force_subnames=True)
+
+        elif stat.kind == DIST:
+            self.dist(stat.name, stat, stat.desc, stat.dist_types[0],
+                      values)
+
+        elif stat.kind == VECTOR_DIST:
+            pos = 0
+            for i, (dist_type, buckets) in enumerate(
+                    zip(stat.dist_types, stat.buckets)):
+                subname = (stat.subnames[i] if i < len(stat.subnames)
+                           else "")
+                subdesc = (stat.subdescs[i] if i < len(stat.subdescs)
+                           else "")
+                size = DIST_FIELDS + buckets
+                self.dist("%s_%s" % (stat.name, subname or i), stat,
+                          subdesc or stat.desc, dist_type,
+                          values[pos:pos + size])
+                pos += size
+
+        elif stat.kind == SPARSE_HIST:
+            samples, buckets = sparse
+            base = stat.name + stat.separator
+            self.scalar(base + "samples", samples, stat.flags,
+                        stat.precision, stat.desc, stat.unit)
+            for key, count in buckets:
+                self.scalar(base + _number_str(key), count, stat.flags,
+                            stat.precision, stat.desc, stat.unit)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert binary gem5 stats to text or CSV")
+    parser.add_argument("stats", help="binary stats file")
+    parser.add_argument("--text", metavar="FILE",
+                        help="write the dumps in the stats.txt format")
+    parser.add_argument("--no-desc", action="store_true",
+                        help="omit descriptions and units from --text")
+    parser.add_argument("--no-spaces", action="store_true",
+                        help="omit alignment spaces from --text")
+    parser.add_argument("--csv", metavar="FILE",
+                        help="write one row per dump with the --stat stats")
+    parser.add_argument("--stat", action="append", default=[],
+                        metavar="PATTERN",
+                        help="glob of the stats.txt names to put in --csv")
+    args = parser.parse_args()
+
+    if not args.text and not args.csv:
+        parser.error("nothing to do, pass --text and/or --csv")
+    if args.csv and not args.stat:
+        parser.error("--csv needs at least one --stat")
+
+    text = open(args.text, "w") if args.text else None
+    rows = []
+    columns = []
+    for dump in StatsReader(args.stats):
+        if text:
+            text.write(dump.text(not args.no_desc, not args.no_spaces))
+        if args.csv:
+            row = {name: value for name, value in dump.lines()
+                   if any(fnmatch.fnmatchcase(name, pattern)
+                          for pattern in args.stat)}
+            columns += [name for name in row if name not in columns]
+            rows.append((dump.tick, row))
+    if text:
+        text.close()
+
+    if args.csv:
+        with open(args.csv, "w") as f:
+            f.write(",".join(["tick"] + columns) + "\n")
+            for tick, row in rows:
+                f.write(",".join([str(tick)] +
+                                 [row.get(name, "") for name in columns]) +
+                        "\n")
+
+
+if __name__ == "__main__":
+    main()